@@ -1,10 +1,17 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include "unique_chars.h"
 
 
 /* Is Unique: Implement an algorithm to determine if a string has all unique characters. What if you
-cannot use additional data structures? */
+cannot use additional data structures?
+
+check_if_unique is the first answer, kept for comparison. main uses
+chars_unique from unique_chars.c:
+
+    gcc -O2 main.c unique_chars.c -o main
+    ./main abcdef */
 
 bool check_if_unique(char* s){
     for (int i = 0; i<strlen(s); i++){
@@ -19,13 +26,18 @@ bool check_if_unique(char* s){
 
 
 
+#ifndef UNIQUE_BENCH
 int main(int argc, char* argv[]){
 
+    if (argc < 2){
+        printf("Usage: %s string\n", argv[0]);
+        return 1;
+    }
     char *s = argv[1];
 
     printf("The input of: %s", s);
     
-    if(check_if_unique(s)){
+    if(chars_unique(s, strlen(s))){
         printf(", has all unique characters\n");
     }else {
         printf(", does Not have Unique characters\n");
@@ -35,4 +47,5 @@ int main(int argc, char* argv[]){
 
 
     
-}
\ No newline at end of file
+}
+#endif
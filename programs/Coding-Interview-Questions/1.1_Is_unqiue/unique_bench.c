@@ -0,0 +1,200 @@
+#define UNIQUE_BENCH
+#define _POSIX_C_SOURCE 199309L
+#include <stdlib.h>
+#include <time.h>
+#include <assert.h>
+#include "main.c"
+
+/* Checks chars_unique against check_if_unique, then measures throughput
+in GB/s of token bytes over a buffer of packed tokens, for several token
+lengths. Half the tokens have one repeated byte at a random position,
+the rest are unique (the slow case: no early exit).
+
+    gcc -O2 unique_bench.c unique_chars.c -o unique_bench
+    ./unique_bench */
+
+#define BUFFER_BYTES (32 * 1024 * 1024)
+#define ORIGINAL_BYTES (256 * 1024) // check_if_unique is O(n^3); give it less
+#define REPEATS 5
+
+typedef struct Tokens{
+    char *buffer;      // tokens back to back
+    char *terminated;  // the same tokens, each followed by '\0'
+    uint32_t *offsets; // count + 1 entries
+    size_t count;
+    size_t bytes;
+}Tokens;
+
+// distinct non-zero bytes in random order, then maybe one repeat
+static void make_token(char *out, int length){
+    unsigned char pool[255];
+    for (int i = 0; i < 255; i++){
+        pool[i] = (unsigned char)(i + 1);
+    }
+    for (int i = 0; i < length && i < 255; i++){
+        int j = i + rand() % (255 - i);
+        unsigned char swap = pool[i];
+        pool[i] = pool[j];
+        pool[j] = swap;
+        out[i] = (char)pool[i];
+    }
+    for (int i = 255; i < length; i++){
+        out[i] = (char)pool[rand() % 255];
+    }
+    if (length >= 2 && rand() % 2){
+        int from = rand() % length;
+        int to = rand() % length;
+        out[to == from ? (to + 1) % length : to] = out[from];
+    }
+}
+
+// min_length == max_length for a fixed length
+static Tokens make_tokens(int min_length, int max_length, size_t bytes){
+    Tokens tokens;
+    size_t max_count = bytes / min_length + 1;
+    tokens.buffer = malloc(bytes + max_length);
+    tokens.terminated = malloc(bytes + max_length + max_count);
+    tokens.offsets = malloc(sizeof(uint32_t) * (max_count + 1));
+    assert(tokens.buffer != NULL && tokens.terminated != NULL && tokens.offsets != NULL);
+
+    size_t used = 0;
+    size_t terminated_used = 0;
+    tokens.count = 0;
+    while (used < bytes){
+        int length = min_length + rand() % (max_length - min_length + 1);
+        tokens.offsets[tokens.count++] = used;
+        make_token(tokens.buffer + used, length);
+        memcpy(tokens.terminated + terminated_used, tokens.buffer + used, length);
+        terminated_used += length;
+        tokens.terminated[terminated_used++] = '\0';
+        used += length;
+    }
+    tokens.offsets[tokens.count] = used;
+    tokens.bytes = used;
+    return tokens;
+}
+
+static void free_tokens(Tokens *tokens){
+    free(tokens->buffer);
+    free(tokens->terminated);
+    free(tokens->offsets);
+}
+
+static double now_s(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void check(){
+    char token[400];
+    for (int round = 0; round < 20000; round++){
+        int length = rand() % 40;
+        if (round % 100 == 0){
+            length = 250 + rand() % 20; // around the pigeonhole limit
+        }
+        make_token(token, length);
+        token[length] = '\0';
+        bool expected = check_if_unique(token);
+        assert(chars_unique(token, length) == expected);
+        assert(chars_unique_bitmap(token, length) == expected);
+    }
+
+    // bytes the C string version cannot see: '\0' and 0x80..0xFF
+    assert(chars_unique("\0a\xff", 3));
+    assert(!chars_unique("a\0b\0", 4));
+    assert(!chars_unique("\xff\x01\xff", 3));
+
+    Tokens tokens = make_tokens(1, 24, 100000);
+    uint8_t *results = malloc(tokens.count);
+    assert(results != NULL);
+    chars_unique_batch(tokens.buffer, tokens.offsets, tokens.count, results);
+    for (size_t i = 0; i < tokens.count; i++){
+        size_t length = tokens.offsets[i + 1] - tokens.offsets[i];
+        assert(results[i] == chars_unique(tokens.buffer + tokens.offsets[i], length));
+    }
+    free(results);
+
+    uint32_t counts[256];
+    chars_histogram(tokens.buffer, tokens.bytes, counts);
+    size_t total = 0;
+    for (int c = 0; c < 256; c++){
+        total += counts[c];
+    }
+    assert(total == tokens.bytes && counts[0] == 0);
+    free_tokens(&tokens);
+}
+
+static volatile int sink;
+
+static void bench(const char *label, int min_length, int max_length){
+    Tokens tokens = make_tokens(min_length, max_length, BUFFER_BYTES);
+    uint8_t *results = malloc(tokens.count);
+    assert(results != NULL);
+    double gb = tokens.bytes / 1e9;
+    int unique = 0;
+
+    // the original, on the first ORIGINAL_BYTES worth of tokens
+    double start = now_s();
+    size_t original_bytes = 0;
+    const char *s = tokens.terminated;
+    for (size_t i = 0; i < tokens.count && original_bytes < ORIGINAL_BYTES; i++){
+        size_t length = tokens.offsets[i + 1] - tokens.offsets[i];
+        unique += check_if_unique((char *)s);
+        s += length + 1;
+        original_bytes += length;
+    }
+    double original = original_bytes / 1e9 / (now_s() - start);
+
+    start = now_s();
+    for (int r = 0; r < REPEATS; r++){
+        for (size_t i = 0; i < tokens.count; i++){
+            unique += chars_unique_bitmap(tokens.buffer + tokens.offsets[i], tokens.offsets[i + 1] - tokens.offsets[i]);
+        }
+    }
+    double bitmap = gb * REPEATS / (now_s() - start);
+
+    start = now_s();
+    for (int r = 0; r < REPEATS; r++){
+        for (size_t i = 0; i < tokens.count; i++){
+            unique += chars_unique(tokens.buffer + tokens.offsets[i], tokens.offsets[i + 1] - tokens.offsets[i]);
+        }
+    }
+    double single = gb * REPEATS / (now_s() - start);
+
+    start = now_s();
+    for (int r = 0; r < REPEATS; r++){
+        chars_unique_batch(tokens.buffer, tokens.offsets, tokens.count, results);
+        unique += results[0];
+    }
+    double batch = gb * REPEATS / (now_s() - start);
+
+    uint32_t counts[256];
+    start = now_s();
+    for (int r = 0; r < REPEATS; r++){
+        chars_histogram(tokens.buffer, tokens.bytes, counts);
+        unique += counts[1];
+    }
+    double histogram = gb * REPEATS / (now_s() - start);
+
+    sink = unique;
+    printf("%-10s %16.3f %10.3f %14.3f %10.3f %12.3f\n", label, original, bitmap, single, batch, histogram);
+    free(results);
+    free_tokens(&tokens);
+}
+
+int main(){
+    check();
+    printf("chars_unique agrees with check_if_unique.\n\n");
+
+    printf("GB/s of token bytes\n");
+    printf("%-10s %16s %10s %14s %10s %12s\n", "tokens", "check_if_unique", "bitmap", "chars_unique", "batch",
+           "histogram");
+    bench("1-24", 1, 24);
+    bench("8", 8, 8);
+    bench("16", 16, 16);
+    bench("64", 64, 64);
+    bench("200", 200, 200);
+    bench("1000", 1000, 1000);
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "unique_chars.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+// 16 bytes at s, without reading past a page boundary after the string.
+// Reading past the string inside the page is deliberate, so ASan is told
+// to skip it.
+__attribute__((no_sanitize_address))
+static __m128i load_short(const char *s, size_t length){
+    if (((uintptr_t)s & 4095) <= 4096 - 16){
+        return _mm_loadu_si128((const __m128i *)s); // bytes past length are masked off
+    }
+    char copy[16] = {0};
+    memcpy(copy, s, length);
+    return _mm_loadu_si128((const __m128i *)copy);
+}
+
+// Rotating by r compares position i with i + r (mod 16); r and 16 - r
+// give the same pairs, so r = 1..8 covers them all. valid masks out the
+// bytes past length on both sides of each compare.
+__attribute__((target("ssse3")))
+static bool unique_short_sse(const char *s, size_t length){
+    static const char lanes[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    __m128i items = load_short(s, length);
+    __m128i valid = _mm_cmplt_epi8(_mm_loadu_si128((const __m128i *)lanes), _mm_set1_epi8((char)length));
+    __m128i repeats = _mm_setzero_si128();
+
+#define COMPARE_ROTATED(r) \
+    repeats = _mm_or_si128(repeats, _mm_and_si128(_mm_and_si128(valid, _mm_alignr_epi8(valid, valid, r)), \
+                                                  _mm_cmpeq_epi8(items, _mm_alignr_epi8(items, items, r))))
+    COMPARE_ROTATED(1);
+    COMPARE_ROTATED(2);
+    COMPARE_ROTATED(3);
+    COMPARE_ROTATED(4);
+    COMPARE_ROTATED(5);
+    COMPARE_ROTATED(6);
+    COMPARE_ROTATED(7);
+    COMPARE_ROTATED(8);
+#undef COMPARE_ROTATED
+
+    return _mm_movemask_epi8(repeats) == 0;
+}
+
+bool chars_unique_bitmap(const char *s, size_t length){
+    uint64_t seen[4] = {0, 0, 0, 0};
+    for (size_t i = 0; i < length; i++){
+        unsigned char c = (unsigned char)s[i];
+        uint64_t bit = 1ULL << (c & 63);
+        if (seen[c >> 6] & bit){
+            return false;
+        }
+        seen[c >> 6] |= bit;
+    }
+    return true;
+}
+
+static bool has_ssse3(){
+    static int supported = -1;
+    int cached = __atomic_load_n(&supported, __ATOMIC_RELAXED);
+    if (cached < 0){
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("ssse3") ? 1 : 0;
+        __atomic_store_n(&supported, cached, __ATOMIC_RELAXED);
+    }
+    return cached;
+}
+
+bool chars_unique(const char *s, size_t length){
+    if (length > 256){
+        return false;
+    }
+    if (length <= 16 && has_ssse3()){
+        return unique_short_sse(s, length);
+    }
+    return chars_unique_bitmap(s, length);
+}
+
+void chars_histogram(const char *s, size_t length, uint32_t counts[256]){
+    uint32_t partial[4][256];
+    memset(partial, 0, sizeof(partial));
+
+    const unsigned char *bytes = (const unsigned char *)s;
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4){
+        partial[0][bytes[i]]++;
+        partial[1][bytes[i + 1]]++;
+        partial[2][bytes[i + 2]]++;
+        partial[3][bytes[i + 3]]++;
+    }
+    for (; i < length; i++){
+        partial[0][bytes[i]]++;
+    }
+    for (int c = 0; c < 256; c++){
+        counts[c] = partial[0][c] + partial[1][c] + partial[2][c] + partial[3][c];
+    }
+}
+
+void chars_unique_batch(const char *buffer, const uint32_t *offsets, size_t count, uint8_t *results){
+    bool sse = has_ssse3();
+    for (size_t i = 0; i < count; i++){
+        const char *s = buffer + offsets[i];
+        size_t length = offsets[i + 1] - offsets[i];
+        if (length > 256){
+            results[i] = 0;
+        }else if (length <= 16 && sse){
+            results[i] = unique_short_sse(s, length);
+        }else{
+            results[i] = chars_unique_bitmap(s, length);
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef UNIQUE_CHARS_H
+#define UNIQUE_CHARS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Duplicate-character checks for check_if_unique in main.c, without its
+O(n^2) loop or the strlen calls in its loop conditions. Strings are
+passed with their length and may contain any byte, including 0.
+
+- a string longer than 256 bytes always repeats a byte (pigeonhole)
+- up to 16 bytes: one SSE2 register compared with itself rotated by
+  1..8 bytes, which covers every pair of positions
+- otherwise: a 256-bit presence bitmap, one pass, stops at the first
+  repeat
+
+chars_histogram counts every byte of a long string with four separate
+count tables, so runs of one byte value do not stall on a store to the
+same counter. */
+
+//Prototypes
+bool chars_unique(const char *s, size_t length);
+// the bitmap pass on its own, for comparison
+bool chars_unique_bitmap(const char *s, size_t length);
+void chars_histogram(const char *s, size_t length, uint32_t counts[256]);
+// Strings packed back to back: string i is buffer[offsets[i]] up to
+// buffer[offsets[i + 1]], so offsets has count + 1 entries. results[i] is
+// 1 if string i has no repeated byte.
+void chars_unique_batch(const char *buffer, const uint32_t *offsets, size_t count, uint8_t *results);
+
+
+
+#endif
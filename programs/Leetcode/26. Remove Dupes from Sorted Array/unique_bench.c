@@ -0,0 +1,145 @@
+#define UNIQUE_BENCH
+#define _POSIX_C_SOURCE 199309L
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <assert.h>
+#include "../670. Maximum Swap/main2.c"
+#include "unique_sorted.h"
+
+/* Checks every unique_sorted kernel against removeDuplicates, then times
+them on sorted arrays where a given fraction of items repeat the one
+before, placed at random. One table fits in L2, one is far larger than
+the last level cache.
+
+    gcc -O2 -pthread unique_bench.c unique_sorted.c -o unique_bench
+    ./unique_bench */
+
+#define SMALL_ITEMS (16 * 1024)
+#define SMALL_REPEATS 2000
+#define LARGE_ITEMS (64 * 1024 * 1024)
+#define LARGE_REPEATS 3
+
+typedef int (*UniqueFunction)(int *nums, int count);
+
+static int threads = 1;
+
+static int parallel_kernel(int *nums, int count){
+    return unique_sorted_parallel(nums, count, threads);
+}
+
+static const char *names[] = {"removeDuplicates", "scalar", "avx2", "avx512", "parallel"};
+static UniqueFunction functions[] = {removeDuplicates, unique_sorted_scalar, unique_sorted_avx2,
+                                     unique_sorted_avx512, parallel_kernel};
+static bool available[5];
+#define FUNCTION_COUNT 5
+
+static void fill_sorted(int *nums, int count, int duplicate_percent){
+    int value = -1000;
+    for (int i = 0; i < count; i++){
+        if (i == 0 || rand() % 100 >= duplicate_percent){
+            value += 1 + rand() % 3;
+        }
+        nums[i] = value;
+    }
+}
+
+static void check_all(){
+    int *source = malloc(sizeof(int) * 300000);
+    int *expected = malloc(sizeof(int) * 300000);
+    int *actual = malloc(sizeof(int) * 300000);
+    assert(source != NULL && expected != NULL && actual != NULL);
+
+    int sizes[] = {0, 1, 2, 7, 8, 9, 15, 16, 17, 18, 31, 33, 100, 1000, 299999};
+    int percents[] = {0, 3, 50, 97, 100};
+    for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++){
+        for (int p = 0; p < 5; p++){
+            fill_sorted(source, sizes[s], percents[p]);
+            memcpy(expected, source, sizeof(int) * sizes[s]);
+            int expected_kept = removeDuplicates(expected, sizes[s]);
+            for (int f = 1; f < FUNCTION_COUNT; f++){
+                if (!available[f]){
+                    continue;
+                }
+                memcpy(actual, source, sizeof(int) * sizes[s]);
+                int kept = functions[f](actual, sizes[s]);
+                assert(kept == expected_kept);
+                assert(memcmp(actual, expected, sizeof(int) * kept) == 0);
+            }
+        }
+    }
+
+    // several chunks, with runs crossing the chunk boundaries
+    for (int p = 0; p < 5; p++){
+        fill_sorted(source, 299999, percents[p]);
+        memcpy(expected, source, sizeof(int) * 299999);
+        memcpy(actual, source, sizeof(int) * 299999);
+        int expected_kept = removeDuplicates(expected, 299999);
+        assert(unique_sorted_parallel(actual, 299999, 4) == expected_kept);
+        assert(memcmp(actual, expected, sizeof(int) * expected_kept) == 0);
+    }
+
+    free(source);
+    free(expected);
+    free(actual);
+}
+
+static double now_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile int sink;
+
+static void run_table(int count, int repeats){
+    int *source = malloc(sizeof(int) * count);
+    int *work = malloc(sizeof(int) * count);
+    assert(source != NULL && work != NULL);
+
+    printf("\n%d items (%d KB), ns per item\n", count, (int)(sizeof(int) * (long)count / 1024));
+    printf("%11s", "duplicate%");
+    for (int f = 0; f < FUNCTION_COUNT; f++){
+        printf(" %16s", names[f]);
+    }
+    printf("\n");
+
+    int percents[] = {0, 1, 10, 25, 50, 75, 90, 99, 100};
+    for (int p = 0; p < 9; p++){
+        fill_sorted(source, count, percents[p]);
+        printf("%11d", percents[p]);
+        for (int f = 0; f < FUNCTION_COUNT; f++){
+            if (!available[f]){
+                printf(" %16s", "n/a");
+                continue;
+            }
+            double total = 0;
+            for (int r = 0; r < repeats; r++){
+                memcpy(work, source, sizeof(int) * count);
+                double start = now_ns();
+                sink = functions[f](work, count);
+                total += now_ns() - start;
+            }
+            printf(" %16.3f", total / repeats / count);
+        }
+        printf("\n");
+    }
+    free(source);
+    free(work);
+}
+
+int main(){
+    threads = sysconf(_SC_NPROCESSORS_ONLN);
+    available[0] = available[1] = available[4] = true;
+    available[2] = unique_kernel_supported(UNIQUE_AVX2);
+    available[3] = unique_kernel_supported(UNIQUE_AVX512);
+
+    check_all();
+    printf("All kernels match removeDuplicates.\n");
+    printf("parallel uses %d thread(s)\n", threads);
+
+    run_table(SMALL_ITEMS, SMALL_REPEATS);
+    run_table(LARGE_ITEMS, LARGE_REPEATS);
+    return 0;
+}
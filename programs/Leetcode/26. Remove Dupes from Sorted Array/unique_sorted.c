@@ -0,0 +1,144 @@
+#include "unique_sorted.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include "../simd_common.h"
+
+// All the *_after kernels keep the items of nums that differ from their
+// predecessor, where the predecessor of nums[0] is previous.
+
+// four at a time like filter_remove_value_scalar, comparing each item
+// with the one loaded just before it rather than with a fixed value
+static int unique_after_scalar(int *nums, int count, int previous){
+    int kept = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4){
+        int a = nums[i], b = nums[i + 1], c = nums[i + 2], d = nums[i + 3];
+        nums[kept] = a;
+        kept += a != previous;
+        nums[kept] = b;
+        kept += b != a;
+        nums[kept] = c;
+        kept += c != b;
+        nums[kept] = d;
+        kept += d != c;
+        previous = d;
+    }
+    for (; i < count; i++){
+        int item = nums[i];
+        nums[kept] = item;
+        kept += item != previous;
+        previous = item;
+    }
+    return kept;
+}
+
+//=========== AVX2 ===================================
+
+// the store of all 8 lanes at kept <= i only overwrites items already
+// loaded, so this works in place
+__attribute__((target("avx2,popcnt")))
+static int unique_after_avx2(int *nums, int count, int previous){
+    simd_left_pack_init();
+    const __m256i rotate = _mm256_setr_epi32(7, 0, 1, 2, 3, 4, 5, 6);
+    int kept = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8){
+        __m256i items = _mm256_loadu_si256((__m256i *)(nums + i));
+        // [previous, items[0..6]]
+        __m256i before = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(items, rotate),
+                                            _mm256_set1_epi32(previous), 1);
+        int same = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(items, before)));
+        int keep = ~same & 0xFF;
+        __m256i order = _mm256_load_si256((__m256i *)simd_left_pack[keep]);
+        _mm256_storeu_si256((__m256i *)(nums + kept), _mm256_permutevar8x32_epi32(items, order));
+        kept += _mm_popcnt_u32(keep);
+        previous = _mm256_extract_epi32(items, 7);
+    }
+    for (; i < count; i++){
+        int item = nums[i];
+        nums[kept] = item;
+        kept += item != previous;
+        previous = item;
+    }
+    return kept;
+}
+
+//=========== AVX-512 ===================================
+
+__attribute__((target("avx512f,popcnt")))
+static int unique_after_avx512(int *nums, int count, int previous){
+    __m512i last_block = _mm512_set1_epi32(previous); // only lane 15 is used
+    int kept = 0;
+    int i = 0;
+    for (; i + 16 <= count; i += 16){
+        __m512i items = _mm512_loadu_si512(nums + i);
+        // [last_block[15], items[0..14]]
+        __m512i before = _mm512_alignr_epi32(items, last_block, 15);
+        __mmask16 keep = _mm512_cmpneq_epi32_mask(items, before);
+        _mm512_storeu_si512(nums + kept, _mm512_maskz_compress_epi32(keep, items));
+        kept += _mm_popcnt_u32(keep);
+        last_block = items;
+    }
+    if (i < count){
+        __mmask16 tail = (__mmask16)((1u << (count - i)) - 1);
+        __m512i items = _mm512_maskz_loadu_epi32(tail, nums + i);
+        __m512i before = _mm512_alignr_epi32(items, last_block, 15);
+        __mmask16 keep = _mm512_mask_cmpneq_epi32_mask(tail, items, before);
+        _mm512_mask_storeu_epi32(nums + kept, (__mmask16)((1u << _mm_popcnt_u32(keep)) - 1),
+                                 _mm512_maskz_compress_epi32(keep, items));
+        kept += _mm_popcnt_u32(keep);
+    }
+    return kept;
+}
+
+//=========== entry points ===================================
+
+// the first item always survives; the rest are compared from nums + 1
+static int unique_with(SimdCompact kernel, int *nums, int count){
+    if (count == 0){
+        return 0;
+    }
+    return 1 + kernel(nums + 1, count - 1, nums[0]);
+}
+
+int unique_sorted_scalar(int *nums, int count){
+    return unique_with(unique_after_scalar, nums, count);
+}
+
+int unique_sorted_avx2(int *nums, int count){
+    return unique_with(unique_after_avx2, nums, count);
+}
+
+int unique_sorted_avx512(int *nums, int count){
+    return unique_with(unique_after_avx512, nums, count);
+}
+
+bool unique_kernel_supported(UniqueKernel kernel){
+    switch (kernel){
+        case UNIQUE_AVX512: return simd_level_supported(SIMD_AVX512);
+        case UNIQUE_AVX2: return simd_level_supported(SIMD_AVX2);
+        default: return true;
+    }
+}
+
+static SimdCompact best_kernel(){
+    static SimdCompact selected = NULL;
+    return simd_select(&selected, unique_after_scalar, unique_after_avx2, unique_after_avx512);
+}
+
+int unique_sorted(int *nums, int count){
+    return unique_with(best_kernel(), nums, count);
+}
+
+//=========== parallel ===================================
+
+// a chunk compares its first item with the one just before it
+static int unique_chunk_arg(const int *nums, int start, int context){
+    (void)context;
+    return nums[start - 1];
+}
+
+int unique_sorted_parallel(int *nums, int count, int threads){
+    // nums[0] always survives, so the chunks start at nums + 1
+    return simd_parallel_compact(nums, count, 1, threads, best_kernel(), unique_chunk_arg, 0);
+}
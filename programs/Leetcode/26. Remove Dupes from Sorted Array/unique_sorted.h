@@ -0,0 +1,42 @@
+#ifndef UNIQUE_SORTED_H
+#define UNIQUE_SORTED_H
+
+#include <stdbool.h>
+
+/* Remove Duplicates from Sorted Array as a library kernel for large
+sorted ID columns. Keeps the first of each run of equal items, in place,
+and returns how many are left (the same contract as removeDuplicates in
+../670. Maximum Swap/main2.c).
+
+An item survives if it differs from the one before it. The vector
+versions get "the one before" by shifting the loaded vector one lane
+and filling lane 0 from the previous block, rather than loading again
+at i - 1, because i - 1 may already have been overwritten.
+
+- AVX-512: valignd for the shift, vpcompressd for the left-pack
+- AVX2: vpermd + blend for the shift, a 256-entry permute table for the
+  left-pack
+- scalar: always store, advance by (item != previous); no data branch
+
+unique_sorted picks the widest one the CPU supports at run time. */
+
+typedef enum UniqueKernel{
+    UNIQUE_SCALAR,
+    UNIQUE_AVX2,
+    UNIQUE_AVX512,
+}UniqueKernel;
+
+//Prototypes
+int unique_sorted(int *nums, int count);
+int unique_sorted_scalar(int *nums, int count);
+int unique_sorted_avx2(int *nums, int count);
+int unique_sorted_avx512(int *nums, int count);
+bool unique_kernel_supported(UniqueKernel kernel);
+// One chunk per thread. Each chunk compares its first item with the
+// item just before the chunk (read before any thread writes), then the
+// surviving runs are moved together.
+int unique_sorted_parallel(int *nums, int count, int threads);
+
+
+
+#endif
@@ -0,0 +1,126 @@
+#include "filter.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include "../simd_common.h"
+
+// Loads four items before storing any, so the loads never wait on the
+// stores to nums[kept] (which the compiler must assume may alias).
+int filter_remove_value_scalar(int *nums, int count, int val){
+    int kept = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4){
+        int a = nums[i], b = nums[i + 1], c = nums[i + 2], d = nums[i + 3];
+        nums[kept] = a;
+        kept += a != val;
+        nums[kept] = b;
+        kept += b != val;
+        nums[kept] = c;
+        kept += c != val;
+        nums[kept] = d;
+        kept += d != val;
+    }
+    for (; i < count; i++){
+        int item = nums[i];
+        nums[kept] = item;
+        kept += item != val;
+    }
+    return kept;
+}
+
+//=========== AVX2 ===================================
+
+// The full 8-lane store at kept only overwrites items that were already
+// loaded (kept <= i), so filtering in place is safe.
+__attribute__((target("avx2,popcnt")))
+int filter_remove_value_avx2(int *nums, int count, int val){
+    simd_left_pack_init();
+    __m256i target = _mm256_set1_epi32(val);
+    int kept = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8){
+        __m256i items = _mm256_loadu_si256((__m256i *)(nums + i));
+        int removed = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(items, target)));
+        int keep = ~removed & 0xFF;
+        __m256i order = _mm256_load_si256((__m256i *)simd_left_pack[keep]);
+        _mm256_storeu_si256((__m256i *)(nums + kept), _mm256_permutevar8x32_epi32(items, order));
+        kept += _mm_popcnt_u32(keep);
+    }
+    for (; i < count; i++){
+        int item = nums[i];
+        nums[kept] = item;
+        kept += item != val;
+    }
+    return kept;
+}
+
+//=========== AVX-512 ===================================
+
+// compress into a register and store all 16 lanes; a masked
+// compress-store to memory is much slower on some cores
+__attribute__((target("avx512f,popcnt")))
+int filter_remove_value_avx512(int *nums, int count, int val){
+    __m512i target = _mm512_set1_epi32(val);
+    int kept = 0;
+    int i = 0;
+    for (; i + 16 <= count; i += 16){
+        __m512i items = _mm512_loadu_si512(nums + i);
+        __mmask16 keep = _mm512_cmpneq_epi32_mask(items, target);
+        _mm512_storeu_si512(nums + kept, _mm512_maskz_compress_epi32(keep, items));
+        kept += _mm_popcnt_u32(keep);
+    }
+    if (i < count){
+        __mmask16 tail = (__mmask16)((1u << (count - i)) - 1);
+        __m512i items = _mm512_maskz_loadu_epi32(tail, nums + i);
+        __mmask16 keep = _mm512_mask_cmpneq_epi32_mask(tail, items, target);
+        _mm512_mask_storeu_epi32(nums + kept, (__mmask16)((1u << _mm_popcnt_u32(keep)) - 1),
+                                 _mm512_maskz_compress_epi32(keep, items));
+        kept += _mm_popcnt_u32(keep);
+    }
+    return kept;
+}
+
+//=========== dispatch ===================================
+
+static SimdLevel filter_level(FilterKernel kernel){
+    switch (kernel){
+        case FILTER_AVX512: return SIMD_AVX512;
+        case FILTER_AVX2: return SIMD_AVX2;
+        default: return SIMD_SCALAR;
+    }
+}
+
+bool filter_kernel_supported(FilterKernel kernel){
+    return simd_level_supported(filter_level(kernel));
+}
+
+FilterKernel filter_best_kernel(void){
+    switch (simd_best_level()){
+        case SIMD_AVX512: return FILTER_AVX512;
+        case SIMD_AVX2: return FILTER_AVX2;
+        default: return FILTER_SCALAR;
+    }
+}
+
+static SimdCompact filter_selected_kernel(){
+    static SimdCompact selected = NULL;
+    return simd_select(&selected, filter_remove_value_scalar, filter_remove_value_avx2,
+                       filter_remove_value_avx512);
+}
+
+int filter_remove_value(int *nums, int count, int val){
+    return filter_selected_kernel()(nums, count, val);
+}
+
+//=========== parallel ===================================
+
+// every chunk drops the same value
+static int filter_chunk_arg(const int *nums, int start, int val){
+    (void)nums;
+    (void)start;
+    return val;
+}
+
+int filter_remove_value_parallel(int *nums, int count, int val, int threads){
+    return simd_parallel_compact(nums, count, 0, threads, filter_selected_kernel(),
+                                 filter_chunk_arg, val);
+}
@@ -0,0 +1,43 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <stdbool.h>
+
+/* removeElement from main.c as a filter kernel for large int columns.
+Every version keeps the order of the kept items, works in place and
+returns how many are left, same as removeElement.
+
+filter_remove_value picks the widest version the CPU supports at run
+time, so the file builds with plain gcc -O2 (no -mavx2 needed):
+
+- AVX-512: compare 16 lanes, vpcompressd the kept ones to the front
+- AVX2: compare 8 lanes, left-pack with a permute picked from a
+  256-entry table by the keep mask
+- scalar: always store, advance the write index by (item != val), so
+  there is no branch on the data
+
+None of them branch on the data, so the speed does not depend on how
+many items match. */
+
+typedef enum FilterKernel{
+    FILTER_SCALAR,
+    FILTER_AVX2,
+    FILTER_AVX512,
+}FilterKernel;
+
+//Prototypes
+int filter_remove_value(int *nums, int count, int val);
+int filter_remove_value_scalar(int *nums, int count, int val);
+int filter_remove_value_avx2(int *nums, int count, int val);
+int filter_remove_value_avx512(int *nums, int count, int val);
+// best kernel this CPU supports
+FilterKernel filter_best_kernel(void);
+bool filter_kernel_supported(FilterKernel kernel);
+// Splits nums into one chunk per thread, filters the chunks in parallel,
+// then closes the gaps between them. For arrays much larger than the
+// last level cache; small inputs just run filter_remove_value.
+int filter_remove_value_parallel(int *nums, int count, int val, int threads);
+
+
+
+#endif
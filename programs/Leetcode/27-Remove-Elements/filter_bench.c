@@ -0,0 +1,145 @@
+#define FILTER_BENCH
+#define _POSIX_C_SOURCE 199309L
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <assert.h>
+#include "main.c"
+#include "filter.h"
+
+/* Checks every filter kernel against removeElement, then times them for
+removed fractions from 0% to 100% with the removed items at random
+positions. removeElement's branch is hardest to predict near 50%; the
+kernels in filter.c should show a flat line.
+
+One table for an array that fits in L2, one for an array much larger
+than the last level cache (where the parallel version applies).
+
+    gcc -O2 -pthread filter_bench.c filter.c -o filter_bench
+    ./filter_bench */
+
+#define SMALL_ITEMS (16 * 1024)
+#define SMALL_REPEATS 2000
+#define LARGE_ITEMS (16 * 1024 * 1024)
+#define LARGE_REPEATS 5
+#define VALUE 7
+
+typedef int (*FilterFunction)(int *nums, int count, int val);
+
+static int threads = 1;
+
+static int parallel_kernel(int *nums, int count, int val){
+    return filter_remove_value_parallel(nums, count, val, threads);
+}
+
+static const char *names[] = {"removeElement", "scalar", "avx2", "avx512", "parallel"};
+static FilterFunction functions[] = {removeElement, filter_remove_value_scalar, filter_remove_value_avx2,
+                                     filter_remove_value_avx512, parallel_kernel};
+static bool available[5];
+#define FUNCTION_COUNT 5
+
+static void fill(int *nums, int count, int removed_percent){
+    for (int i = 0; i < count; i++){
+        nums[i] = rand() % 100 < removed_percent ? VALUE : VALUE + 1 + rand() % 1000;
+    }
+}
+
+static void check_all(){
+    int *source = malloc(sizeof(int) * 300000);
+    int *expected = malloc(sizeof(int) * 300000);
+    int *actual = malloc(sizeof(int) * 300000);
+    assert(source != NULL && expected != NULL && actual != NULL);
+
+    int sizes[] = {0, 1, 7, 8, 9, 15, 16, 17, 31, 33, 100, 1000, 299999};
+    int percents[] = {0, 3, 50, 97, 100};
+    for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++){
+        for (int p = 0; p < 5; p++){
+            fill(source, sizes[s], percents[p]);
+            memcpy(expected, source, sizeof(int) * sizes[s]);
+            int expected_kept = removeElement(expected, sizes[s], VALUE);
+            for (int f = 1; f < FUNCTION_COUNT; f++){
+                if (!available[f]){
+                    continue;
+                }
+                memcpy(actual, source, sizeof(int) * sizes[s]);
+                int kept = functions[f](actual, sizes[s], VALUE);
+                assert(kept == expected_kept);
+                assert(memcmp(actual, expected, sizeof(int) * kept) == 0);
+            }
+        }
+    }
+    // the parallel path needs several chunks; force 4 threads here
+    int saved = threads;
+    threads = 4;
+    fill(source, 299999, 50);
+    memcpy(expected, source, sizeof(int) * 299999);
+    memcpy(actual, source, sizeof(int) * 299999);
+    int expected_kept = removeElement(expected, 299999, VALUE);
+    assert(filter_remove_value_parallel(actual, 299999, VALUE, 4) == expected_kept);
+    assert(memcmp(actual, expected, sizeof(int) * expected_kept) == 0);
+    threads = saved;
+
+    free(source);
+    free(expected);
+    free(actual);
+}
+
+static double now_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile int sink;
+
+static void run_table(int count, int repeats){
+    int *source = malloc(sizeof(int) * count);
+    int *work = malloc(sizeof(int) * count);
+    assert(source != NULL && work != NULL);
+
+    printf("\n%d items (%d KB), ns per item\n", count, (int)(sizeof(int) * (long)count / 1024));
+    printf("%9s", "removed%");
+    for (int f = 0; f < FUNCTION_COUNT; f++){
+        printf(" %14s", names[f]);
+    }
+    printf("\n");
+
+    int percents[] = {0, 1, 10, 25, 50, 75, 90, 99, 100};
+    for (int p = 0; p < 9; p++){
+        fill(source, count, percents[p]);
+        printf("%9d", percents[p]);
+        for (int f = 0; f < FUNCTION_COUNT; f++){
+            if (!available[f]){
+                printf(" %14s", "n/a");
+                continue;
+            }
+            double total = 0;
+            for (int r = 0; r < repeats; r++){
+                memcpy(work, source, sizeof(int) * count);
+                double start = now_ns();
+                sink = functions[f](work, count, VALUE);
+                total += now_ns() - start;
+            }
+            printf(" %14.3f", total / repeats / count);
+        }
+        printf("\n");
+    }
+    free(source);
+    free(work);
+}
+
+int main(){
+    threads = sysconf(_SC_NPROCESSORS_ONLN);
+    available[0] = available[1] = available[4] = true;
+    available[2] = filter_kernel_supported(FILTER_AVX2);
+    available[3] = filter_kernel_supported(FILTER_AVX512);
+
+    check_all();
+    printf("All kernels match removeElement.\n");
+    printf("parallel uses %d thread(s)\n", threads);
+
+    run_table(SMALL_ITEMS, SMALL_REPEATS);
+    run_table(LARGE_ITEMS, LARGE_REPEATS);
+    return 0;
+}
@@ -20,6 +20,7 @@ int removeElement(int* nums, int numsSize, int val){
 }
 
 
+#ifndef FILTER_BENCH
 int main(){
 
 
@@ -33,4 +34,5 @@ int main(){
         printf("%d, ", nums[i]);
     }
     printf("\n%d\n",k);
-}
\ No newline at end of file
+}
+#endif
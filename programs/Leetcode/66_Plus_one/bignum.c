@@ -0,0 +1,251 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bignum.h"
+
+#define BIGNUM_MIN_CAPACITY 4
+
+static void bignum_trim(Bignum *number);
+
+
+Bignum* bignum_new(void){
+    return bignum_new_with_allocator(default_allocator());
+}
+
+Bignum* bignum_new_with_allocator(Allocator *allocator){
+    Bignum *number = allocator_allocate(allocator, sizeof(Bignum));
+    if (number == NULL){
+        return NULL;
+    }
+    number->limbs = allocator_allocate(allocator, sizeof(uint64_t) * BIGNUM_MIN_CAPACITY);
+    if (number->limbs == NULL){
+        allocator_release(allocator, number, sizeof(Bignum));
+        return NULL;
+    }
+    number->allocator = allocator;
+    number->capacity = BIGNUM_MIN_CAPACITY;
+    number->count = 1;
+    number->limbs[0] = 0;
+    return number;
+}
+
+void bignum_destroy(Bignum *number){
+    allocator_release(number->allocator, number->limbs, sizeof(uint64_t) * number->capacity);
+    allocator_release(number->allocator, number, sizeof(Bignum));
+}
+
+ContainerStatus bignum_reserve(Bignum *number, int limbs){
+    if (limbs <= number->capacity){
+        return CONTAINER_OK;
+    }
+    int new_capacity = number->capacity;
+    while (new_capacity < limbs){
+        new_capacity *= 2;
+    }
+    uint64_t *new_limbs = allocator_reallocate(number->allocator, number->limbs,
+                                               sizeof(uint64_t) * number->capacity,
+                                               sizeof(uint64_t) * new_capacity);
+    if (new_limbs == NULL){
+        return CONTAINER_NO_MEMORY;
+    }
+    number->limbs = new_limbs;
+    number->capacity = new_capacity;
+    return CONTAINER_OK;
+}
+
+static void bignum_trim(Bignum *number){
+    while (number->count > 1 && number->limbs[number->count - 1] == 0){
+        number->count--;
+    }
+}
+
+ContainerStatus bignum_set_u64(Bignum *number, uint64_t value){
+    if (bignum_reserve(number, 2) != CONTAINER_OK){
+        return CONTAINER_NO_MEMORY;
+    }
+    number->limbs[0] = value % BIGNUM_BASE;
+    number->limbs[1] = value / BIGNUM_BASE;
+    number->count = 2;
+    bignum_trim(number);
+    return CONTAINER_OK;
+}
+
+// Six digits at a time in three independent chains, so the multiply-adds
+// overlap instead of forming one 18 step dependency chain.
+static uint64_t parse_limb(const int *digits){
+    uint32_t high = 0;
+    uint32_t middle = 0;
+    uint32_t low = 0;
+    for (int i = 0; i < 6; i++){
+        high = high * 10 + digits[i];
+        middle = middle * 10 + digits[i + 6];
+        low = low * 10 + digits[i + 12];
+    }
+    return (uint64_t)high * 1000000000000ULL + (uint64_t)middle * 1000000 + low;
+}
+
+ContainerStatus bignum_from_digits(Bignum *number, const int *digits, int digit_count){
+    int limb_count = (digit_count + BIGNUM_BASE_DIGITS - 1) / BIGNUM_BASE_DIGITS;
+    if (limb_count == 0){
+        return bignum_set_u64(number, 0);
+    }
+    if (bignum_reserve(number, limb_count) != CONTAINER_OK){
+        return CONTAINER_NO_MEMORY;
+    }
+
+    // full limbs from the least significant end; the leftover digits at
+    // the front make the top limb
+    const int *end = digits + digit_count;
+    for (int i = 0; i < digit_count / BIGNUM_BASE_DIGITS; i++){
+        number->limbs[i] = parse_limb(end - (i + 1) * BIGNUM_BASE_DIGITS);
+    }
+    int leftover = digit_count % BIGNUM_BASE_DIGITS;
+    if (leftover > 0){
+        uint64_t top = 0;
+        for (int i = 0; i < leftover; i++){
+            top = top * 10 + digits[i];
+        }
+        number->limbs[limb_count - 1] = top;
+    }
+    number->count = limb_count;
+    bignum_trim(number);
+    return CONTAINER_OK;
+}
+
+static int limb_digit_count(uint64_t limb){
+    int count = 1;
+    while (limb >= 10){
+        limb /= 10;
+        count++;
+    }
+    return count;
+}
+
+int bignum_digit_count(const Bignum *number){
+    return (number->count - 1) * BIGNUM_BASE_DIGITS + limb_digit_count(number->limbs[number->count - 1]);
+}
+
+// Splits the limb into two 9 digit halves so the divisions by 10 are
+// 32-bit multiplies, and the two halves run side by side.
+static void write_limb(uint64_t limb, int *digits){
+    uint32_t high = (uint32_t)(limb / 1000000000);
+    uint32_t low = (uint32_t)(limb - (uint64_t)high * 1000000000);
+    for (int i = 8; i >= 0; i--){
+        digits[i] = high % 10;
+        digits[i + 9] = low % 10;
+        high /= 10;
+        low /= 10;
+    }
+}
+
+int bignum_to_digits(const Bignum *number, int *digits){
+    int top = number->count - 1;
+    uint64_t top_limb = number->limbs[top];
+    int top_digits = limb_digit_count(top_limb);
+    for (int i = top_digits - 1; i >= 0; i--){
+        digits[i] = top_limb % 10;
+        top_limb /= 10;
+    }
+    int *out = digits + top_digits;
+    for (int i = top - 1; i >= 0; i--){
+        write_limb(number->limbs[i], out);
+        out += BIGNUM_BASE_DIGITS;
+    }
+    return top_digits + top * BIGNUM_BASE_DIGITS;
+}
+
+int bignum_compare(const Bignum *a, const Bignum *b){
+    if (a->count != b->count){
+        return a->count < b->count ? -1 : 1;
+    }
+    for (int i = a->count - 1; i >= 0; i--){
+        if (a->limbs[i] != b->limbs[i]){
+            return a->limbs[i] < b->limbs[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+ContainerStatus bignum_increment(Bignum *number){
+    for (int i = 0; i < number->count; i++){
+        if (++number->limbs[i] < BIGNUM_BASE){
+            return CONTAINER_OK;
+        }
+        number->limbs[i] = 0;
+    }
+    // every limb was all nines
+    if (bignum_reserve(number, number->count + 1) != CONTAINER_OK){
+        for (int i = 0; i < number->count; i++){
+            number->limbs[i] = BIGNUM_BASE - 1;
+        }
+        return CONTAINER_NO_MEMORY;
+    }
+    number->limbs[number->count++] = 1;
+    return CONTAINER_OK;
+}
+
+// Limbs are below 10^18, so a + b + carry < 2^64 and the carry out is
+// just sum >= BASE; gcc makes the subtraction a conditional move.
+ContainerStatus bignum_add(Bignum *result, const Bignum *a, const Bignum *b){
+    if (a->count < b->count){
+        const Bignum *swap = a;
+        a = b;
+        b = swap;
+    }
+    int a_count = a->count;
+    int b_count = b->count;
+    if (bignum_reserve(result, a_count + 1) != CONTAINER_OK){
+        return CONTAINER_NO_MEMORY;
+    }
+    // read the limb pointers after the reserve, which may move result's
+    const uint64_t *x = a->limbs;
+    const uint64_t *y = b->limbs;
+    uint64_t *out = result->limbs;
+
+    uint64_t carry = 0;
+    int i = 0;
+    for (; i < b_count; i++){
+        uint64_t sum = x[i] + y[i] + carry;
+        carry = sum >= BIGNUM_BASE;
+        out[i] = carry ? sum - BIGNUM_BASE : sum;
+    }
+    for (; i < a_count; i++){
+        uint64_t sum = x[i] + carry;
+        carry = sum >= BIGNUM_BASE;
+        out[i] = carry ? sum - BIGNUM_BASE : sum;
+    }
+    out[a_count] = carry;
+    result->count = a_count + (int)carry;
+    return CONTAINER_OK;
+}
+
+ContainerStatus bignum_sub(Bignum *result, const Bignum *a, const Bignum *b){
+    if (bignum_compare(a, b) < 0){
+        fprintf(stderr, "bignum_sub: result would be negative.\n");
+        exit(EXIT_FAILURE);
+    }
+    int a_count = a->count;
+    int b_count = b->count;
+    if (bignum_reserve(result, a_count) != CONTAINER_OK){
+        return CONTAINER_NO_MEMORY;
+    }
+    const uint64_t *x = a->limbs;
+    const uint64_t *y = b->limbs;
+    uint64_t *out = result->limbs;
+
+    uint64_t borrow = 0;
+    int i = 0;
+    for (; i < b_count; i++){
+        uint64_t take = y[i] + borrow;
+        borrow = x[i] < take;
+        out[i] = x[i] - take + (borrow ? BIGNUM_BASE : 0);
+    }
+    for (; i < a_count; i++){
+        uint64_t take = borrow;
+        borrow = x[i] < take;
+        out[i] = x[i] - take + (borrow ? BIGNUM_BASE : 0);
+    }
+    result->count = a_count;
+    bignum_trim(result);
+    return CONTAINER_OK;
+}
@@ -0,0 +1,54 @@
+#ifndef BIGNUM_H
+#define BIGNUM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "../../allocator/allocator.h"
+
+/* Non-negative arbitrary precision integers for long decimal numbers,
+the general case of Plus One (plusOne in main.c).
+
+Limbs are base 10^18 (18 decimal digits in a uint64_t), least
+significant first, rather than one digit per int. Base 10^18 instead of
+2^64 keeps conversion to and from digit arrays linear: every limb maps
+to exactly 18 digits, where binary limbs would need a quadratic radix
+conversion. Two limbs plus a carry still fit in 64 bits, so add and
+subtract carry with a compare instead of an add-with-carry chain.
+
+Digit arrays are most significant digit first, one digit per int, like
+plusOne. Functions that can grow a Bignum return CONTAINER_NO_MEMORY and
+leave it unchanged when out of memory. */
+
+#define BIGNUM_BASE 1000000000000000000ULL
+#define BIGNUM_BASE_DIGITS 18
+
+typedef struct Bignum{
+    uint64_t *limbs;
+    int count;    // limbs in use, at least 1; no leading zero limbs
+    int capacity;
+    Allocator *allocator;
+}Bignum;
+
+//Prototypes
+// returns NULL if out of memory; the value starts at 0
+Bignum* bignum_new(void);
+Bignum* bignum_new_with_allocator(Allocator *allocator);
+void bignum_destroy(Bignum *number);
+ContainerStatus bignum_reserve(Bignum *number, int limbs);
+ContainerStatus bignum_set_u64(Bignum *number, uint64_t value);
+ContainerStatus bignum_from_digits(Bignum *number, const int *digits, int digit_count);
+int bignum_digit_count(const Bignum *number);
+// writes bignum_digit_count(number) digits and returns that count
+int bignum_to_digits(const Bignum *number, int *digits);
+int bignum_compare(const Bignum *a, const Bignum *b);
+
+// adds 1; the carry stops at the first limb that is not all nines
+ContainerStatus bignum_increment(Bignum *number);
+// result = a + b; result may be a or b
+ContainerStatus bignum_add(Bignum *result, const Bignum *a, const Bignum *b);
+// result = a - b, which must not be negative; result may be a or b
+ContainerStatus bignum_sub(Bignum *result, const Bignum *a, const Bignum *b);
+
+
+
+#endif
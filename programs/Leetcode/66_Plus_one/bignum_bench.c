@@ -0,0 +1,199 @@
+#define BIGNUM_BENCH
+#define _POSIX_C_SOURCE 199309L
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include "main.c"
+#include "bignum.h"
+
+/* Checks bignum.c against one-int-per-digit arithmetic (plusOne in
+main.c and digit_array_add below) on random numbers, then times both on
+numbers of 10^3 to 10^7 digits. The round trip column is
+bignum_from_digits plus bignum_to_digits.
+
+    gcc -O2 bignum_bench.c bignum.c -o bignum_bench
+    ./bignum_bench */
+
+#define MAX_DIGITS 10000000
+#define CHECK_ROUNDS 2000
+
+static double now_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static unsigned int seed = 12345;
+
+static int random_digit(){
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % 10;
+}
+
+// count digits with no leading zero; nines_percent of them are 9 so
+// carries run long
+static void random_digits(int *digits, int count, int nines_percent){
+    for (int i = 0; i < count; i++){
+        digits[i] = (int)((seed = seed * 1103515245 + 12345) >> 16) % 100 < nines_percent ? 9 : random_digit();
+    }
+    if (digits[0] == 0){
+        digits[0] = 1;
+    }
+}
+
+// out needs max(a_count, b_count) + 1 ints; returns the digit count
+static int digit_array_add(const int *a, int a_count, const int *b, int b_count, int *out){
+    int count = (a_count > b_count ? a_count : b_count) + 1;
+    int carry = 0;
+    for (int i = 0; i < count; i++){
+        int sum = carry;
+        sum += i < a_count ? a[a_count - 1 - i] : 0;
+        sum += i < b_count ? b[b_count - 1 - i] : 0;
+        carry = sum >= 10;
+        out[count - 1 - i] = sum - 10 * carry;
+    }
+    if (out[0] == 0){
+        memmove(out, out + 1, sizeof(int) * (count - 1));
+        count--;
+    }
+    return count;
+}
+
+static void check_against_digits(){
+    int *a = malloc(sizeof(int) * 1000);
+    int *b = malloc(sizeof(int) * 1000);
+    int *expected = malloc(sizeof(int) * 1001);
+    int *actual = malloc(sizeof(int) * 1001);
+    Bignum *x = bignum_new();
+    Bignum *y = bignum_new();
+    Bignum *z = bignum_new();
+
+    for (int round = 0; round < CHECK_ROUNDS; round++){
+        int a_count = 1 + random_digit() * 37 + random_digit() * 3 + random_digit() % 3;
+        int b_count = 1 + random_digit() * 41 + random_digit();
+        random_digits(a, a_count, round % 3 == 0 ? 90 : 10);
+        random_digits(b, b_count, round % 5 == 0 ? 90 : 10);
+        bignum_from_digits(x, a, a_count);
+        bignum_from_digits(y, b, b_count);
+
+        // round trip
+        assert(bignum_digit_count(x) == a_count);
+        assert(bignum_to_digits(x, actual) == a_count);
+        assert(memcmp(actual, a, sizeof(int) * a_count) == 0);
+
+        // increment
+        int expected_count;
+        int *plus_one = plusOne(a, a_count, &expected_count);
+        bignum_increment(x);
+        assert(bignum_to_digits(x, actual) == expected_count);
+        assert(memcmp(actual, plus_one, sizeof(int) * expected_count) == 0);
+        free(plus_one);
+
+        // add, then subtract back; z aliases as both result and operand
+        bignum_from_digits(x, a, a_count);
+        expected_count = digit_array_add(a, a_count, b, b_count, expected);
+        bignum_add(z, x, y);
+        assert(bignum_to_digits(z, actual) == expected_count);
+        assert(memcmp(actual, expected, sizeof(int) * expected_count) == 0);
+        bignum_sub(z, z, y);
+        assert(bignum_compare(z, x) == 0);
+        bignum_add(x, x, x);
+        bignum_sub(x, x, z);
+        assert(bignum_compare(x, z) == 0);
+    }
+
+    // all nines grow a limb, and the edges of a limb
+    int nines[36];
+    for (int i = 0; i < 36; i++){
+        nines[i] = 9;
+    }
+    bignum_from_digits(x, nines, 36);
+    bignum_increment(x);
+    assert(bignum_digit_count(x) == 37 && x->count == 3);
+    bignum_sub(x, x, x);
+    assert(bignum_digit_count(x) == 1 && x->limbs[0] == 0);
+    bignum_set_u64(x, UINT64_MAX);
+    bignum_to_digits(x, actual);
+    assert(bignum_digit_count(x) == 20 && actual[0] == 1 && actual[19] == 5);
+
+    bignum_destroy(x);
+    bignum_destroy(y);
+    bignum_destroy(z);
+    free(a);
+    free(b);
+    free(expected);
+    free(actual);
+    printf("%d random rounds agree with the digit array versions\n", CHECK_ROUNDS);
+}
+
+int main(){
+    check_against_digits();
+
+    int *a = malloc(sizeof(int) * MAX_DIGITS);
+    int *b = malloc(sizeof(int) * MAX_DIGITS);
+    int *out = malloc(sizeof(int) * (MAX_DIGITS + 1));
+    Bignum *x = bignum_new();
+    Bignum *y = bignum_new();
+    Bignum *z = bignum_new();
+
+    printf("%9s | %12s %12s | %12s %12s | %14s\n", "", "+1 (all 9s)", "", "a + b", "", "round trip");
+    printf("%9s | %12s %12s | %12s %12s | %14s\n", "digits", "plusOne ms", "bignum ms",
+           "int/digit ms", "bignum ms", "bignum ms");
+    for (int digits = 1000; digits <= MAX_DIGITS; digits *= 10){
+        int repeats = MAX_DIGITS / digits;
+        for (int i = 0; i < digits; i++){
+            a[i] = 9;
+        }
+        random_digits(b, digits, 10);
+        bignum_from_digits(x, a, digits);
+        bignum_from_digits(y, b, digits);
+
+        int count;
+        double start = now_ns();
+        for (int r = 0; r < repeats; r++){
+            free(plusOne(a, digits, &count));
+        }
+        double naive_increment = (now_ns() - start) / repeats / 1e6;
+
+        // reset to all nines outside the timed part so every increment
+        // carries the whole length
+        double increment = 0;
+        for (int r = 0; r < repeats; r++){
+            bignum_from_digits(z, a, digits);
+            start = now_ns();
+            bignum_increment(z);
+            increment += now_ns() - start;
+        }
+        increment = increment / repeats / 1e6;
+
+        start = now_ns();
+        for (int r = 0; r < repeats; r++){
+            digit_array_add(a, digits, b, digits, out);
+        }
+        double naive_add = (now_ns() - start) / repeats / 1e6;
+
+        start = now_ns();
+        for (int r = 0; r < repeats; r++){
+            bignum_add(z, x, y);
+        }
+        double add = (now_ns() - start) / repeats / 1e6;
+
+        start = now_ns();
+        for (int r = 0; r < repeats; r++){
+            bignum_from_digits(z, b, digits);
+            bignum_to_digits(z, out);
+        }
+        double convert = (now_ns() - start) / repeats / 1e6;
+
+        printf("%9d | %12.4f %12.4f | %12.4f %12.4f | %14.4f\n", digits, naive_increment,
+               increment, naive_add, add, convert);
+    }
+
+    bignum_destroy(x);
+    bignum_destroy(y);
+    bignum_destroy(z);
+    free(a);
+    free(b);
+    free(out);
+    return 0;
+}
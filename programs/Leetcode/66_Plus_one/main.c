@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 int* twoSum(int* nums, int numsSize, int target, int* returnSize) {
     int *return_array=malloc(sizeof(int)*2);
@@ -16,6 +17,7 @@ int* twoSum(int* nums, int numsSize, int target, int* returnSize) {
         }
     }
 
+    free(return_array);
     *returnSize=0;
     return NULL;
 
@@ -26,6 +28,28 @@ int* twoSum(int* nums, int numsSize, int target, int* returnSize) {
 }
 
 
+// Plus One (66): adds one to a number stored one digit per int, most
+// significant first. Returns a new array of *returnSize digits.
+int* plusOne(int* digits, int digitsSize, int* returnSize){
+    int *result = malloc(sizeof(int) * (digitsSize + 1));
+    int carry = 1;
+    for (int i = digitsSize - 1; i >= 0; i--){
+        int digit = digits[i] + carry;
+        carry = digit == 10;
+        result[i + 1] = carry ? 0 : digit;
+    }
+    if (carry){
+        result[0] = 1;
+        *returnSize = digitsSize + 1;
+        return result;
+    }
+    memmove(result, result + 1, sizeof(int) * digitsSize);
+    *returnSize = digitsSize;
+    return result;
+}
+
+
+#if !defined(PAIR_SUM_BENCH) && !defined(BIGNUM_BENCH)
 int main(){
 
     int nums[] = {3,2,4};
@@ -41,9 +65,19 @@ int main(){
     for(int i=0;i<returnSize;i++){
         printf("%d", result[i]);
     }
-    printf("]");
+    printf("]\n");
+    free(result);
 
+    int digits[] = {1, 9, 9};
+    int *plus_one = plusOne(digits, 3, &returnSize);
+    printf("Plus one: ");
+    for(int i=0;i<returnSize;i++){
+        printf("%d", plus_one[i]);
+    }
+    printf("\n"); // Expecting 200
+    free(plus_one);
 
 
 
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,254 @@
+#include "pair_sum.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// targets handled together by pair_sum_query_many; their probes are
+// independent, so their cache misses overlap
+#define PAIR_SUM_BATCH 16
+
+// Fibonacci hashing: multiply by 2^32 / golden ratio, keep the high bits
+static unsigned int hash_int(int key, unsigned int mask){
+    uint64_t product = (uint32_t)key * 0x9E3779B97F4A7C15ULL;
+    return (unsigned int)(product >> 32) & mask;
+}
+
+static PairSumSlot* table_new(int count, unsigned int *mask){
+    unsigned int capacity = 16;
+    while (capacity / 4 * 3 < (unsigned int)count){ // load factor <= 3/4
+        capacity *= 2;
+    }
+    PairSumSlot *slots = malloc(sizeof(PairSumSlot) * capacity);
+    if (slots == NULL){
+        return NULL;
+    }
+    for (unsigned int i = 0; i < capacity; i++){
+        slots[i].index = -1;
+    }
+    *mask = capacity - 1;
+    return slots;
+}
+
+// index of key in the table, or -1. Takes a long long so a complement
+// that does not fit in an int is simply not found.
+static int table_find(const PairSumSlot *slots, unsigned int mask, long long wide_key){
+    if (wide_key < INT32_MIN || wide_key > INT32_MAX){
+        return -1;
+    }
+    int key = (int)wide_key;
+    unsigned int slot = hash_int(key, mask);
+    while (slots[slot].index != -1){
+        if (slots[slot].key == key){
+            return slots[slot].index;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+// sets key to index; if the key is already there, keeps the old index
+// unless replace is set
+static void table_put(PairSumSlot *slots, unsigned int mask, int key, int index, bool replace){
+    unsigned int slot = hash_int(key, mask);
+    while (slots[slot].index != -1){
+        if (slots[slot].key == key){
+            if (replace){
+                slots[slot].index = index;
+            }
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+    slots[slot].key = key;
+    slots[slot].index = index;
+}
+
+bool two_sum_hash(const int *nums, int count, int target, int out[2]){
+    unsigned int mask;
+    PairSumSlot *slots = table_new(count, &mask);
+    if (slots == NULL){
+        return false;
+    }
+
+    // look for the complement among the items before i, then add item i;
+    // keeping the first index of each value gives the smallest pair
+    bool found = false;
+    for (int i = 0; i < count && !found; i++){
+        int j = table_find(slots, mask, (long long)target - nums[i]);
+        if (j != -1){
+            out[0] = j;
+            out[1] = i;
+            found = true;
+        }else{
+            table_put(slots, mask, nums[i], i, false);
+        }
+    }
+    free(slots);
+    return found;
+}
+
+bool two_sum_sorted(const int *sorted, int count, int target, int out[2]){
+    int low = 0;
+    int high = count - 1;
+    while (low < high){
+        long long sum = (long long)sorted[low] + sorted[high];
+        if (sum == target){
+            out[0] = low;
+            out[1] = high;
+            return true;
+        }
+        if (sum < target){
+            low++;
+        }else{
+            high--;
+        }
+    }
+    return false;
+}
+
+static int compare_packed(const void *a, const void *b){
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+bool two_sum_sort(const int *nums, int count, int target, int out[2], long long *scratch){
+    // value in the high half, index in the low half: sorting the 64-bit
+    // keys sorts by value and keeps the indices alongside
+    for (int i = 0; i < count; i++){
+        scratch[i] = (long long)((unsigned long long)(long long)nums[i] << 32) | (unsigned int)i;
+    }
+    qsort(scratch, count, sizeof(long long), compare_packed);
+
+    int low = 0;
+    int high = count - 1;
+    while (low < high){
+        long long sum = (long long)(int)(scratch[low] >> 32) + (int)(scratch[high] >> 32);
+        if (sum == target){
+            int a = (int)(scratch[low] & 0xFFFFFFFF);
+            int b = (int)(scratch[high] & 0xFFFFFFFF);
+            out[0] = a < b ? a : b;
+            out[1] = a < b ? b : a;
+            return true;
+        }
+        if (sum < target){
+            low++;
+        }else{
+            high--;
+        }
+    }
+    return false;
+}
+
+bool k_sum_sorted(const int *sorted, int count, int k, long long target, int *out){
+    if (k < 2){
+        for (int i = 0; i < count && k == 1; i++){
+            if (sorted[i] == target){
+                out[0] = i;
+                return true;
+            }
+        }
+        return false;
+    }
+    if (k == 2){
+        int low = 0;
+        int high = count - 1;
+        while (low < high){
+            long long sum = (long long)sorted[low] + sorted[high];
+            if (sum == target){
+                out[0] = low;
+                out[1] = high;
+                return true;
+            }
+            if (sum < target){
+                low++;
+            }else{
+                high--;
+            }
+        }
+        return false;
+    }
+
+    for (int i = 0; i + k <= count; i++){
+        if (i > 0 && sorted[i] == sorted[i - 1]){
+            continue; // same first item, same answer as before
+        }
+        if (k_sum_sorted(sorted + i + 1, count - i - 1, k - 1, target - sorted[i], out + 1)){
+            out[0] = i;
+            for (int j = 1; j < k; j++){
+                out[j] += i + 1;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+//=========== index ===================================
+
+// the table keeps the last index of each value, so for item i a match at
+// j > i means a pair exists, and the first such i is the smallest pair
+bool pair_sum_index_build(PairSumIndex *index, const int *nums, int count){
+    index->slots = table_new(count, &index->mask);
+    if (index->slots == NULL){
+        return false;
+    }
+    index->nums = nums;
+    index->count = count;
+    for (int i = 0; i < count; i++){
+        table_put(index->slots, index->mask, nums[i], i, true);
+    }
+    return true;
+}
+
+void pair_sum_index_destroy(PairSumIndex *index){
+    free(index->slots);
+    index->slots = NULL;
+}
+
+bool pair_sum_query(const PairSumIndex *index, int target, int out[2]){
+    for (int i = 0; i < index->count; i++){
+        int j = table_find(index->slots, index->mask, (long long)target - index->nums[i]);
+        if (j > i){
+            out[0] = i;
+            out[1] = j;
+            return true;
+        }
+    }
+    return false;
+}
+
+int pair_sum_query_many(const PairSumIndex *index, const int *targets, int target_count, int (*out)[2]){
+    int found = 0;
+    for (int first = 0; first < target_count; first += PAIR_SUM_BATCH){
+        int batch = target_count - first < PAIR_SUM_BATCH ? target_count - first : PAIR_SUM_BATCH;
+        int active[PAIR_SUM_BATCH]; // targets of this batch still unanswered
+        int active_count = batch;
+        for (int t = 0; t < batch; t++){
+            active[t] = first + t;
+            out[first + t][0] = -1;
+            out[first + t][1] = -1;
+        }
+
+        for (int i = 0; i < index->count && active_count > 0; i++){
+            long long item = index->nums[i];
+            // touch every target's slot first so the misses overlap
+            for (int a = 0; a < active_count; a++){
+                long long key = targets[active[a]] - item;
+                __builtin_prefetch(&index->slots[hash_int((int)key, index->mask)]);
+            }
+            for (int a = 0; a < active_count; a++){
+                int t = active[a];
+                int j = table_find(index->slots, index->mask, targets[t] - item);
+                if (j > i){
+                    out[t][0] = i;
+                    out[t][1] = j;
+                    found++;
+                    active[a--] = active[--active_count];
+                }
+            }
+        }
+    }
+    return found;
+}
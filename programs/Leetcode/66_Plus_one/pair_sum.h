@@ -0,0 +1,55 @@
+#ifndef PAIR_SUM_H
+#define PAIR_SUM_H
+
+#include <stdbool.h>
+
+/* Pair-sum (twoSum) queries without twoSum's O(n^2) scan or its malloc
+per call. Every function writes its answer into the caller's out[] and
+returns whether a pair was found.
+
+- two_sum_hash: one pass with an open-addressed value -> index table,
+  O(n). Indices refer to nums.
+- two_sum_sorted: two pointers over input that is already sorted
+  ascending, O(n) and no extra memory. Indices refer to sorted.
+- two_sum_sort: sorts (value, index) pairs in the caller's scratch
+  buffer, then two pointers, O(n log n). Indices refer to nums.
+- PairSumIndex: builds the table once for an array and answers many
+  targets against it; pair_sum_query_many runs a batch of targets in
+  one pass over nums.
+- k_sum_sorted: k items of a sorted array that sum to target,
+  O(n^(k-1)), by fixing one item and recursing down to two pointers.
+
+When several pairs exist, two_sum_hash returns the one that completes
+first (smallest second index) and the PairSumIndex queries return the
+one with the smallest first index, like twoSum. out[0] < out[1] always
+holds, and sums are exact (no int overflow). */
+
+typedef struct PairSumSlot{
+    int key;
+    int index; // -1 marks an empty slot
+}PairSumSlot;
+
+typedef struct PairSumIndex{
+    const int *nums; // not copied, must outlive the index
+    int count;
+    PairSumSlot *slots;
+    unsigned int mask; // slot count - 1, a power of two
+}PairSumIndex;
+
+//Prototypes
+bool two_sum_hash(const int *nums, int count, int target, int out[2]);
+bool two_sum_sorted(const int *sorted, int count, int target, int out[2]);
+// scratch must hold count long longs
+bool two_sum_sort(const int *nums, int count, int target, int out[2], long long *scratch);
+bool k_sum_sorted(const int *sorted, int count, int k, long long target, int *out);
+
+// returns false if out of memory
+bool pair_sum_index_build(PairSumIndex *index, const int *nums, int count);
+void pair_sum_index_destroy(PairSumIndex *index);
+bool pair_sum_query(const PairSumIndex *index, int target, int out[2]);
+// out[t] is the pair for targets[t], or {-1, -1}; returns how many were found
+int pair_sum_query_many(const PairSumIndex *index, const int *targets, int target_count, int (*out)[2]);
+
+
+
+#endif
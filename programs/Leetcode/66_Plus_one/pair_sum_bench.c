@@ -0,0 +1,184 @@
+#define PAIR_SUM_BENCH
+#define _POSIX_C_SOURCE 199309L
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include "main.c"
+#include "pair_sum.h"
+
+/* Checks the pair_sum.c variants against twoSum, then times them for
+n = 10K to 10M on a worst case: the only pair is the last two items.
+
+    gcc -O2 pair_sum_bench.c pair_sum.c -o pair_sum_bench
+    ./pair_sum_bench */
+
+#define MAX_ITEMS 10000000
+#define NAIVE_MAX_ITEMS 100000 // twoSum is O(n^2), skip it past this
+#define BATCH_TARGETS 16
+
+static double now_ms(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// distinct even values in random order, then 1 and target - 1; every
+// other pair sums to an even number or to less than target
+static int fill_worst_case(int *nums, int count){
+    for (int i = 0; i < count - 2; i++){
+        nums[i] = 2 * i;
+    }
+    for (int i = count - 3; i > 0; i--){
+        int j = rand() % (i + 1);
+        int swap = nums[i];
+        nums[i] = nums[j];
+        nums[j] = swap;
+    }
+    int target = 4 * count + 1;
+    nums[count - 2] = 1;
+    nums[count - 1] = target - 1;
+    return target;
+}
+
+static int compare_ints(const void *a, const void *b){
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static void check_small(){
+    int nums[200];
+    long long scratch[200];
+    for (int round = 0; round < 2000; round++){
+        int count = 2 + rand() % 199;
+        for (int i = 0; i < count; i++){
+            nums[i] = rand() % 41 - 20;
+        }
+        int target = rand() % 61 - 30;
+
+        int expected_size;
+        int *expected = twoSum(nums, count, target, &expected_size);
+        int out[2];
+
+        bool found = two_sum_hash(nums, count, target, out);
+        assert(found == (expected_size == 2));
+        assert(!found || (out[0] < out[1] && nums[out[0]] + nums[out[1]] == target));
+
+        found = two_sum_sort(nums, count, target, out, scratch);
+        assert(found == (expected_size == 2));
+        assert(!found || (out[0] < out[1] && nums[out[0]] + nums[out[1]] == target));
+
+        // the index finds the same first item as twoSum
+        PairSumIndex index;
+        assert(pair_sum_index_build(&index, nums, count));
+        found = pair_sum_query(&index, target, out);
+        assert(found == (expected_size == 2));
+        assert(!found || (out[0] == expected[0] && out[1] > out[0] && nums[out[0]] + nums[out[1]] == target));
+
+        int targets[20];
+        int results[20][2];
+        for (int t = 0; t < 20; t++){
+            targets[t] = rand() % 61 - 30;
+        }
+        int hits = pair_sum_query_many(&index, targets, 20, results);
+        for (int t = 0; t < 20; t++){
+            hits -= pair_sum_query(&index, targets[t], out);
+            assert(results[t][0] == -1 || (results[t][0] == out[0] && results[t][1] == out[1]));
+        }
+        assert(hits == 0);
+        pair_sum_index_destroy(&index);
+        free(expected);
+
+        qsort(nums, count, sizeof(int), compare_ints);
+        found = two_sum_sorted(nums, count, target, out);
+        assert(found == (expected_size == 2));
+        int triple[3];
+        if (k_sum_sorted(nums, count, 3, target, triple)){
+            assert(triple[0] < triple[1] && triple[1] < triple[2]);
+            assert(nums[triple[0]] + nums[triple[1]] + nums[triple[2]] == target);
+        }
+    }
+    int extremes[] = {2147483647, 5, -2147483647 - 1, -1};
+    int out[2];
+    assert(!two_sum_hash(extremes, 4, -2147483647 - 1 + 4, out)); // 2147483647 + 5 would wrap to this
+    assert(two_sum_hash(extremes, 4, 2147483646, out) && out[0] == 0 && out[1] == 3);
+}
+
+int main(){
+    check_small();
+    printf("All variants agree with twoSum.\n\n");
+
+    int *nums = malloc(sizeof(int) * MAX_ITEMS);
+    int *sorted = malloc(sizeof(int) * MAX_ITEMS);
+    long long *scratch = malloc(sizeof(long long) * MAX_ITEMS);
+    assert(nums != NULL && sorted != NULL && scratch != NULL);
+
+    printf("%10s %12s %10s %10s %12s %11s %13s %13s\n", "n", "twoSum ms", "hash ms", "sort ms", "presorted ms",
+           "index ms", "query x16 ms", "batch x16 ms");
+    for (int count = 10000; count <= MAX_ITEMS; count *= 10){
+        int target = fill_worst_case(nums, count);
+        int out[2];
+        double start, naive_ms = -1;
+
+        if (count <= NAIVE_MAX_ITEMS){
+            int size;
+            start = now_ms();
+            int *result = twoSum(nums, count, target, &size);
+            naive_ms = now_ms() - start;
+            assert(size == 2 && result[1] == count - 1);
+            free(result);
+        }
+
+        start = now_ms();
+        assert(two_sum_hash(nums, count, target, out) && out[1] == count - 1);
+        double hash_ms = now_ms() - start;
+
+        start = now_ms();
+        assert(two_sum_sort(nums, count, target, out, scratch) && out[1] == count - 1);
+        double sort_ms = now_ms() - start;
+
+        memcpy(sorted, nums, sizeof(int) * count);
+        qsort(sorted, count, sizeof(int), compare_ints);
+        // the planted pair sits at both ends once sorted, so time a target
+        // with no pair, which scans everything
+        start = now_ms();
+        assert(two_sum_sorted(sorted, count, target, out));
+        assert(!two_sum_sorted(sorted, count, target + 2, out));
+        double presorted_ms = now_ms() - start;
+
+        PairSumIndex index;
+        start = now_ms();
+        assert(pair_sum_index_build(&index, nums, count));
+        double index_ms = now_ms() - start;
+
+        // all targets but the first have no pair, so each scans all of nums
+        int targets[BATCH_TARGETS];
+        int results[BATCH_TARGETS][2];
+        for (int t = 0; t < BATCH_TARGETS; t++){
+            targets[t] = target + 2 * t;
+        }
+        start = now_ms();
+        int found = 0;
+        for (int t = 0; t < BATCH_TARGETS; t++){
+            found += pair_sum_query(&index, targets[t], results[t]);
+        }
+        double query_ms = now_ms() - start;
+        start = now_ms();
+        assert(pair_sum_query_many(&index, targets, BATCH_TARGETS, results) == found);
+        double batch_ms = now_ms() - start;
+        pair_sum_index_destroy(&index);
+
+        if (naive_ms >= 0){
+            printf("%10d %12.2f", count, naive_ms);
+        }else{
+            printf("%10d %12s", count, "-");
+        }
+        printf(" %10.2f %10.2f %12.3f %11.2f %13.2f %13.2f\n", hash_ms, sort_ms, presorted_ms, index_ms, query_ms,
+               batch_ms);
+    }
+
+    free(nums);
+    free(sorted);
+    free(scratch);
+    return 0;
+}
@@ -1,28 +1,23 @@
 #include <stdio.h>
+#include <stdint.h>
 #include <string.h>
 
 
-int main(void){
-
-
-
-
-    int temp = 12345;
-    char* string1 = temp;
-
-    
-    int number = temp;
+// Swaps at most one pair of digits to make num as large as possible.
+// O(d^2) in the number of digits; maximum_swap in maximum_swap.c is the
+// one pass version. num must be below 10^19.
+uint64_t maximumSwap(uint64_t num){
+    int myArray[20];
+    uint64_t temp = num;
     int counter = 0;
-    while(temp > 0){
+    do{
         temp /= 10;
         counter++;
-    }
-
-    int myArray[counter];
+    }while(temp > 0);
 
     int temp_counter = counter-1;
-
-    while(number>0){
+    uint64_t number = num;
+    while(temp_counter >= 0){
         int digit = number % 10;
         myArray[temp_counter] = digit;
         number /= 10;
@@ -33,10 +28,11 @@ int main(void){
 
     for(int i = 0; i< counter; i++){
         int largest = 0;
-        int largest_index;
+        int largest_index = i;
         for (int j = i+1; j< counter; j++){
             
-            if (myArray[j]>largest){
+            // >= so ties pick the last copy: 1993 -> 9913, not 9193
+            if (myArray[j]>=largest){
                 largest = myArray[j];
                 largest_index = j;
             }
@@ -52,17 +48,19 @@ int main(void){
             }
     }
 
-    int final_number = 0;
+    uint64_t final_number = 0;
 
     for (int i = 0; i< counter; i++){
         final_number = final_number * 10 + myArray[i];
     }
+    return final_number;
+}
 
-    printf("%d\n", final_number);
-
-
-
-
-
-
-}
\ No newline at end of file
+#ifndef MAXIMUM_SWAP_BENCH
+int main(void){
+    printf("%llu\n", (unsigned long long)maximumSwap(12345)); // Expecting 52341
+    printf("%llu\n", (unsigned long long)maximumSwap(1993)); // Expecting 9913
+    printf("%llu\n", (unsigned long long)maximumSwap(9973)); // Expecting 9973
+    return 0;
+}
+#endif
@@ -1,18 +1,16 @@
 #include <stdio.h>
 
-int main() {
-
-    int input[] = {0, 0, 1, 1, 1, 2, 2, 3, 3, 4};
-    int size = 10;
+// Remove Duplicates from Sorted Array (26), kept here with its notes in
+// ../26. Remove Dupes from Sorted Array. The SIMD version is unique_sorted
+// in that directory.
+int removeDuplicates(int* nums, int numsSize){
+    if (numsSize == 0){
+        return 0;
+    }
     int counter = 1;
 
-
-
-
-
-
     //left only shifts when a new element is detected
-    for(int *leftPtr=&input[1], *rightPtr = &input[1]; rightPtr<&input[size]; rightPtr++){
+    for(int *leftPtr=&nums[1], *rightPtr = &nums[1]; rightPtr<&nums[numsSize]; rightPtr++){
         if(*rightPtr != *(rightPtr-1)){
             *leftPtr = *rightPtr;
             leftPtr++;
@@ -20,14 +18,25 @@ int main() {
         }
 
     }
+    return counter;
+}
+
+#ifndef UNIQUE_BENCH
+int main() {
+
+    int input[] = {0, 0, 1, 1, 1, 2, 2, 3, 3, 4};
+    int size = 10;
+
+    int counter = removeDuplicates(input, size);
     
     printf("[");
     for(int i = 0; i<size; i++){
         printf("%d, ", input[i]);
     }
-    printf("]");
+    printf("]\n%d\n", counter);
 
 
 
     return 0;
 }
+#endif
@@ -0,0 +1,123 @@
+#include "maximum_swap.h"
+#include <string.h>
+#include <emmintrin.h>
+
+// digit_pairs[n] holds the two digits of n as bytes, ones digit first,
+// so one 16-bit store writes both
+#define PAIR(n) ((n) % 10 | (n) / 10 << 8)
+#define PAIR_ROW(t) PAIR(t##0), PAIR(t##1), PAIR(t##2), PAIR(t##3), PAIR(t##4), \
+                    PAIR(t##5), PAIR(t##6), PAIR(t##7), PAIR(t##8), PAIR(t##9)
+static const uint16_t digit_pairs[100] = {
+    PAIR(0), PAIR(1), PAIR(2), PAIR(3), PAIR(4), PAIR(5), PAIR(6), PAIR(7), PAIR(8), PAIR(9),
+    PAIR_ROW(1), PAIR_ROW(2), PAIR_ROW(3), PAIR_ROW(4),
+    PAIR_ROW(5), PAIR_ROW(6), PAIR_ROW(7), PAIR_ROW(8), PAIR_ROW(9),
+};
+
+static const uint64_t powers_of_ten[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+    1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL, 10000000000000000000ULL,
+};
+
+// x < 10^4. x * 5243 >> 19 is x / 100 for every x below 43699.
+static inline void write_four(uint8_t *out, uint32_t x){
+    uint32_t high = (x * 5243) >> 19;
+    uint32_t low = x - high * 100;
+    memcpy(out, &digit_pairs[low], 2);
+    memcpy(out + 2, &digit_pairs[high], 2);
+}
+
+// x < 10^8. 109951163 is 2^40 / 10^4 rounded up, exact for this range.
+static inline void write_eight(uint8_t *out, uint32_t x){
+    uint32_t high = (uint32_t)(((uint64_t)x * 109951163) >> 40);
+    write_four(out, x - high * 10000);
+    write_four(out + 4, high);
+}
+
+// Number of decimal digits, without a loop: the bit length gives the
+// count to within one (1233 / 4096 is about log10(2)), and one compare
+// against a power of ten settles it. guess is at most 19; it is 0 only
+// below 8, which is always one digit (zero included).
+static int decimal_length(uint64_t number){
+    int bits = 64 - __builtin_clzll(number | 1);
+    int guess = (bits * 1233) >> 12;
+    return guess + 1 - (guess > 0 && number < powers_of_ten[guess]);
+}
+
+// Always writes all 24 digit slots (leading zeros included) so they can
+// be loaded as whole vectors. gcc turns the 64-bit / 10^8 into a
+// multiply too.
+static void write_digits(uint64_t number, uint8_t *digits){
+    uint64_t middle = number / 100000000;
+    uint64_t top = middle / 100000000;
+    write_eight(digits, (uint32_t)(number - middle * 100000000));
+    write_eight(digits + 8, (uint32_t)(middle - top * 100000000));
+    write_eight(digits + 16, (uint32_t)top);
+}
+
+int digits_low_first(uint64_t number, uint8_t *digits){
+    write_digits(number, digits);
+    return decimal_length(number);
+}
+
+// inclusive running max from byte 0 up
+static inline __m128i running_max(__m128i v){
+    v = _mm_max_epu8(v, _mm_slli_si128(v, 1));
+    v = _mm_max_epu8(v, _mm_slli_si128(v, 2));
+    v = _mm_max_epu8(v, _mm_slli_si128(v, 4));
+    v = _mm_max_epu8(v, _mm_slli_si128(v, 8));
+    return v;
+}
+
+/* The best swap takes the most significant digit that has a larger digit
+somewhere below it, and swaps it with the largest digit below it (the
+lowest copy on ties, which gives the larger result).
+
+Looping over the digits with that rule is one pass, but with random
+input every comparison and the loop length mispredict. Instead the 20
+digit slots go in two SSE2 registers (SSE2 is part of x86-64), a
+running max gives "largest digit below" for every slot at once, and
+movemask plus clz/ctz pick the two positions. The swap is then applied
+arithmetically: the intermediate sum can wrap, but unsigned wrapping is
+defined and the result fits. */
+uint64_t maximum_swap(uint64_t number){
+    _Alignas(16) uint8_t digits[32];
+    write_digits(number, digits);
+    memset(digits + 24, 0, 8);
+    int count = decimal_length(number);
+
+    __m128i low_digits = _mm_load_si128((const __m128i *)digits);
+    __m128i high_digits = _mm_load_si128((const __m128i *)(digits + 16));
+    // below[i] = max(digits[0 .. i-1]); the high half starts from the
+    // max of the whole low half
+    __m128i low_max = running_max(_mm_slli_si128(low_digits, 1));
+    __m128i carry = _mm_srli_si128(_mm_max_epu8(low_max, low_digits), 15);
+    __m128i high_max = running_max(_mm_or_si128(_mm_slli_si128(high_digits, 1), carry));
+
+    unsigned int candidates = _mm_movemask_epi8(_mm_cmplt_epi8(low_digits, low_max)) |
+                              (unsigned int)_mm_movemask_epi8(_mm_cmplt_epi8(high_digits, high_max)) << 16;
+    candidates &= (1u << count) - 1; // leading zeros are not digits
+    if (candidates == 0){
+        return number;
+    }
+    int high = 31 - __builtin_clz(candidates);
+
+    _Alignas(16) uint8_t below[32];
+    _mm_store_si128((__m128i *)below, low_max);
+    _mm_store_si128((__m128i *)(below + 16), high_max);
+    __m128i wanted = _mm_set1_epi8(below[high]);
+    unsigned int copies = _mm_movemask_epi8(_mm_cmpeq_epi8(low_digits, wanted)) |
+                          (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(high_digits, wanted)) << 16;
+    int low = __builtin_ctz(copies & ((1u << high) - 1));
+
+    uint64_t delta = below[high] - digits[high];
+    return number + delta * powers_of_ten[high] - delta * powers_of_ten[low];
+}
+
+void maximum_swap_many(const uint64_t *numbers, uint64_t *results, size_t count){
+    for (size_t i = 0; i < count; i++){
+        results[i] = maximum_swap(numbers[i]);
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef MAXIMUM_SWAP_H
+#define MAXIMUM_SWAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Maximum Swap (670) in one pass over the digits, for numbers up to
+10^19 - 1 (every non-negative int64_t). The result of swapping digits in
+a 19 digit number can be larger than INT64_MAX, so it is uint64_t.
+
+Digits come out two at a time from a 00..99 table, with the divisions by
+10^8, 10^4 and 10^2 done as multiplies by a reciprocal instead of a % 10
+and / 10 per digit. The swap positions are then found with SSE2 compares
+over all digits at once. maximum_swap_many is the same over an array. */
+
+//Prototypes
+uint64_t maximum_swap(uint64_t number);
+void maximum_swap_many(const uint64_t *numbers, uint64_t *results, size_t count);
+// Writes the digits of number least significant first into all 24 slots
+// of digits, leading zeros included, and returns the digit count (1 for
+// zero).
+int digits_low_first(uint64_t number, uint8_t *digits);
+
+
+
+#endif
@@ -0,0 +1,172 @@
+#define MAXIMUM_SWAP_BENCH
+#define _POSIX_C_SOURCE 199309L
+#include <stdlib.h>
+#include <time.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "main.c"
+#include "maximum_swap.h"
+
+/* Checks maximum_swap against maximumSwap in main.c and an exhaustive
+try-every-swap search on random inputs, then times them.
+
+    gcc -O2 maximum_swap_bench.c maximum_swap.c -o maximum_swap_bench
+    ./maximum_swap_bench */
+
+#define CHECKED_NUMBERS 1000000
+#define TIMED_NUMBERS 10000000
+
+static double now_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t next_random(){
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// 1 to 19 digits drawn from a random small alphabet, so repeated digits
+// (the tie case) are common
+static uint64_t random_number(){
+    int length = 1 + next_random() % 19;
+    int alphabet = 2 + next_random() % 9;
+    uint64_t number = 1 + next_random() % 9;
+    for (int i = 1; i < length; i++){
+        number = number * 10 + (9 - next_random() % alphabet);
+    }
+    return number;
+}
+
+static uint64_t brute_force(uint64_t number){
+    uint8_t digits[24];
+    int count = digits_low_first(number, digits);
+    uint64_t best = number;
+    for (int i = 0; i < count; i++){
+        for (int j = i + 1; j < count; j++){
+            uint8_t swapped[24];
+            memcpy(swapped, digits, sizeof(swapped));
+            swapped[i] = digits[j];
+            swapped[j] = digits[i];
+            uint64_t value = 0;
+            for (int k = count - 1; k >= 0; k--){
+                value = value * 10 + swapped[k];
+            }
+            if (value > best){
+                best = value;
+            }
+        }
+    }
+    return best;
+}
+
+// the same one pass, with a % 10 and / 10 per digit
+static uint64_t maximum_swap_divide(uint64_t number){
+    uint8_t digits[20];
+    int count = 0;
+    uint64_t temp = number;
+    do{
+        digits[count++] = temp % 10;
+        temp /= 10;
+    }while (temp > 0);
+
+    uint64_t power = 1;
+    uint64_t powers[20];
+    for (int i = 0; i < count; i++){
+        powers[i] = power;
+        power *= 10;
+    }
+    int max_position = 0;
+    int low = -1;
+    int high = -1;
+    for (int i = 1; i < count; i++){
+        if (digits[i] > digits[max_position]){
+            max_position = i;
+        }else if (digits[i] < digits[max_position]){
+            high = i;
+            low = max_position;
+        }
+    }
+    if (high < 0){
+        return number;
+    }
+    uint64_t delta = digits[low] - digits[high];
+    return number + delta * powers[high] - delta * powers[low];
+}
+
+static volatile uint64_t sink;
+
+// digits_low_first's count, checked against printf
+static bool digit_count_matches(uint64_t number){
+    uint8_t digits[24];
+    char text[24];
+    return digits_low_first(number, digits) == snprintf(text, sizeof(text), "%llu", (unsigned long long)number);
+}
+
+int main(){
+    uint64_t edges[] = {0, 9, 10, 98, 99999999, 100000000, 1234567890123456789ULL,
+                        9999999999999999999ULL, 1000000000000000000ULL, 9223372036854775807ULL};
+    for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++){
+        assert(maximum_swap(edges[i]) == brute_force(edges[i]));
+        assert(maximum_swap(edges[i]) == maximumSwap(edges[i]));
+        assert(digit_count_matches(edges[i]));
+    }
+    for (uint64_t power = 1; power <= 1000000000000000000ULL; power *= 10){
+        assert(digit_count_matches(power - 1) && digit_count_matches(power));
+    }
+    for (int i = 0; i < CHECKED_NUMBERS; i++){
+        uint64_t number = i % 2 ? random_number() : next_random() % 10000000000000000000ULL;
+        uint64_t expected = brute_force(number);
+        assert(maximum_swap(number) == expected);
+        assert(maximumSwap(number) == expected);
+        assert(maximum_swap_divide(number) == expected);
+        assert(digit_count_matches(number));
+    }
+    printf("%d random inputs agree with maximumSwap and brute force\n", CHECKED_NUMBERS);
+
+    uint64_t *numbers = malloc(sizeof(uint64_t) * TIMED_NUMBERS);
+    uint64_t *results = malloc(sizeof(uint64_t) * TIMED_NUMBERS);
+    for (int i = 0; i < TIMED_NUMBERS; i++){
+        numbers[i] = random_number();
+    }
+
+    uint64_t checksum = 0;
+    double start = now_ns();
+    for (int i = 0; i < TIMED_NUMBERS; i++){
+        checksum += maximumSwap(numbers[i]);
+    }
+    double quadratic = (now_ns() - start) / TIMED_NUMBERS;
+
+    start = now_ns();
+    for (int i = 0; i < TIMED_NUMBERS; i++){
+        checksum += maximum_swap_divide(numbers[i]);
+    }
+    double divide = (now_ns() - start) / TIMED_NUMBERS;
+
+    start = now_ns();
+    for (int i = 0; i < TIMED_NUMBERS; i++){
+        checksum += maximum_swap(numbers[i]);
+    }
+    double single = (now_ns() - start) / TIMED_NUMBERS;
+
+    start = now_ns();
+    maximum_swap_many(numbers, results, TIMED_NUMBERS);
+    double batched = (now_ns() - start) / TIMED_NUMBERS;
+    checksum += results[TIMED_NUMBERS - 1];
+    sink = checksum;
+
+    printf("%-34s %8s\n", "ns per number (1-19 digits)", "ns");
+    printf("%-34s %8.1f\n", "maximumSwap (O(d^2), % 10)", quadratic);
+    printf("%-34s %8.1f\n", "one pass, % 10 per digit", divide);
+    printf("%-34s %8.1f\n", "maximum_swap (pair table, SSE2)", single);
+    printf("%-34s %8.1f\n", "maximum_swap_many", batched);
+
+    free(numbers);
+    free(results);
+    return 0;
+}
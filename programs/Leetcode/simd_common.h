@@ -0,0 +1,175 @@
+#ifndef SIMD_COMMON_H
+#define SIMD_COMMON_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <immintrin.h>
+
+/* Pieces shared by the in-place compaction kernels (filter.c in
+27-Remove-Elements, unique_sorted.c in 26. Remove Dupes from Sorted
+Array). A compaction kernel keeps some of the items of nums, in order,
+moves them to the front and returns how many it kept:
+
+- the AVX2 left-pack permute table
+- picking the widest kernel the CPU supports, once
+- running a kernel over one chunk per thread and closing the gaps
+
+Include from the .c file only; the table and the helpers are static. */
+
+// below this many items per thread the parallel version is not worth it
+#define SIMD_PARALLEL_MIN_CHUNK (1 << 16)
+
+// arg is whatever the kernel needs besides the items: the value to drop,
+// the item before nums[0], ...
+typedef int (*SimdCompact)(int *nums, int count, int arg);
+
+typedef enum SimdLevel{
+    SIMD_SCALAR,
+    SIMD_AVX2,
+    SIMD_AVX512,
+}SimdLevel;
+
+//=========== AVX2 left-pack ===================================
+
+// simd_left_pack[mask] lists the lanes whose bit is set in mask first, in
+// order, as a _mm256_permutevar8x32_epi32 index. 256 entries * 32 bytes
+// = 8 KB. Call simd_left_pack_init before reading it.
+static _Alignas(32) int simd_left_pack[256][8];
+static pthread_once_t simd_left_pack_once = PTHREAD_ONCE_INIT;
+
+static void simd_build_left_pack(){
+    for (int mask = 0; mask < 256; mask++){
+        int next = 0;
+        for (int lane = 0; lane < 8; lane++){
+            if (mask & (1 << lane)){
+                simd_left_pack[mask][next++] = lane;
+            }
+        }
+        while (next < 8){
+            simd_left_pack[mask][next++] = 0;
+        }
+    }
+}
+
+static inline void simd_left_pack_init(){
+    pthread_once(&simd_left_pack_once, simd_build_left_pack);
+}
+
+//=========== dispatch ===================================
+
+static inline bool simd_level_supported(SimdLevel level){
+    __builtin_cpu_init();
+    switch (level){
+        case SIMD_AVX512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt");
+        case SIMD_AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+        default:
+            return true;
+    }
+}
+
+static inline SimdLevel simd_best_level(){
+    if (simd_level_supported(SIMD_AVX512)){
+        return SIMD_AVX512;
+    }
+    if (simd_level_supported(SIMD_AVX2)){
+        return SIMD_AVX2;
+    }
+    return SIMD_SCALAR;
+}
+
+// The kernel for the widest level this CPU supports. The choice is made
+// on the first call and cached in *selected (start it at NULL).
+static inline SimdCompact simd_select(SimdCompact *selected, SimdCompact scalar,
+                                      SimdCompact avx2, SimdCompact avx512){
+    SimdCompact kernel = __atomic_load_n(selected, __ATOMIC_RELAXED);
+    if (kernel == NULL){
+        switch (simd_best_level()){
+            case SIMD_AVX512: kernel = avx512; break;
+            case SIMD_AVX2: kernel = avx2; break;
+            default: kernel = scalar; break;
+        }
+        __atomic_store_n(selected, kernel, __ATOMIC_RELAXED);
+    }
+    return kernel;
+}
+
+//=========== parallel ===================================
+
+// arg for the kernel on the chunk that starts at nums + start. Called for
+// every chunk before any thread runs, so it sees the input unchanged.
+typedef int (*SimdChunkArg)(const int *nums, int start, int context);
+
+typedef struct SimdChunk{
+    SimdCompact kernel;
+    int *nums;
+    int count;
+    int arg;
+    int kept;
+    pthread_t thread;
+    bool started; // false if the thread could not be created
+}SimdChunk;
+
+static void* simd_run_chunk(void *arg){
+    SimdChunk *chunk = arg;
+    chunk->kept = chunk->kernel(chunk->nums, chunk->count, chunk->arg);
+    return NULL;
+}
+
+// Runs kernel over nums[first..count) and returns first + the number
+// kept; the first items are kept as they are. With enough items it
+// splits the range into one chunk per thread, compacts the chunks in
+// parallel, then slides each chunk's survivors down against the previous
+// ones. Otherwise (or if the chunk list can't be allocated) it runs
+// kernel once on this thread.
+static inline int simd_parallel_compact(int *nums, int count, int first, int threads,
+                                        SimdCompact kernel, SimdChunkArg chunk_arg, int context){
+    if (count <= first){
+        return count;
+    }
+    if (threads > count / SIMD_PARALLEL_MIN_CHUNK){
+        threads = count / SIMD_PARALLEL_MIN_CHUNK;
+    }
+    SimdChunk *chunks = threads > 1 ? malloc(sizeof(SimdChunk) * threads) : NULL;
+    if (chunks == NULL){
+        return first + kernel(nums + first, count - first, chunk_arg(nums, first, context));
+    }
+
+    // chunk starts after the first are multiples of 16 ints, so no two
+    // threads share a cache line
+    int per_thread = (count / threads) & ~15;
+    for (int t = 0; t < threads; t++){
+        int start = t == 0 ? first : t * per_thread;
+        int end = t == threads - 1 ? count : (t + 1) * per_thread;
+        chunks[t].kernel = kernel;
+        chunks[t].nums = nums + start;
+        chunks[t].count = end - start;
+        chunks[t].arg = chunk_arg(nums, start, context);
+    }
+    // a chunk whose thread can't be created runs on this thread instead;
+    // chunks only write inside themselves, so the order doesn't matter
+    for (int t = 1; t < threads; t++){
+        chunks[t].started = pthread_create(&chunks[t].thread, NULL, simd_run_chunk, &chunks[t]) == 0;
+    }
+    simd_run_chunk(&chunks[0]);
+    for (int t = 1; t < threads; t++){
+        if (chunks[t].started){
+            pthread_join(chunks[t].thread, NULL);
+        }else{
+            simd_run_chunk(&chunks[t]);
+        }
+    }
+
+    int kept = first + chunks[0].kept;
+    for (int t = 1; t < threads; t++){
+        memmove(nums + kept, chunks[t].nums, sizeof(int) * chunks[t].kept);
+        kept += chunks[t].kept;
+    }
+    free(chunks);
+    return kept;
+}
+
+#endif
@@ -0,0 +1,161 @@
+#include "allocator.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+//=========== tracking allocator ===================================
+
+static bool tracking_should_fail(TrackingAllocator *tracker){
+    if (tracker->fail_after >= 0 && tracker->allocations >= (size_t)tracker->fail_after){
+        tracker->failures++;
+        return true;
+    }
+    return false;
+}
+
+static void tracking_add_live(TrackingAllocator *tracker, size_t added, size_t removed){
+    tracker->bytes_live += added;
+    tracker->bytes_live -= removed;
+    if (tracker->bytes_live > tracker->peak_bytes){
+        tracker->peak_bytes = tracker->bytes_live;
+    }
+}
+
+static void* tracking_allocate(void *state, size_t size){
+    TrackingAllocator *tracker = state;
+    if (tracking_should_fail(tracker)){
+        return NULL;
+    }
+    void *ptr = allocator_allocate(tracker->parent, size);
+    if (ptr == NULL){
+        tracker->failures++;
+        return NULL;
+    }
+    tracker->allocations++;
+    tracking_add_live(tracker, size, 0);
+    return ptr;
+}
+
+static void* tracking_reallocate(void *state, void *ptr, size_t old_size, size_t new_size){
+    TrackingAllocator *tracker = state;
+    if (tracking_should_fail(tracker)){
+        return NULL;
+    }
+    void *new_ptr = allocator_reallocate(tracker->parent, ptr, old_size, new_size);
+    if (new_ptr == NULL){
+        tracker->failures++;
+        return NULL;
+    }
+    tracker->allocations++;
+    tracking_add_live(tracker, new_size, old_size);
+    return new_ptr;
+}
+
+static void tracking_release(void *state, void *ptr, size_t size){
+    TrackingAllocator *tracker = state;
+    allocator_release(tracker->parent, ptr, size);
+    tracker->releases++;
+    tracker->bytes_live -= size;
+}
+
+void tracking_allocator_init(TrackingAllocator *tracker, Allocator *parent){
+    tracker->allocator = (Allocator){tracking_allocate, tracking_reallocate, tracking_release, tracker};
+    tracker->parent = parent != NULL ? parent : default_allocator();
+    tracker->bytes_live = 0;
+    tracker->peak_bytes = 0;
+    tracker->allocations = 0;
+    tracker->releases = 0;
+    tracker->failures = 0;
+    tracker->fail_after = -1;
+}
+
+void tracking_allocator_report(TrackingAllocator *tracker, const char *name){
+    printf("{\"type\":\"allocator\",\"name\":\"%s\",\"bytes_live\":%zu,\"peak_bytes\":%zu,"
+           "\"allocations\":%zu,\"releases\":%zu,\"failures\":%zu}\n",
+           name, tracker->bytes_live, tracker->peak_bytes, tracker->allocations,
+           tracker->releases, tracker->failures);
+}
+
+//=========== arena allocator ===================================
+
+#define ARENA_ALIGNMENT 16
+
+static size_t arena_round_up(size_t size){
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+static void* arena_allocate(void *state, size_t size){
+    ArenaAllocator *arena = state;
+    size = arena_round_up(size);
+
+    ArenaBlock *block = arena->block;
+    if (block == NULL || block->capacity - block->used < size){
+        size_t capacity = size > arena->block_size ? size : arena->block_size;
+        ArenaBlock *new_block = allocator_allocate(arena->parent, sizeof(ArenaBlock) + capacity);
+        if (new_block == NULL){
+            return NULL;
+        }
+        new_block->previous = block;
+        new_block->capacity = capacity;
+        new_block->used = 0;
+        arena->block = block = new_block;
+    }
+
+    void *ptr = block->bytes + block->used;
+    block->used += size;
+    arena->last = ptr;
+    return ptr;
+}
+
+// grows or shrinks in place if ptr is the most recent allocation and
+// the block has room, otherwise copies to a new allocation
+static void* arena_reallocate(void *state, void *ptr, size_t old_size, size_t new_size){
+    ArenaAllocator *arena = state;
+    if (ptr == NULL){
+        return arena_allocate(state, new_size);
+    }
+
+    ArenaBlock *block = arena->block;
+    if (ptr == arena->last){
+        size_t offset = (unsigned char *)ptr - block->bytes;
+        if (offset + arena_round_up(new_size) <= block->capacity){
+            block->used = offset + arena_round_up(new_size);
+            return ptr;
+        }
+    }
+
+    void *new_ptr = arena_allocate(state, new_size);
+    if (new_ptr != NULL){
+        memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    }
+    return new_ptr;
+}
+
+static void arena_release(void *state, void *ptr, size_t size){
+    ArenaAllocator *arena = state;
+    (void)size;
+    if (ptr == arena->last){
+        arena->block->used = (unsigned char *)ptr - arena->block->bytes;
+        arena->last = NULL;
+    }
+}
+
+void arena_allocator_init(ArenaAllocator *arena, Allocator *parent, size_t block_size){
+    arena->allocator = (Allocator){arena_allocate, arena_reallocate, arena_release, arena};
+    arena->parent = parent != NULL ? parent : default_allocator();
+    arena->block = NULL;
+    arena->block_size = block_size > 0 ? block_size : 64 * 1024;
+    arena->last = NULL;
+}
+
+void arena_allocator_destroy(ArenaAllocator *arena){
+    ArenaBlock *block = arena->block;
+    while (block != NULL){
+        ArenaBlock *previous = block->previous;
+        allocator_release(arena->parent, block, sizeof(ArenaBlock) + block->capacity);
+        block = previous;
+    }
+    arena->block = NULL;
+    arena->last = NULL;
+}
@@ -0,0 +1,115 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdlib.h>
+
+/* Allocator interface shared by the containers. A container created with
+an Allocator gets and returns all of its memory through it, so an arena,
+a pool or a tracking allocator can be dropped in without touching the
+container. Every call passes the block size, so allocators do not need
+headers to know how big a block is.
+
+Containers report running out of memory with CONTAINER_NO_MEMORY and
+leave themselves unchanged, instead of exiting. */
+
+typedef enum ContainerStatus{
+    CONTAINER_OK = 0,
+    CONTAINER_NO_MEMORY,
+}ContainerStatus;
+
+typedef struct Allocator{
+    void* (*allocate)(void *state, size_t size);
+    // like realloc: on failure returns NULL and leaves ptr alone
+    void* (*reallocate)(void *state, void *ptr, size_t old_size, size_t new_size);
+    void (*release)(void *state, void *ptr, size_t size);
+    void *state;
+}Allocator;
+
+static inline void* allocator_allocate(Allocator *allocator, size_t size){
+    return allocator->allocate(allocator->state, size);
+}
+
+static inline void* allocator_reallocate(Allocator *allocator, void *ptr, size_t old_size, size_t new_size){
+    return allocator->reallocate(allocator->state, ptr, old_size, new_size);
+}
+
+static inline void allocator_release(Allocator *allocator, void *ptr, size_t size){
+    if (ptr != NULL){
+        allocator->release(allocator->state, ptr, size);
+    }
+}
+
+static inline void* malloc_allocate(void *state, size_t size){
+    (void)state;
+    return malloc(size);
+}
+
+static inline void* malloc_reallocate(void *state, void *ptr, size_t old_size, size_t new_size){
+    (void)state;
+    (void)old_size;
+    return realloc(ptr, new_size);
+}
+
+static inline void malloc_release(void *state, void *ptr, size_t size){
+    (void)state;
+    (void)size;
+    free(ptr);
+}
+
+// Plain malloc/realloc/free, used when a container is given no allocator.
+// Containers compare allocators by address (nodes may only move between
+// containers sharing one), so there must be a single default object in
+// the whole program. A static local here would give every translation
+// unit its own copy; a weak definition is merged into one by the linker,
+// and keeps this header usable without linking allocator.c.
+__attribute__((weak)) Allocator default_allocator_instance = {
+    malloc_allocate, malloc_reallocate, malloc_release, NULL
+};
+
+static inline Allocator* default_allocator(void){
+    return &default_allocator_instance;
+}
+
+// Counts what goes through it and forwards to parent. Give containers
+// &tracker->allocator. fail_after >= 0 makes every allocation after that
+// many succeed ones fail, to test out-of-memory paths.
+typedef struct TrackingAllocator{
+    Allocator allocator;
+    Allocator *parent;
+    size_t bytes_live;
+    size_t peak_bytes;
+    size_t allocations; // allocate and reallocate calls that succeeded
+    size_t releases;
+    size_t failures;
+    long fail_after;
+}TrackingAllocator;
+
+// Bump allocator over large blocks taken from parent. release only takes
+// back the most recent allocation; everything else goes at once in
+// arena_allocator_destroy.
+typedef struct ArenaBlock{
+    struct ArenaBlock *previous;
+    size_t capacity;
+    size_t used;
+    _Alignas(16) unsigned char bytes[];
+}ArenaBlock;
+
+typedef struct ArenaAllocator{
+    Allocator allocator;
+    Allocator *parent;
+    ArenaBlock *block;
+    size_t block_size;
+    void *last; // most recent allocation, can grow or shrink in place
+}ArenaAllocator;
+
+//Prototypes (allocator.c)
+void tracking_allocator_init(TrackingAllocator *tracker, Allocator *parent);
+// one JSON object on a line, same shape as the perf-counters report
+void tracking_allocator_report(TrackingAllocator *tracker, const char *name);
+void arena_allocator_init(ArenaAllocator *arena, Allocator *parent, size_t block_size);
+void arena_allocator_destroy(ArenaAllocator *arena);
+
+
+
+#endif
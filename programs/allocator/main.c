@@ -0,0 +1,261 @@
+#define QUEUE_BENCH
+#define LINKED_LIST_BENCH
+#define HASHTABLE_BENCH
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "allocator.h"
+#include "allocator.c"
+#include "../arrays/array.h"
+#include "../arrays/array.c"
+#include "../arrays/heap.h"
+#include "../arrays/heap.c"
+#include "../queues-LL/queues.h"
+#include "../queues-LL/queues.c"
+#include "../queues-array/deque.c"
+#include "../linked-lists/doubly-linked-list.c"
+#include "../linked-lists/unrolled-linked-list.c"
+#include "../linked-lists/skip-list.c"
+#include "../hashtable/main.c"
+#include "../hashtable/sketch.c"
+
+/* Tests for the allocator interface: the tracking allocator balances
+after each container is destroyed, injected allocation failures come
+back as CONTAINER_NO_MEMORY with the container left intact, and JArray
+runs on the arena.
+
+    gcc -O2 main.c -lm -o allocator
+    ./allocator */
+
+static void test_tracking_balances(){
+    TrackingAllocator tracker;
+    tracking_allocator_init(&tracker, NULL);
+
+    JArray *array = jarray_new_with_allocator(1, &tracker.allocator);
+    for (int i = 0; i < 1000; i++){
+        assert(jarray_push(array, i) == CONTAINER_OK);
+    }
+    assert(tracker.bytes_live == sizeof(JArray) + sizeof(int) * jarray_capacity(array));
+    while (!jarray_is_empty(array)){
+        jarray_pop(array);
+    }
+    jarray_destroy(array);
+    assert(tracker.bytes_live == 0);
+    assert(tracker.peak_bytes >= sizeof(int) * 1000);
+
+    Queue *queue = create_queue_with_allocator(&tracker.allocator);
+    size_t before = tracker.allocations;
+    for (int i = 0; i < 10; i++){
+        assert(add(queue, i) == CONTAINER_OK);
+    }
+    assert(tracker.allocations - before == 10); // one node per add
+    destroy_queue(queue);
+    assert(tracker.bytes_live == 0);
+
+    JHeap *heap = heap_new_with_allocator(4, &tracker.allocator);
+    for (int i = 0; i < 100; i++){
+        assert(heap_push(heap, i, 100 - i) == CONTAINER_OK);
+    }
+    heap_destroy(heap);
+    assert(tracker.bytes_live == 0);
+    assert(tracker.failures == 0);
+}
+
+static void test_out_of_memory(){
+    TrackingAllocator tracker;
+    tracking_allocator_init(&tracker, NULL);
+
+    // JArray: the push that needs to grow fails, the contents survive
+    JArray *array = jarray_new_with_allocator(1, &tracker.allocator);
+    tracker.fail_after = tracker.allocations;
+    for (int i = 0; i < jarray_capacity(array); i++){
+        assert(jarray_push(array, i) == CONTAINER_OK);
+    }
+    int size = jarray_size(array);
+    assert(jarray_push(array, -1) == CONTAINER_NO_MEMORY);
+    assert(jarray_insert(array, 0, -1) == CONTAINER_NO_MEMORY);
+    assert(jarray_size(array) == size);
+    for (int i = 0; i < size; i++){
+        assert(jarray_at(array, i) == i);
+    }
+    tracker.fail_after = -1;
+    assert(jarray_push(array, size) == CONTAINER_OK);
+    jarray_destroy(array);
+
+    // creation fails cleanly, including halfway through (a JArray is two
+    // allocations, a JHeap seven)
+    for (long fail_after = 0; fail_after < 7; fail_after++){
+        tracker.fail_after = tracker.allocations + fail_after;
+        JArray *created = jarray_new_with_allocator(4, &tracker.allocator);
+        assert((created == NULL) == (fail_after < 2));
+        if (created != NULL){
+            jarray_destroy(created);
+        }
+        tracker.fail_after = tracker.allocations + fail_after;
+        assert(heap_new_with_allocator(4, &tracker.allocator) == NULL);
+        assert(tracker.bytes_live == 0);
+    }
+    tracker.fail_after = -1;
+
+    Queue *queue = create_queue_with_allocator(&tracker.allocator);
+    add(queue, 1);
+    tracker.fail_after = tracker.allocations;
+    assert(add(queue, 2) == CONTAINER_NO_MEMORY);
+    assert(remove_item(queue) == 1);
+    assert(is_empty(queue));
+    destroy_queue(queue);
+
+    // JRadixHeap: a pop that refills bucket 0 has to move a whole bucket
+    // down; when that needs memory it fails before moving anything
+    tracker.fail_after = -1;
+    JRadixHeap *radix = radix_heap_new_with_allocator(&tracker.allocator);
+    for (int i = 0; i < 200; i++){
+        assert(radix_heap_push(radix, i, i % 2 == 0 ? 1024 : 1536) == CONTAINER_OK);
+    }
+    tracker.fail_after = tracker.allocations;
+    int popped = 0;
+    int id;
+    while (radix_heap_pop(radix, &id) == CONTAINER_OK){
+        popped++;
+    }
+    assert(popped < 200);
+    assert(radix_heap_size(radix) == 200 - popped);
+    tracker.fail_after = -1;
+    bool seen[200] = {false};
+    unsigned int previous = radix->last_popped;
+    for (int i = popped; i < 200; i++){
+        assert(radix_heap_pop(radix, &id) == CONTAINER_OK);
+        assert(!seen[id] && radix->last_popped >= previous);
+        seen[id] = true;
+        previous = radix->last_popped;
+    }
+    assert(radix_heap_size(radix) == 0);
+    radix_heap_destroy(radix);
+
+    Deque *deque = deque_create_with_allocator(DEQUE_MIN_CAPACITY, &tracker.allocator);
+    for (int i = 0; i < DEQUE_MIN_CAPACITY; i++){
+        deque_push_back(deque, i);
+    }
+    tracker.fail_after = tracker.allocations;
+    assert(deque_push_front(deque, -1) == CONTAINER_NO_MEMORY);
+    assert(deque_size(deque) == DEQUE_MIN_CAPACITY && deque_front(deque) == 0);
+    deque_destroy(deque);
+
+    assert(tracker.bytes_live == 0);
+}
+
+// node based containers: a failed node allocation leaves them unchanged
+static void test_out_of_memory_nodes(){
+    TrackingAllocator tracker;
+    tracking_allocator_init(&tracker, NULL);
+
+    DLinkedList *dlist = dlist_create_with_allocator(&tracker.allocator);
+    UnrolledList *ulist = ulist_create_with_allocator(&tracker.allocator);
+    SkipList *skip = skiplist_create_with_allocator(&tracker.allocator);
+    for (int i = 0; i < 100; i++){
+        assert(dlist_push_back(dlist, i) == CONTAINER_OK);
+        assert(ulist_push_back(ulist, i) == CONTAINER_OK);
+        assert(skiplist_insert(skip, i, i) == CONTAINER_OK);
+    }
+    tracker.fail_after = tracker.allocations;
+    assert(dlist_push_front(dlist, -1) == CONTAINER_NO_MEMORY);
+    assert(dlist_insert(dlist, 50, -1) == CONTAINER_NO_MEMORY);
+    assert(skiplist_push_front(skip, -1) == CONTAINER_NO_MEMORY);
+    assert(skiplist_insert(skip, 50, -1) == CONTAINER_NO_MEMORY);
+    // the unrolled list only allocates when the node it lands in is full
+    while (ulist_push_back(ulist, 100) == CONTAINER_OK){
+    }
+    int unrolled_size = ulist_size(ulist);
+    assert(ulist_push_back(ulist, -1) == CONTAINER_NO_MEMORY);
+    assert(ulist_insert(ulist, unrolled_size - 1, -1) == CONTAINER_NO_MEMORY);
+
+    // with concurrent reads on, erase needs room on the retire list first
+    skiplist_enable_concurrent_reads(skip);
+    assert(skiplist_erase(skip, 0) == CONTAINER_NO_MEMORY);
+    assert(skiplist_pop_front(skip) == -1);
+
+    assert(dlist_size(dlist) == 100 && ulist_size(ulist) == unrolled_size && skiplist_size(skip) == 100);
+    for (int i = 0; i < 100; i++){
+        assert(dlist_value_at(dlist, i) == i);
+        assert(ulist_value_at(ulist, i) == i);
+        assert(skiplist_value_at(skip, i) == i);
+    }
+    tracker.fail_after = -1;
+    assert(skiplist_pop_front(skip) == 0);
+    dlist_destroy(dlist);
+    ulist_destroy(ulist);
+    skiplist_destroy(skip);
+    assert(tracker.bytes_live == 0);
+
+    // Hash_Table: an insert is three allocations (entry, key, value), and
+    // failing at any of them gives back the ones already made
+    Hash_Table *hashtable = create_hashtable_with_allocator(16, &tracker.allocator);
+    assert(insert(hashtable, "kept", "old") == CONTAINER_OK);
+    size_t bytes_before = tracker.bytes_live;
+    for (long fail_after = 0; fail_after < 3; fail_after++){
+        tracker.fail_after = tracker.allocations + fail_after;
+        assert(insert(hashtable, "new", "value") == CONTAINER_NO_MEMORY);
+        assert(tracker.bytes_live == bytes_before);
+    }
+    assert(insert(hashtable, "kept", "replaced") == CONTAINER_NO_MEMORY);
+    assert(!hashtable_enable_bloom(hashtable, 100, 0.01));
+    assert(hashtable->count == 1 && get(hashtable, "new") == NULL && hashtable->bloom == NULL);
+    assert(strcmp(get(hashtable, "kept")->value, "old") == 0);
+    tracker.fail_after = -1;
+    assert(hashtable_enable_bloom(hashtable, 100, 0.01));
+    assert(insert(hashtable, "new", "value") == CONTAINER_OK && get(hashtable, "new") != NULL);
+    destroy_hashtable(hashtable);
+
+    for (long fail_after = 0; fail_after < 2; fail_after++){
+        tracker.fail_after = tracker.allocations + fail_after;
+        assert(create_hashtable_with_allocator(16, &tracker.allocator) == NULL);
+        tracker.fail_after = tracker.allocations + fail_after;
+        assert(skiplist_create_with_allocator(&tracker.allocator) == NULL);
+    }
+    tracker.fail_after = tracker.allocations;
+    assert(dlist_create_with_allocator(&tracker.allocator) == NULL);
+    assert(ulist_create_with_allocator(&tracker.allocator) == NULL);
+    assert(tracker.bytes_live == 0);
+}
+
+static void test_arena(){
+    ArenaAllocator arena;
+    arena_allocator_init(&arena, NULL, 4096);
+
+    // the data buffer is the most recent allocation, so it grows in place
+    JArray *array = jarray_new_with_allocator(1, &arena.allocator);
+    int *first_data = array->data;
+    for (int i = 0; i < 200; i++){
+        assert(jarray_push(array, i) == CONTAINER_OK);
+    }
+    assert(array->data == first_data);
+
+    // past the block size it moves to a new block, keeping its contents
+    for (int i = 200; i < 5000; i++){
+        assert(jarray_push(array, i) == CONTAINER_OK);
+    }
+    for (int i = 0; i < 5000; i++){
+        assert(jarray_at(array, i) == i);
+    }
+    jarray_destroy(array);
+    arena_allocator_destroy(&arena);
+}
+
+int main(){
+    test_tracking_balances();
+    test_out_of_memory();
+    test_out_of_memory_nodes();
+    test_arena();
+    printf("Allocator tests passed.\n");
+
+    // same workload as test_tracking_balances, as a machine-readable line
+    TrackingAllocator tracker;
+    tracking_allocator_init(&tracker, NULL);
+    JArray *array = jarray_new_with_allocator(1, &tracker.allocator);
+    for (int i = 0; i < 1000; i++){
+        jarray_push(array, i);
+    }
+    jarray_destroy(array);
+    tracking_allocator_report(&tracker, "jarray_push_1000");
+    return 0;
+}
@@ -1,41 +1,59 @@
 #include <string.h>
+#include "../perf-counters/perf_counters.h"
 // vector implementation
 
 JArray *jarray_new(int capacity) {
+  return jarray_new_with_allocator(capacity, default_allocator());
+}
+
+JArray *jarray_new_with_allocator(int capacity, Allocator *allocator) {
   int true_capacity = jarray_determine_capacity(capacity);
 
-  JArray *arr = malloc(sizeof(JArray));
-  check_address(arr);
+  JArray *arr = allocator_allocate(allocator, sizeof(JArray));
+  if (arr == NULL) {
+    return NULL;
+  }
 
   arr->size = 0;
   arr->capacity = true_capacity;
-  arr->data = (int *)malloc(sizeof(int) * true_capacity);
-  check_address(arr->data);
+  arr->allocator = allocator;
+  arr->data = (int *)allocator_allocate(allocator, sizeof(int) * true_capacity);
+  if (arr->data == NULL) {
+    allocator_release(allocator, arr, sizeof(JArray));
+    return NULL;
+  }
+  PERF_COUNT("jarray.allocations", 1);
 
   return arr;
 }
 
-void jarray_resize_for_size(JArray *arrptr, int candidate_size) {
+ContainerStatus jarray_resize_for_size(JArray *arrptr, int candidate_size) {
   if (arrptr->size < candidate_size) {  // growing
     if (arrptr->size == arrptr->capacity) {
-      jarray_upsize(arrptr);
+      return jarray_upsize(arrptr);
     }
   } else if (arrptr->size > candidate_size) {  // shrinking
     if (arrptr->size < arrptr->capacity / kShrinkFactor) {
       jarray_downsize(arrptr);
     }
   }  // will not be equal, if so, will do nothing
+  return CONTAINER_OK;
 }
 
-void jarray_upsize(JArray *arrptr) {
+ContainerStatus jarray_upsize(JArray *arrptr) {
   int old_capacity = arrptr->capacity;
   int new_capacity = jarray_determine_capacity(old_capacity);
 
-  int *new_data = (int *)realloc(arrptr->data, sizeof(int) * new_capacity);
-  check_address(new_data);
+  int *new_data = (int *)allocator_reallocate(arrptr->allocator, arrptr->data, sizeof(int) * old_capacity,
+                                              sizeof(int) * new_capacity);
+  if (new_data == NULL) {
+    return CONTAINER_NO_MEMORY;
+  }
+  PERF_SAMPLE("jarray.upsize_bytes", sizeof(int) * new_capacity);
 
   arrptr->data = new_data;
   arrptr->capacity = new_capacity;
+  return CONTAINER_OK;
 }
 
 void jarray_downsize(JArray *arrptr) {
@@ -47,8 +65,12 @@ void jarray_downsize(JArray *arrptr) {
   }
 
   if (new_capacity != old_capacity) {
-    int *new_data = (int *)realloc(arrptr->data, sizeof(int) * new_capacity);
-    check_address(new_data);
+    int *new_data = (int *)allocator_reallocate(arrptr->allocator, arrptr->data, sizeof(int) * old_capacity,
+                                                sizeof(int) * new_capacity);
+    if (new_data == NULL) {
+      return;  // keep the larger buffer
+    }
+    PERF_SAMPLE("jarray.downsize_bytes", sizeof(int) * new_capacity);
 
     arrptr->data = new_data;
     arrptr->capacity = new_capacity;
@@ -73,15 +95,18 @@ int jarray_determine_capacity(int capacity) {
 int jarray_size(JArray *arrptr) { return arrptr->size; }
 
 void jarray_destroy(JArray *arrptr) {
-  free(arrptr->data);
-  free(arrptr);
+  allocator_release(arrptr->allocator, arrptr->data, sizeof(int) * arrptr->capacity);
+  allocator_release(arrptr->allocator, arrptr, sizeof(JArray));
 }
 
-void jarray_push(JArray *arrptr, int item) {
-  jarray_resize_for_size(arrptr, arrptr->size + 1);
+ContainerStatus jarray_push(JArray *arrptr, int item) {
+  if (jarray_resize_for_size(arrptr, arrptr->size + 1) != CONTAINER_OK) {
+    return CONTAINER_NO_MEMORY;
+  }
 
   *(arrptr->data + arrptr->size) = item;
   ++(arrptr->size);
+  return CONTAINER_OK;
 }
 
 void jarray_print(JArray *arrptr) {
@@ -110,24 +135,30 @@ int jarray_at(JArray *arrptr, int index) {
   return *(arrptr->data + index);
 }
 
-void jarray_insert(JArray *arrptr, int index, int value) {
+ContainerStatus jarray_insert(JArray *arrptr, int index, int value) {
   if (index < 0 || index > arrptr->size - 1) {
     exit(EXIT_FAILURE);
   }
 
-  jarray_resize_for_size(arrptr, arrptr->size + 1);
+  if (jarray_resize_for_size(arrptr, arrptr->size + 1) != CONTAINER_OK) {
+    return CONTAINER_NO_MEMORY;
+  }
 
+  PERF_REGION_BEGIN(jarray_insert);
   // shift items to the right
   memmove(arrptr->data + index + 1, arrptr->data + index, (arrptr->size - index) * sizeof(int));
+  PERF_SAMPLE("jarray.insert_shifted", arrptr->size - index);
 
   // insert item
   *(arrptr->data + index) = value;
 
   arrptr->size += 1;
+  PERF_REGION_END(jarray_insert);
+  return CONTAINER_OK;
 }
 
-void jarray_prepend(JArray *arrptr, int value) {
-  jarray_insert(arrptr, 0, value);
+ContainerStatus jarray_prepend(JArray *arrptr, int value) {
+  return jarray_insert(arrptr, 0, value);
 }
 
 int jarray_pop(JArray *arrptr) {
@@ -150,7 +181,7 @@ void jarray_delete(JArray *arrptr, int index) {
 
   jarray_resize_for_size(arrptr, arrptr->size - 1);
 
-  memmove(arrptr->data + index, arrptr->data + index + 1, (arrptr->size - index) * sizeof(int));
+  memmove(arrptr->data + index, arrptr->data + index + 1, (arrptr->size - index - 1) * sizeof(int));
 
   --(arrptr->size);
 }
@@ -3,6 +3,7 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include "../allocator/allocator.h"
 
 const int kMinCapacity = 16;
 const int kGrowthFactor = 2;
@@ -12,29 +13,33 @@ typedef struct JWImplementationArray {
   int size;
   int capacity;
   int *data;
+  Allocator *allocator;  // where data and the JArray itself come from
 } JArray;
 
 // array functions
 
 // Creates a new JArray (vector in our case) to accommodate
-// the given initial capacity.
+// the given initial capacity. Returns NULL if out of memory.
 JArray *jarray_new(int capacity);
+// Same as jarray_new, taking all memory from the given allocator.
+JArray *jarray_new_with_allocator(int capacity, Allocator *allocator);
 void jarray_destroy(JArray *arrptr);
 
 // Checks to see if resizing is needed to support the candidate_size
-// and resizes to accommodate.
-void jarray_resize_for_size(JArray *arrptr, int candidate_size);
+// and resizes to accommodate. Growing can fail with CONTAINER_NO_MEMORY,
+// which leaves the array as it was; a failed shrink is ignored.
+ContainerStatus jarray_resize_for_size(JArray *arrptr, int candidate_size);
 // Determines the actual capacity (in terms of the power of growth factor)
 // required to accommodate a given capacity.
 int jarray_determine_capacity(int capacity);
 // Increases the array size to size determined by growth factor
-void jarray_upsize(JArray *arrptr);
+ContainerStatus jarray_upsize(JArray *arrptr);
 // Decreases the array size to size determined by growth factor
 void jarray_downsize(JArray *arrptr);
 // Returns the number of elements managed in the array.
 int jarray_size(JArray *arrptr);
 // Appends the given item to the end of the array.
-void jarray_push(JArray *arrptr, int item);
+ContainerStatus jarray_push(JArray *arrptr, int item);
 // Prints public information about the array for debug purposes.
 void jarray_print(JArray *arrptr);
 // Returns the actual capacity the array can accommodate.
@@ -45,10 +50,10 @@ int jarray_at(JArray *arrptr, int index);
 bool jarray_is_empty(JArray *arrptr);
 // Inserts the given value at the given index, shifting
 // current and trailing elements to the right.
-void jarray_insert(JArray *arrptr, int index, int value);
+ContainerStatus jarray_insert(JArray *arrptr, int index, int value);
 // Prepends the given value to the array, shifting trailing
 // elements to the right.
-void jarray_prepend(JArray *arrptr, int value);
+ContainerStatus jarray_prepend(JArray *arrptr, int value);
 // Removes the last item from the array and returns its value.
 int jarray_pop(JArray *arrptr);
 // Deletes the item stored at the given index, shifting trailing
@@ -0,0 +1,457 @@
+#include <string.h>
+// gap buffer implementation
+
+JGapBuffer *gap_buffer_new(int capacity) {
+  return gap_buffer_new_with_allocator(capacity, default_allocator());
+}
+
+JGapBuffer *gap_buffer_new_with_allocator(int capacity, Allocator *allocator) {
+  int true_capacity = jarray_determine_capacity(capacity);
+
+  JGapBuffer *bufptr = allocator_allocate(allocator, sizeof(JGapBuffer));
+  if (bufptr == NULL) {
+    return NULL;
+  }
+  bufptr->data = allocator_allocate(allocator, sizeof(int) * true_capacity);
+  if (bufptr->data == NULL) {
+    allocator_release(allocator, bufptr, sizeof(JGapBuffer));
+    return NULL;
+  }
+  bufptr->capacity = true_capacity;
+  bufptr->gap_start = 0;
+  bufptr->gap_end = true_capacity;
+  bufptr->allocator = allocator;
+  return bufptr;
+}
+
+void gap_buffer_destroy(JGapBuffer *bufptr) {
+  allocator_release(bufptr->allocator, bufptr->data, sizeof(int) * bufptr->capacity);
+  allocator_release(bufptr->allocator, bufptr, sizeof(JGapBuffer));
+}
+
+int gap_buffer_size(JGapBuffer *bufptr) {
+  return bufptr->capacity - (bufptr->gap_end - bufptr->gap_start);
+}
+
+bool gap_buffer_is_empty(JGapBuffer *bufptr) {
+  return gap_buffer_size(bufptr) == 0;
+}
+
+int gap_buffer_at(JGapBuffer *bufptr, int index) {
+  if (index < 0 || index >= gap_buffer_size(bufptr)) {
+    exit(EXIT_FAILURE);
+  }
+  if (index < bufptr->gap_start) {
+    return bufptr->data[index];
+  }
+  return bufptr->data[index + (bufptr->gap_end - bufptr->gap_start)];
+}
+
+// Moves the gap so it starts at index, shifting only the items between
+// the old and new positions.
+static void gap_buffer_move_gap(JGapBuffer *bufptr, int index) {
+  if (index < bufptr->gap_start) {
+    int count = bufptr->gap_start - index;
+    memmove(bufptr->data + bufptr->gap_end - count, bufptr->data + index, sizeof(int) * count);
+    bufptr->gap_start -= count;
+    bufptr->gap_end -= count;
+  } else if (index > bufptr->gap_start) {
+    int count = index - bufptr->gap_start;
+    memmove(bufptr->data + bufptr->gap_start, bufptr->data + bufptr->gap_end, sizeof(int) * count);
+    bufptr->gap_start += count;
+    bufptr->gap_end += count;
+  }
+}
+
+// Doubles the buffer. realloc keeps the items before the gap in place;
+// the ones after it move to the new end, so the gap absorbs the growth.
+static ContainerStatus gap_buffer_grow(JGapBuffer *bufptr) {
+  int old_capacity = bufptr->capacity;
+  int new_capacity = old_capacity * kGrowthFactor;
+  int *new_data = allocator_reallocate(bufptr->allocator, bufptr->data, sizeof(int) * old_capacity,
+                                       sizeof(int) * new_capacity);
+  if (new_data == NULL) {
+    return CONTAINER_NO_MEMORY;
+  }
+  int after = old_capacity - bufptr->gap_end;
+  memmove(new_data + new_capacity - after, new_data + bufptr->gap_end, sizeof(int) * after);
+  bufptr->data = new_data;
+  bufptr->capacity = new_capacity;
+  bufptr->gap_end = new_capacity - after;
+  return CONTAINER_OK;
+}
+
+ContainerStatus gap_buffer_insert(JGapBuffer *bufptr, int index, int value) {
+  if (index < 0 || index > gap_buffer_size(bufptr)) {
+    exit(EXIT_FAILURE);
+  }
+  if (bufptr->gap_start == bufptr->gap_end && gap_buffer_grow(bufptr) != CONTAINER_OK) {
+    return CONTAINER_NO_MEMORY;
+  }
+  gap_buffer_move_gap(bufptr, index);
+  bufptr->data[bufptr->gap_start++] = value;
+  return CONTAINER_OK;
+}
+
+ContainerStatus gap_buffer_prepend(JGapBuffer *bufptr, int value) {
+  return gap_buffer_insert(bufptr, 0, value);
+}
+
+ContainerStatus gap_buffer_push(JGapBuffer *bufptr, int value) {
+  return gap_buffer_insert(bufptr, gap_buffer_size(bufptr), value);
+}
+
+void gap_buffer_delete(JGapBuffer *bufptr, int index) {
+  if (index < 0 || index >= gap_buffer_size(bufptr)) {
+    exit(EXIT_FAILURE);
+  }
+  gap_buffer_move_gap(bufptr, index);
+  bufptr->gap_end++;
+}
+
+void gap_buffer_copy_to(JGapBuffer *bufptr, int *out) {
+  memcpy(out, bufptr->data, sizeof(int) * bufptr->gap_start);
+  memcpy(out + bufptr->gap_start, bufptr->data + bufptr->gap_end, sizeof(int) * (bufptr->capacity - bufptr->gap_end));
+}
+
+// piece table implementation
+
+JPieceTable *piece_table_new(const int *items, int count) {
+  return piece_table_new_with_allocator(items, count, default_allocator());
+}
+
+JPieceTable *piece_table_new_with_allocator(const int *items, int count, Allocator *allocator) {
+  JPieceTable *tableptr = allocator_allocate(allocator, sizeof(JPieceTable));
+  if (tableptr == NULL) {
+    return NULL;
+  }
+  tableptr->allocator = allocator;
+  tableptr->store_capacity = jarray_determine_capacity(count > 0 ? count : 1);
+  tableptr->store = allocator_allocate(allocator, sizeof(int) * tableptr->store_capacity);
+  tableptr->piece_capacity = kMinCapacity;
+  tableptr->pieces = allocator_allocate(allocator, sizeof(JPiece) * tableptr->piece_capacity);
+  if (tableptr->store == NULL || tableptr->pieces == NULL) {
+    allocator_release(allocator, tableptr->store, sizeof(int) * tableptr->store_capacity);
+    allocator_release(allocator, tableptr->pieces, sizeof(JPiece) * tableptr->piece_capacity);
+    allocator_release(allocator, tableptr, sizeof(JPieceTable));
+    return NULL;
+  }
+
+  if (count > 0) {
+    memcpy(tableptr->store, items, sizeof(int) * count);
+  }
+  tableptr->store_size = count;
+  tableptr->piece_count = 0;
+  if (count > 0) {
+    tableptr->pieces[0].start = 0;
+    tableptr->pieces[0].length = count;
+    tableptr->piece_count = 1;
+  }
+  tableptr->size = count;
+  tableptr->cursor_piece = 0;
+  tableptr->cursor_start = 0;
+  return tableptr;
+}
+
+void piece_table_destroy(JPieceTable *tableptr) {
+  allocator_release(tableptr->allocator, tableptr->store, sizeof(int) * tableptr->store_capacity);
+  allocator_release(tableptr->allocator, tableptr->pieces, sizeof(JPiece) * tableptr->piece_capacity);
+  allocator_release(tableptr->allocator, tableptr, sizeof(JPieceTable));
+}
+
+int piece_table_size(JPieceTable *tableptr) { return tableptr->size; }
+
+bool piece_table_is_empty(JPieceTable *tableptr) {
+  return tableptr->size == 0;
+}
+
+// Walks from the cursor to the piece holding index (< size) and leaves
+// the cursor there. Returns the piece; *offset is index's place in it.
+static int piece_table_find(JPieceTable *tableptr, int index, int *offset) {
+  int piece = tableptr->cursor_piece;
+  int start = tableptr->cursor_start;
+  while (index < start) {
+    --piece;
+    start -= tableptr->pieces[piece].length;
+  }
+  while (index >= start + tableptr->pieces[piece].length) {
+    start += tableptr->pieces[piece].length;
+    ++piece;
+  }
+  tableptr->cursor_piece = piece;
+  tableptr->cursor_start = start;
+  *offset = index - start;
+  return piece;
+}
+
+// Makes room for extra more pieces before anything is changed, so an
+// edit either fails untouched or completes.
+static ContainerStatus piece_table_reserve_pieces(JPieceTable *tableptr, int extra) {
+  if (tableptr->piece_count + extra <= tableptr->piece_capacity) {
+    return CONTAINER_OK;
+  }
+  int new_capacity = tableptr->piece_capacity * kGrowthFactor;
+  JPiece *new_pieces = allocator_reallocate(tableptr->allocator, tableptr->pieces,
+                                            sizeof(JPiece) * tableptr->piece_capacity, sizeof(JPiece) * new_capacity);
+  if (new_pieces == NULL) {
+    return CONTAINER_NO_MEMORY;
+  }
+  tableptr->pieces = new_pieces;
+  tableptr->piece_capacity = new_capacity;
+  return CONTAINER_OK;
+}
+
+static ContainerStatus piece_table_reserve_store(JPieceTable *tableptr) {
+  if (tableptr->store_size < tableptr->store_capacity) {
+    return CONTAINER_OK;
+  }
+  int new_capacity = tableptr->store_capacity * kGrowthFactor;
+  int *new_store = allocator_reallocate(tableptr->allocator, tableptr->store, sizeof(int) * tableptr->store_capacity,
+                                        sizeof(int) * new_capacity);
+  if (new_store == NULL) {
+    return CONTAINER_NO_MEMORY;
+  }
+  tableptr->store = new_store;
+  tableptr->store_capacity = new_capacity;
+  return CONTAINER_OK;
+}
+
+// Opens count empty slots in the piece list at position.
+static void piece_table_open(JPieceTable *tableptr, int position, int count) {
+  memmove(tableptr->pieces + position + count, tableptr->pieces + position,
+          sizeof(JPiece) * (tableptr->piece_count - position));
+  tableptr->piece_count += count;
+}
+
+static void piece_table_close(JPieceTable *tableptr, int position) {
+  memmove(tableptr->pieces + position, tableptr->pieces + position + 1,
+          sizeof(JPiece) * (tableptr->piece_count - position - 1));
+  tableptr->piece_count--;
+}
+
+// The new item always goes to the end of the store. If the piece just
+// before index ends at the end of the store (the previous insert was at
+// index - 1, as when typing), that piece grows instead of a new one
+// being made.
+ContainerStatus piece_table_insert(JPieceTable *tableptr, int index, int value) {
+  if (index < 0 || index > tableptr->size) {
+    exit(EXIT_FAILURE);
+  }
+  if (piece_table_reserve_store(tableptr) != CONTAINER_OK || piece_table_reserve_pieces(tableptr, 2) != CONTAINER_OK) {
+    return CONTAINER_NO_MEMORY;
+  }
+  int stored = tableptr->store_size;
+
+  int piece;
+  int offset;
+  if (index == tableptr->size) {
+    piece = tableptr->piece_count;  // past the last piece
+    offset = 0;
+    tableptr->cursor_piece = 0;
+    tableptr->cursor_start = 0;
+  } else {
+    piece = piece_table_find(tableptr, index, &offset);
+  }
+
+  JPiece *pieces = tableptr->pieces;
+  if (offset == 0 && piece > 0 && pieces[piece - 1].start + pieces[piece - 1].length == stored) {
+    pieces[piece - 1].length++;
+    tableptr->cursor_piece = piece - 1;
+    tableptr->cursor_start = index + 1 - pieces[piece - 1].length;
+  } else if (offset == 0) {
+    piece_table_open(tableptr, piece, 1);
+    pieces[piece].start = stored;
+    pieces[piece].length = 1;
+    tableptr->cursor_piece = piece;
+    tableptr->cursor_start = index;
+  } else {
+    // split piece around the new item
+    piece_table_open(tableptr, piece + 1, 2);
+    pieces[piece + 2].start = pieces[piece].start + offset;
+    pieces[piece + 2].length = pieces[piece].length - offset;
+    pieces[piece].length = offset;
+    pieces[piece + 1].start = stored;
+    pieces[piece + 1].length = 1;
+    tableptr->cursor_piece = piece + 1;
+    tableptr->cursor_start = index;
+  }
+
+  tableptr->store[tableptr->store_size++] = value;
+  tableptr->size++;
+  return CONTAINER_OK;
+}
+
+ContainerStatus piece_table_prepend(JPieceTable *tableptr, int value) {
+  return piece_table_insert(tableptr, 0, value);
+}
+
+ContainerStatus piece_table_push(JPieceTable *tableptr, int value) {
+  return piece_table_insert(tableptr, tableptr->size, value);
+}
+
+ContainerStatus piece_table_delete(JPieceTable *tableptr, int index) {
+  if (index < 0 || index >= tableptr->size) {
+    exit(EXIT_FAILURE);
+  }
+  if (piece_table_reserve_pieces(tableptr, 1) != CONTAINER_OK) {
+    return CONTAINER_NO_MEMORY;
+  }
+  int offset;
+  int piece = piece_table_find(tableptr, index, &offset);
+  JPiece *pieces = tableptr->pieces;
+
+  if (pieces[piece].length == 1) {
+    piece_table_close(tableptr, piece);
+    // the next piece now starts at index; past the end, reset
+    if (piece == tableptr->piece_count) {
+      piece = 0;
+      index = 0;
+    }
+    tableptr->cursor_piece = piece;
+    tableptr->cursor_start = index;
+  } else if (offset == 0) {
+    pieces[piece].start++;
+    pieces[piece].length--;
+  } else if (offset == pieces[piece].length - 1) {
+    pieces[piece].length--;
+  } else {
+    piece_table_open(tableptr, piece + 1, 1);
+    pieces[piece + 1].start = pieces[piece].start + offset + 1;
+    pieces[piece + 1].length = pieces[piece].length - offset - 1;
+    pieces[piece].length = offset;
+  }
+  tableptr->size--;
+  return CONTAINER_OK;
+}
+
+int piece_table_at(JPieceTable *tableptr, int index) {
+  if (index < 0 || index >= tableptr->size) {
+    exit(EXIT_FAILURE);
+  }
+  int offset;
+  int piece = piece_table_find(tableptr, index, &offset);
+  return tableptr->store[tableptr->pieces[piece].start + offset];
+}
+
+void piece_table_copy_to(JPieceTable *tableptr, int *out) {
+  for (int piece = 0; piece < tableptr->piece_count; ++piece) {
+    memcpy(out, tableptr->store + tableptr->pieces[piece].start, sizeof(int) * tableptr->pieces[piece].length);
+    out += tableptr->pieces[piece].length;
+  }
+}
+
+//=========== tests ===================================
+
+void run_all_edit_buffer_tests() {
+  test_gap_buffer_basic();
+  test_gap_buffer_grows_around_gap();
+  test_piece_table_basic();
+  test_piece_table_typing_coalesces();
+  test_edit_buffers_match_jarray();
+}
+
+void test_gap_buffer_basic() {
+  JGapBuffer *bufptr = gap_buffer_new(4);
+  for (int i = 0; i < 10; ++i) {
+    gap_buffer_push(bufptr, i);
+  }
+  gap_buffer_insert(bufptr, 3, 100);
+  gap_buffer_prepend(bufptr, -1);
+  gap_buffer_delete(bufptr, 8);  // the 6
+  assert(gap_buffer_size(bufptr) == 11);
+  int expected[] = {-1, 0, 1, 2, 100, 3, 4, 5, 7, 8, 9};
+  for (int i = 0; i < 11; ++i) {
+    assert(gap_buffer_at(bufptr, i) == expected[i]);
+  }
+  gap_buffer_destroy(bufptr);
+}
+
+void test_gap_buffer_grows_around_gap() {
+  JGapBuffer *bufptr = gap_buffer_new(1);
+  for (int i = 0; i < 16; ++i) {
+    gap_buffer_push(bufptr, i);
+  }
+  // full, with the gap in the middle when it has to grow
+  gap_buffer_delete(bufptr, 8);
+  gap_buffer_insert(bufptr, 8, 8);
+  gap_buffer_insert(bufptr, 8, 50);
+  assert(bufptr->capacity == 32);
+  assert(gap_buffer_at(bufptr, 8) == 50);
+  assert(gap_buffer_at(bufptr, 9) == 8);
+  assert(gap_buffer_at(bufptr, 16) == 15);
+  gap_buffer_destroy(bufptr);
+}
+
+void test_piece_table_basic() {
+  int items[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  JPieceTable *tableptr = piece_table_new(items, 10);
+  piece_table_insert(tableptr, 3, 100);
+  piece_table_prepend(tableptr, -1);
+  piece_table_delete(tableptr, 8);  // the 6
+  piece_table_push(tableptr, 10);
+  assert(piece_table_size(tableptr) == 12);
+  int expected[] = {-1, 0, 1, 2, 100, 3, 4, 5, 7, 8, 9, 10};
+  for (int i = 11; i >= 0; --i) {  // backwards, so the cursor walks back
+    assert(piece_table_at(tableptr, i) == expected[i]);
+  }
+  int out[12];
+  piece_table_copy_to(tableptr, out);
+  assert(memcmp(out, expected, sizeof(out)) == 0);
+  piece_table_destroy(tableptr);
+}
+
+void test_piece_table_typing_coalesces() {
+  int items[] = {0, 1, 2, 3};
+  JPieceTable *tableptr = piece_table_new(items, 4);
+  for (int i = 0; i < 100; ++i) {
+    piece_table_insert(tableptr, 2 + i, 1000 + i);
+  }
+  assert(tableptr->piece_count == 3);  // 0 1 | typed | 2 3
+  assert(piece_table_at(tableptr, 101) == 1099);
+  assert(piece_table_at(tableptr, 102) == 2);
+  piece_table_destroy(tableptr);
+}
+
+// random edits, mostly near a moving cursor, checked against JArray
+void test_edit_buffers_match_jarray() {
+  JArray *arrptr = jarray_new(1);
+  JGapBuffer *bufptr = gap_buffer_new(1);
+  JPieceTable *tableptr = piece_table_new(NULL, 0);
+  srand(42);
+  int cursor = 0;
+
+  for (int step = 0; step < 20000; ++step) {
+    int size = jarray_size(arrptr);
+    cursor = rand() % 8 == 0 ? rand() % (size + 1) : cursor + rand() % 5 - 2;
+    if (cursor < 0) {
+      cursor = 0;
+    }
+    if (cursor > size) {
+      cursor = size;
+    }
+    if (size > 0 && cursor < size && rand() % 3 == 0) {
+      jarray_delete(arrptr, cursor);
+      gap_buffer_delete(bufptr, cursor);
+      piece_table_delete(tableptr, cursor);
+    } else if (cursor == size) {
+      jarray_push(arrptr, step);
+      gap_buffer_insert(bufptr, cursor, step);
+      piece_table_insert(tableptr, cursor, step);
+    } else {
+      jarray_insert(arrptr, cursor, step);
+      gap_buffer_insert(bufptr, cursor, step);
+      piece_table_insert(tableptr, cursor, step);
+    }
+    if (step % 997 == 0) {
+      size = jarray_size(arrptr);
+      assert(gap_buffer_size(bufptr) == size && piece_table_size(tableptr) == size);
+      for (int i = 0; i < size; ++i) {
+        assert(gap_buffer_at(bufptr, i) == arrptr->data[i]);
+        assert(piece_table_at(tableptr, i) == arrptr->data[i]);
+      }
+    }
+  }
+  jarray_destroy(arrptr);
+  gap_buffer_destroy(bufptr);
+  piece_table_destroy(tableptr);
+}
@@ -0,0 +1,98 @@
+#ifndef PROJECT_EDIT_BUFFER_H
+#define PROJECT_EDIT_BUFFER_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include "../allocator/allocator.h"
+
+// Two int sequences with JArray's at/insert/delete API for edit-heavy
+// workloads, where jarray_insert and jarray_delete memmove the whole
+// tail on every call.
+//
+// JGapBuffer keeps the free space as a gap at the last edit position.
+// An edit moves the gap there (a memmove of the distance from the last
+// edit, not of the tail) and then costs O(1), so edits near a cursor are
+// O(1) amortized. Edits far apart still move up to n items.
+//
+// JPieceTable never moves items: inserted items are appended to an
+// append-only store, and the sequence is a list of pieces (runs of the
+// store). An edit splits or trims at most one piece, so its cost depends
+// on the number of pieces, not on n, which suits scattered edits.
+// Lookups start from the piece of the last access, so sequential reads
+// and edits near the last one do not scan. Deleted items stay in the
+// store.
+
+typedef struct JWImplementationGapBuffer {
+  int *data;
+  int capacity;
+  int gap_start;  // items before the gap are data[0, gap_start)
+  int gap_end;    // items after the gap are data[gap_end, capacity)
+  Allocator *allocator;
+} JGapBuffer;
+
+typedef struct JWImplementationPiece {
+  int start;   // first item in the store
+  int length;
+} JPiece;
+
+typedef struct JWImplementationPieceTable {
+  int *store;  // every item ever inserted, append only
+  int store_size;
+  int store_capacity;
+  JPiece *pieces;
+  int piece_count;
+  int piece_capacity;
+  int size;
+  int cursor_piece;  // piece of the last access
+  int cursor_start;  // index of cursor_piece's first item
+  Allocator *allocator;
+} JPieceTable;
+
+// gap buffer functions
+
+// Returns NULL if out of memory.
+JGapBuffer *gap_buffer_new(int capacity);
+JGapBuffer *gap_buffer_new_with_allocator(int capacity, Allocator *allocator);
+void gap_buffer_destroy(JGapBuffer *bufptr);
+int gap_buffer_size(JGapBuffer *bufptr);
+bool gap_buffer_is_empty(JGapBuffer *bufptr);
+int gap_buffer_at(JGapBuffer *bufptr, int index);
+// Inserts value before index; index may be size (an append). On
+// CONTAINER_NO_MEMORY the buffer is unchanged.
+ContainerStatus gap_buffer_insert(JGapBuffer *bufptr, int index, int value);
+ContainerStatus gap_buffer_prepend(JGapBuffer *bufptr, int value);
+ContainerStatus gap_buffer_push(JGapBuffer *bufptr, int value);
+void gap_buffer_delete(JGapBuffer *bufptr, int index);
+// Copies the items in order to out, which must hold size items.
+void gap_buffer_copy_to(JGapBuffer *bufptr, int *out);
+
+// piece table functions
+
+// Starts with a copy of count items. Returns NULL if out of memory.
+JPieceTable *piece_table_new(const int *items, int count);
+JPieceTable *piece_table_new_with_allocator(const int *items, int count, Allocator *allocator);
+void piece_table_destroy(JPieceTable *tableptr);
+int piece_table_size(JPieceTable *tableptr);
+bool piece_table_is_empty(JPieceTable *tableptr);
+int piece_table_at(JPieceTable *tableptr, int index);
+// Inserts value before index; index may be size (an append). On
+// CONTAINER_NO_MEMORY the table is unchanged.
+ContainerStatus piece_table_insert(JPieceTable *tableptr, int index, int value);
+ContainerStatus piece_table_prepend(JPieceTable *tableptr, int value);
+ContainerStatus piece_table_push(JPieceTable *tableptr, int value);
+// Can split a piece, so it can run out of memory too.
+ContainerStatus piece_table_delete(JPieceTable *tableptr, int index);
+// Copies the items in order to out, which must hold size items.
+void piece_table_copy_to(JPieceTable *tableptr, int *out);
+
+// tests
+
+void run_all_edit_buffer_tests();
+
+void test_gap_buffer_basic();
+void test_gap_buffer_grows_around_gap();
+void test_piece_table_basic();
+void test_piece_table_typing_coalesces();
+void test_edit_buffers_match_jarray();
+
+#endif  // PROJECT_EDIT_BUFFER_H
@@ -0,0 +1,162 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>   // for IO
+#include <stdlib.h>  // for malloc
+#include <time.h>
+#include "array.h"
+#include "array.c"
+#include "edit_buffer.h"
+#include "edit_buffer.c"
+
+// Edit streams over a 1M item sequence, replayed on JArray, JGapBuffer
+// and JPieceTable:
+//  - typing: inserts at a cursor that moves forward one item per insert,
+//    with some deletes and a jump to a random place every 100 edits
+//  - cursor: inserts and deletes within +-16 of a wandering cursor
+//  - scattered: inserts and deletes at uniformly random places
+// JArray is O(n) per edit, so it replays a shorter prefix of each stream.
+// After the edits every item is read back with at(), in order.
+
+#define kInitialItems 1000000
+#define kEdits 200000
+#define kSlowEdits 10000
+
+typedef struct Edit {
+  int index;
+  int value;  // -1 for a delete
+} Edit;
+
+typedef enum EditStream { kTyping, kCursor, kScattered } EditStream;
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile long long sink;
+
+static void make_stream(EditStream stream, Edit *edits) {
+  int size = kInitialItems;
+  int cursor = size / 2;
+  for (int i = 0; i < kEdits; ++i) {
+    bool erase = rand() % 10 < 3;
+    if (stream == kTyping) {
+      if (i % 100 == 0) {
+        cursor = rand() % size;
+      }
+      if (erase && cursor > 0) {
+        --cursor;  // backspace
+      } else {
+        erase = false;
+      }
+    } else if (stream == kCursor) {
+      cursor += rand() % 33 - 16;
+    } else {
+      cursor = rand() % (size + 1);
+    }
+    if (cursor < 0) {
+      cursor = 0;
+    }
+    if (cursor >= size) {
+      cursor = size - 1;
+    }
+    edits[i].index = cursor;
+    edits[i].value = erase ? -1 : i;
+    if (erase) {
+      --size;
+    } else {
+      ++size;
+      if (stream == kTyping) {
+        ++cursor;
+      }
+    }
+  }
+}
+
+static void bench_stream(const char *name, EditStream stream, int *initial, Edit *edits, int scattered_edits) {
+  make_stream(stream, edits);
+  int fast_edits = stream == kScattered ? scattered_edits : kEdits;
+
+  JArray *arrptr = jarray_new(kInitialItems);
+  for (int i = 0; i < kInitialItems; ++i) {
+    jarray_push(arrptr, initial[i]);
+  }
+  double start = now_ns();
+  for (int i = 0; i < kSlowEdits; ++i) {
+    if (edits[i].value < 0) {
+      jarray_delete(arrptr, edits[i].index);
+    } else if (edits[i].index == jarray_size(arrptr)) {
+      jarray_push(arrptr, edits[i].value);
+    } else {
+      jarray_insert(arrptr, edits[i].index, edits[i].value);
+    }
+  }
+  double jarray_ns = (now_ns() - start) / kSlowEdits;
+  jarray_destroy(arrptr);
+
+  JGapBuffer *bufptr = gap_buffer_new(kInitialItems);
+  for (int i = 0; i < kInitialItems; ++i) {
+    gap_buffer_push(bufptr, initial[i]);
+  }
+  start = now_ns();
+  for (int i = 0; i < fast_edits; ++i) {
+    if (edits[i].value < 0) {
+      gap_buffer_delete(bufptr, edits[i].index);
+    } else {
+      gap_buffer_insert(bufptr, edits[i].index, edits[i].value);
+    }
+  }
+  double gap_ns = (now_ns() - start) / fast_edits;
+  start = now_ns();
+  long long sum = 0;
+  for (int i = 0; i < gap_buffer_size(bufptr); ++i) {
+    sum += gap_buffer_at(bufptr, i);
+  }
+  double gap_read_ms = (now_ns() - start) / 1e6;
+  gap_buffer_destroy(bufptr);
+
+  JPieceTable *tableptr = piece_table_new(initial, kInitialItems);
+  start = now_ns();
+  for (int i = 0; i < fast_edits; ++i) {
+    if (edits[i].value < 0) {
+      piece_table_delete(tableptr, edits[i].index);
+    } else {
+      piece_table_insert(tableptr, edits[i].index, edits[i].value);
+    }
+  }
+  double piece_ns = (now_ns() - start) / fast_edits;
+  int pieces = tableptr->piece_count;
+  start = now_ns();
+  for (int i = 0; i < piece_table_size(tableptr); ++i) {
+    sum += piece_table_at(tableptr, i);
+  }
+  double piece_read_ms = (now_ns() - start) / 1e6;
+  piece_table_destroy(tableptr);
+  sink = sum;
+
+  printf("%-10s %8d | %10.1f | %10.1f %9.1f | %10.1f %9.1f %8d\n", name, fast_edits, jarray_ns, gap_ns, gap_read_ms,
+         piece_ns, piece_read_ms, pieces);
+}
+
+int main(int argc, char* argv[]) {
+  int *initial = malloc(sizeof(int) * kInitialItems);
+  Edit *edits = malloc(sizeof(Edit) * kEdits);
+  check_address(initial);
+  check_address(edits);
+  srand(1);
+  for (int i = 0; i < kInitialItems; ++i) {
+    initial[i] = rand();
+  }
+
+  printf("%d items; JArray replays the first %d edits of each stream\n", kInitialItems, kSlowEdits);
+  printf("%-10s %8s | %10s | %10s %9s | %10s %9s %8s\n", "stream", "edits", "JArray", "gap", "read all",
+         "piece", "read all", "pieces");
+  printf("%-10s %8s | %10s | %10s %9s | %10s %9s %8s\n", "", "", "ns/edit", "ns/edit", "ms", "ns/edit", "ms", "");
+  bench_stream("typing", kTyping, initial, edits, 0);
+  bench_stream("cursor", kCursor, initial, edits, 0);
+  bench_stream("scattered", kScattered, initial, edits, 20000);
+
+  free(initial);
+  free(edits);
+  return EXIT_SUCCESS;
+}
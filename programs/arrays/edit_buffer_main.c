@@ -0,0 +1,16 @@
+#include <stdio.h>   // for IO
+#include <stdlib.h>  // for malloc
+#include "array.h"
+#include "array.c"
+#include "edit_buffer.h"
+#include "edit_buffer.c"
+
+// Implements a gap buffer (JGapBuffer) and a piece table (JPieceTable),
+// two int sequences with JArray's API for insert-heavy edits.
+
+int main(int argc, char* argv[]) {
+  run_all_edit_buffer_tests();
+  printf("All edit buffer tests passed.\n");
+
+  return EXIT_SUCCESS;
+}
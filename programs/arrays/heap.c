@@ -0,0 +1,474 @@
+// 4-ary min-heap and radix heap on top of JArray
+
+// stores id/priority at heap index to and records that position for id
+static void heap_place(JHeap *heapptr, int to, int id, int priority) {
+  heapptr->priorities->data[to] = priority;
+  heapptr->ids->data[to] = id;
+  heapptr->positions->data[id] = to;
+}
+
+static void heap_sift_up(JHeap *heapptr, int index) {
+  int id = heapptr->ids->data[index];
+  int priority = heapptr->priorities->data[index];
+
+  while (index > 0) {
+    int parent = (index - 1) / kHeapArity;
+    int parent_priority = heapptr->priorities->data[parent];
+    if (parent_priority <= priority) {
+      break;
+    }
+    heap_place(heapptr, index, heapptr->ids->data[parent], parent_priority);
+    index = parent;
+  }
+  heap_place(heapptr, index, id, priority);
+}
+
+static void heap_sift_down(JHeap *heapptr, int index) {
+  int size = heapptr->priorities->size;
+  int *priorities = heapptr->priorities->data;
+  int id = heapptr->ids->data[index];
+  int priority = priorities[index];
+
+  for (;;) {
+    int first_child = index * kHeapArity + 1;
+    if (first_child >= size) {
+      break;
+    }
+    int last_child = first_child + kHeapArity;
+    if (last_child > size) {
+      last_child = size;
+    }
+
+    int smallest = first_child;
+    for (int child = first_child + 1; child < last_child; ++child) {
+      if (priorities[child] < priorities[smallest]) {
+        smallest = child;
+      }
+    }
+    if (priorities[smallest] >= priority) {
+      break;
+    }
+    heap_place(heapptr, index, heapptr->ids->data[smallest], priorities[smallest]);
+    index = smallest;
+  }
+  heap_place(heapptr, index, id, priority);
+}
+
+// grows positions so that id is a valid index
+static ContainerStatus heap_track_id(JHeap *heapptr, int id) {
+  if (id < 0) {
+    exit(EXIT_FAILURE);
+  }
+  while (heapptr->positions->size <= id) {
+    if (jarray_push(heapptr->positions, -1) != CONTAINER_OK) {
+      return CONTAINER_NO_MEMORY;
+    }
+  }
+  return CONTAINER_OK;
+}
+
+JHeap *heap_new(int capacity) {
+  return heap_new_with_allocator(capacity, default_allocator());
+}
+
+JHeap *heap_new_with_allocator(int capacity, Allocator *allocator) {
+  JHeap *heap = allocator_allocate(allocator, sizeof(JHeap));
+  if (heap == NULL) {
+    return NULL;
+  }
+
+  heap->allocator = allocator;
+  heap->priorities = jarray_new_with_allocator(capacity, allocator);
+  heap->ids = jarray_new_with_allocator(capacity, allocator);
+  heap->positions = jarray_new_with_allocator(capacity, allocator);
+  if (heap->priorities == NULL || heap->ids == NULL || heap->positions == NULL) {
+    heap_destroy(heap);
+    return NULL;
+  }
+
+  return heap;
+}
+
+JHeap *heap_build(const int *ids, const int *priorities, int count) {
+  return heap_build_with_allocator(ids, priorities, count, default_allocator());
+}
+
+JHeap *heap_build_with_allocator(const int *ids, const int *priorities, int count,
+                                 Allocator *allocator) {
+  JHeap *heap = heap_new_with_allocator(count > 0 ? count : 1, allocator);
+  if (heap == NULL) {
+    return NULL;
+  }
+
+  for (int i = 0; i < count; ++i) {
+    if (heap_track_id(heap, ids[i]) != CONTAINER_OK) {
+      heap_destroy(heap);
+      return NULL;
+    }
+    if (heap->positions->data[ids[i]] != -1) {
+      exit(EXIT_FAILURE);
+    }
+    if (jarray_push(heap->priorities, priorities[i]) != CONTAINER_OK ||
+        jarray_push(heap->ids, ids[i]) != CONTAINER_OK) {
+      heap_destroy(heap);
+      return NULL;
+    }
+    heap->positions->data[ids[i]] = i;
+  }
+
+  // every index past the last parent is already a valid one-item heap
+  for (int i = (count - 2) / kHeapArity; i >= 0 && count > 1; --i) {
+    heap_sift_down(heap, i);
+  }
+
+  return heap;
+}
+
+void heap_destroy(JHeap *heapptr) {
+  JArray *arrays[] = {heapptr->priorities, heapptr->ids, heapptr->positions};
+  for (int i = 0; i < 3; ++i) {
+    if (arrays[i] != NULL) {
+      jarray_destroy(arrays[i]);
+    }
+  }
+  allocator_release(heapptr->allocator, heapptr, sizeof(JHeap));
+}
+
+int heap_size(JHeap *heapptr) { return heapptr->priorities->size; }
+
+bool heap_is_empty(JHeap *heapptr) { return heapptr->priorities->size == 0; }
+
+bool heap_contains(JHeap *heapptr, int id) {
+  return id >= 0 && id < heapptr->positions->size &&
+         heapptr->positions->data[id] != -1;
+}
+
+ContainerStatus heap_push(JHeap *heapptr, int id, int priority) {
+  if (heap_track_id(heapptr, id) != CONTAINER_OK) {
+    return CONTAINER_NO_MEMORY;
+  }
+  if (heapptr->positions->data[id] != -1) {
+    exit(EXIT_FAILURE);
+  }
+
+  if (jarray_push(heapptr->priorities, priority) != CONTAINER_OK) {
+    return CONTAINER_NO_MEMORY;
+  }
+  if (jarray_push(heapptr->ids, id) != CONTAINER_OK) {
+    jarray_pop(heapptr->priorities);
+    return CONTAINER_NO_MEMORY;
+  }
+  heap_sift_up(heapptr, heapptr->priorities->size - 1);
+  return CONTAINER_OK;
+}
+
+int heap_peek(JHeap *heapptr) {
+  if (heap_is_empty(heapptr)) {
+    exit(EXIT_FAILURE);
+  }
+  return heapptr->ids->data[0];
+}
+
+int heap_peek_priority(JHeap *heapptr) {
+  if (heap_is_empty(heapptr)) {
+    exit(EXIT_FAILURE);
+  }
+  return heapptr->priorities->data[0];
+}
+
+int heap_pop(JHeap *heapptr) {
+  if (heap_is_empty(heapptr)) {
+    exit(EXIT_FAILURE);
+  }
+
+  int top_id = heapptr->ids->data[0];
+  int last_priority = jarray_pop(heapptr->priorities);
+  int last_id = jarray_pop(heapptr->ids);
+  heapptr->positions->data[top_id] = -1;
+
+  if (!heap_is_empty(heapptr)) {
+    heap_place(heapptr, 0, last_id, last_priority);
+    heap_sift_down(heapptr, 0);
+  }
+
+  return top_id;
+}
+
+void heap_decrease_key(JHeap *heapptr, int id, int priority) {
+  if (!heap_contains(heapptr, id)) {
+    exit(EXIT_FAILURE);
+  }
+
+  int index = heapptr->positions->data[id];
+  if (priority > heapptr->priorities->data[index]) {
+    exit(EXIT_FAILURE);
+  }
+  heapptr->priorities->data[index] = priority;
+  heap_sift_up(heapptr, index);
+}
+
+//=========== radix heap ===================================
+
+// bucket 0 holds priorities equal to last_popped, bucket i > 0 those whose
+// highest bit differing from last_popped is bit i - 1
+static int radix_bucket(unsigned int last_popped, unsigned int priority) {
+  unsigned int diff = priority ^ last_popped;
+  return diff == 0 ? 0 : 32 - __builtin_clz(diff);
+}
+
+JRadixHeap *radix_heap_new() {
+  return radix_heap_new_with_allocator(default_allocator());
+}
+
+JRadixHeap *radix_heap_new_with_allocator(Allocator *allocator) {
+  JRadixHeap *heap = allocator_allocate(allocator, sizeof(JRadixHeap));
+  if (heap == NULL) {
+    return NULL;
+  }
+
+  heap->allocator = allocator;
+  bool allocated = true;
+  for (int i = 0; i < kRadixBuckets; ++i) {
+    heap->priorities[i] = jarray_new_with_allocator(1, allocator);
+    heap->ids[i] = jarray_new_with_allocator(1, allocator);
+    allocated &= heap->priorities[i] != NULL && heap->ids[i] != NULL;
+  }
+  heap->last_popped = 0;
+  heap->size = 0;
+  if (!allocated) {
+    radix_heap_destroy(heap);
+    return NULL;
+  }
+
+  return heap;
+}
+
+void radix_heap_destroy(JRadixHeap *heapptr) {
+  for (int i = 0; i < kRadixBuckets; ++i) {
+    if (heapptr->priorities[i] != NULL) {
+      jarray_destroy(heapptr->priorities[i]);
+    }
+    if (heapptr->ids[i] != NULL) {
+      jarray_destroy(heapptr->ids[i]);
+    }
+  }
+  allocator_release(heapptr->allocator, heapptr, sizeof(JRadixHeap));
+}
+
+int radix_heap_size(JRadixHeap *heapptr) { return heapptr->size; }
+
+ContainerStatus radix_heap_push(JRadixHeap *heapptr, int id, unsigned int priority) {
+  if (priority < heapptr->last_popped) {
+    exit(EXIT_FAILURE);
+  }
+
+  int bucket = radix_bucket(heapptr->last_popped, priority);
+  if (jarray_push(heapptr->priorities[bucket], (int)priority) != CONTAINER_OK) {
+    return CONTAINER_NO_MEMORY;
+  }
+  if (jarray_push(heapptr->ids[bucket], id) != CONTAINER_OK) {
+    jarray_pop(heapptr->priorities[bucket]);
+    return CONTAINER_NO_MEMORY;
+  }
+  ++(heapptr->size);
+  return CONTAINER_OK;
+}
+
+// Grows arrptr until it can take extra more items without reallocating.
+static ContainerStatus radix_heap_reserve(JArray *arrptr, int extra) {
+  while (arrptr->capacity - arrptr->size < extra) {
+    if (jarray_upsize(arrptr) != CONTAINER_OK) {
+      return CONTAINER_NO_MEMORY;
+    }
+  }
+  return CONTAINER_OK;
+}
+
+ContainerStatus radix_heap_pop(JRadixHeap *heapptr, int *id) {
+  if (heapptr->size == 0) {
+    exit(EXIT_FAILURE);
+  }
+
+  if (jarray_is_empty(heapptr->ids[0])) {
+    // refill bucket 0 from the first non-empty bucket: its minimum becomes
+    // last_popped and everything in it lands in a strictly lower bucket
+    int bucket = 1;
+    while (jarray_is_empty(heapptr->ids[bucket])) {
+      ++bucket;
+    }
+
+    JArray *priorities = heapptr->priorities[bucket];
+    JArray *ids = heapptr->ids[bucket];
+    unsigned int smallest = (unsigned int)priorities->data[0];
+    for (int i = 1; i < priorities->size; ++i) {
+      if ((unsigned int)priorities->data[i] < smallest) {
+        smallest = (unsigned int)priorities->data[i];
+      }
+    }
+
+    // make room in every target bucket first, so the moves below cannot
+    // fail halfway; growing a bucket early leaves the heap as it was
+    int moving[kRadixBuckets] = {0};
+    for (int i = 0; i < priorities->size; ++i) {
+      moving[radix_bucket(smallest, (unsigned int)priorities->data[i])]++;
+    }
+    for (int target = 0; target < bucket; ++target) {
+      if (moving[target] > 0 && (radix_heap_reserve(heapptr->priorities[target], moving[target]) != CONTAINER_OK ||
+                                 radix_heap_reserve(heapptr->ids[target], moving[target]) != CONTAINER_OK)) {
+        return CONTAINER_NO_MEMORY;
+      }
+    }
+
+    heapptr->last_popped = smallest;
+    for (int i = 0; i < priorities->size; ++i) {
+      unsigned int priority = (unsigned int)priorities->data[i];
+      int target = radix_bucket(smallest, priority);
+      jarray_push(heapptr->priorities[target], (int)priority);
+      jarray_push(heapptr->ids[target], ids->data[i]);
+    }
+    priorities->size = 0;
+    ids->size = 0;
+    jarray_downsize(priorities);
+    jarray_downsize(ids);
+  }
+
+  jarray_pop(heapptr->priorities[0]);
+  --(heapptr->size);
+  *id = jarray_pop(heapptr->ids[0]);
+  return CONTAINER_OK;
+}
+
+//=========== tests ===================================
+
+void run_all_heap_tests() {
+  test_heap_push_pop_sorted();
+  test_heap_build();
+  test_heap_build_duplicate_id();
+  test_heap_build_with_allocator();
+  test_heap_decrease_key();
+  test_heap_contains();
+  test_radix_heap_monotone();
+}
+
+void test_heap_push_pop_sorted() {
+  JHeap *hptr = heap_new(4);
+  int priorities[] = {42, 7, 19, 3, 88, 7, 0, 56, 23, 11};
+  for (int i = 0; i < 10; ++i) {
+    heap_push(hptr, i, priorities[i]);
+  }
+  assert(heap_size(hptr) == 10);
+
+  int previous = -1;
+  while (!heap_is_empty(hptr)) {
+    int priority = heap_peek_priority(hptr);
+    int id = heap_pop(hptr);
+    assert(priorities[id] == priority);
+    assert(priority >= previous);
+    previous = priority;
+  }
+  heap_destroy(hptr);
+}
+
+void test_heap_build() {
+  int ids[100];
+  int priorities[100];
+  for (int i = 0; i < 100; ++i) {
+    ids[i] = i;
+    priorities[i] = (i * 37) % 100;
+  }
+  JHeap *hptr = heap_build(ids, priorities, 100);
+  for (int expected = 0; expected < 100; ++expected) {
+    assert(heap_peek_priority(hptr) == expected);
+    heap_pop(hptr);
+  }
+  heap_destroy(hptr);
+}
+
+void test_heap_build_duplicate_id() {
+  int ids[] = {7, 3, 7};
+  int priorities[] = {1, 2, 3};
+  pid_t child = fork();
+  assert(child >= 0);
+  if (child == 0) {
+    heap_build(ids, priorities, 3);
+    _exit(EXIT_SUCCESS);  // not reached: the second 7 must be rejected
+  }
+  int status;
+  assert(waitpid(child, &status, 0) == child);
+  assert(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE);
+}
+
+void test_heap_build_with_allocator() {
+  int ids[] = {4, 0, 9, 2};
+  int priorities[] = {40, 10, 90, 20};
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+
+  JHeap *hptr = heap_build_with_allocator(ids, priorities, 4, &tracker.allocator);
+  assert(hptr != NULL && hptr->allocator == &tracker.allocator);
+  assert(heap_pop(hptr) == 0 && heap_pop(hptr) == 2);
+  heap_destroy(hptr);
+  assert(tracker.bytes_live == 0);
+
+  // fail each allocation in turn; none of the earlier ones may leak
+  for (long fail_after = 0;; ++fail_after) {
+    tracker.allocations = 0;
+    tracker.fail_after = fail_after;
+    hptr = heap_build_with_allocator(ids, priorities, 4, &tracker.allocator);
+    if (hptr != NULL) {
+      heap_destroy(hptr);
+      assert(tracker.bytes_live == 0);
+      break;
+    }
+    assert(tracker.bytes_live == 0);
+  }
+}
+
+void test_heap_decrease_key() {
+  JHeap *hptr = heap_new(8);
+  for (int i = 0; i < 20; ++i) {
+    heap_push(hptr, i, 100 + i);
+  }
+  heap_decrease_key(hptr, 17, 5);
+  assert(heap_peek(hptr) == 17);
+  heap_decrease_key(hptr, 3, 4);
+  assert(heap_pop(hptr) == 3);
+  assert(heap_pop(hptr) == 17);
+  assert(heap_pop(hptr) == 0);
+  heap_destroy(hptr);
+}
+
+void test_heap_contains() {
+  JHeap *hptr = heap_new(2);
+  heap_push(hptr, 5, 1);
+  assert(heap_contains(hptr, 5));
+  assert(!heap_contains(hptr, 4));
+  assert(!heap_contains(hptr, 500));
+  heap_pop(hptr);
+  assert(!heap_contains(hptr, 5));
+  heap_destroy(hptr);
+}
+
+void test_radix_heap_monotone() {
+  JRadixHeap *hptr = radix_heap_new();
+  unsigned int priorities[] = {50, 3, 1000000, 3, 77, 4096, 12};
+  for (int i = 0; i < 7; ++i) {
+    radix_heap_push(hptr, i, priorities[i]);
+  }
+
+  unsigned int previous = 0;
+  for (int i = 0; i < 7; ++i) {
+    int id;
+    assert(radix_heap_pop(hptr, &id) == CONTAINER_OK);
+    assert(priorities[id] == hptr->last_popped);
+    assert(hptr->last_popped >= previous);
+    previous = hptr->last_popped;
+    if (i == 2) {
+      radix_heap_push(hptr, 7, previous + 2000000);  // still monotone
+    }
+  }
+  assert(radix_heap_size(hptr) == 1);
+  int last;
+  assert(radix_heap_pop(hptr, &last) == CONTAINER_OK && last == 7);
+  radix_heap_destroy(hptr);
+}
@@ -0,0 +1,91 @@
+#ifndef PROJECT_HEAP_H
+#define PROJECT_HEAP_H
+
+#include <stdbool.h>
+#include "array.h"
+
+// Number of children per heap node. Four children of an int priority fit
+// in 16 bytes, so a sift-down compares them inside one cache line.
+#define kHeapArity 4
+
+// Min-heap of (id, priority) pairs stored level by level in JArrays.
+// ids are small non-negative ints chosen by the caller (vertex numbers,
+// task slots, ...). positions maps an id back to its heap index, which is
+// what makes decrease_key O(log n) instead of a linear search.
+typedef struct JWImplementationHeap {
+  JArray *priorities;  // priority at each heap index
+  JArray *ids;         // id at each heap index
+  JArray *positions;   // heap index of each id, -1 if not in the heap
+  Allocator *allocator;
+} JHeap;
+
+// Radix heap for monotone integer priorities: every pushed priority must be
+// >= the last popped one (as in Dijkstra). Bucket i holds items whose
+// priority first differs from last_popped at bit i - 1, so each item moves
+// to a lower bucket at most 33 times over its lifetime.
+#define kRadixBuckets 33
+
+typedef struct JWImplementationRadixHeap {
+  JArray *priorities[kRadixBuckets];
+  JArray *ids[kRadixBuckets];
+  unsigned int last_popped;
+  int size;
+  Allocator *allocator;
+} JRadixHeap;
+
+// heap functions
+
+// Creates an empty heap with room for capacity items before growing.
+// Returns NULL if out of memory.
+JHeap *heap_new(int capacity);
+JHeap *heap_new_with_allocator(int capacity, Allocator *allocator);
+// Builds a heap from count ids/priorities in O(n) (bottom-up heapify).
+// ids must be distinct, as for heap_push. Returns NULL if out of memory.
+JHeap *heap_build(const int *ids, const int *priorities, int count);
+JHeap *heap_build_with_allocator(const int *ids, const int *priorities, int count,
+                                 Allocator *allocator);
+void heap_destroy(JHeap *heapptr);
+// Returns the number of items in the heap.
+int heap_size(JHeap *heapptr);
+// Returns true if heap is empty.
+bool heap_is_empty(JHeap *heapptr);
+// Returns true if the given id is currently in the heap.
+bool heap_contains(JHeap *heapptr, int id);
+// Adds id with the given priority. id must not already be in the heap.
+// On CONTAINER_NO_MEMORY the heap is unchanged.
+ContainerStatus heap_push(JHeap *heapptr, int id, int priority);
+// Returns the id with the smallest priority without removing it.
+int heap_peek(JHeap *heapptr);
+// Returns the smallest priority in the heap.
+int heap_peek_priority(JHeap *heapptr);
+// Removes the id with the smallest priority and returns it.
+int heap_pop(JHeap *heapptr);
+// Lowers the priority of an id already in the heap.
+void heap_decrease_key(JHeap *heapptr, int id, int priority);
+
+// radix heap functions
+
+JRadixHeap *radix_heap_new();
+JRadixHeap *radix_heap_new_with_allocator(Allocator *allocator);
+void radix_heap_destroy(JRadixHeap *heapptr);
+int radix_heap_size(JRadixHeap *heapptr);
+// Adds id with the given priority, which must be >= the last popped one.
+ContainerStatus radix_heap_push(JRadixHeap *heapptr, int id, unsigned int priority);
+// Removes the id with the smallest priority and stores it in *id. The
+// priority it had is left in last_popped. Refilling bucket 0 can need
+// memory; on CONTAINER_NO_MEMORY the heap is unchanged.
+ContainerStatus radix_heap_pop(JRadixHeap *heapptr, int *id);
+
+// tests
+
+void run_all_heap_tests();
+
+void test_heap_push_pop_sorted();
+void test_heap_build();
+void test_heap_build_duplicate_id();
+void test_heap_build_with_allocator();
+void test_heap_decrease_key();
+void test_heap_contains();
+void test_radix_heap_monotone();
+
+#endif  // PROJECT_HEAP_H
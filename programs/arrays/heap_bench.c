@@ -0,0 +1,142 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>   // for IO
+#include <stdlib.h>  // for malloc
+#include <sys/wait.h>  // for waitpid in the tests
+#include <unistd.h>  // for fork
+#include <time.h>
+#include "array.h"
+#include "array.c"
+#include "heap.h"
+#include "heap.c"
+#include "../allocator/allocator.c"
+
+// Push/pop throughput of JHeap against a linked list kept sorted on
+// insert, and of JRadixHeap against JHeap on a monotone (Dijkstra-like)
+// workload where each push is the last popped priority plus a small step.
+
+typedef struct SortedNode {
+  int priority;
+  int id;
+  struct SortedNode *next;
+} SortedNode;
+
+static void sorted_push(SortedNode **head, int id, int priority) {
+  SortedNode *node = malloc(sizeof(SortedNode));
+  check_address(node);
+  node->priority = priority;
+  node->id = id;
+
+  SortedNode **link = head;
+  while (*link != NULL && (*link)->priority <= priority) {
+    link = &(*link)->next;
+  }
+  node->next = *link;
+  *link = node;
+}
+
+static int sorted_pop(SortedNode **head) {
+  SortedNode *node = *head;
+  int id = node->id;
+  *head = node->next;
+  free(node);
+  return id;
+}
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile int sink;
+
+// fills the queue with n random priorities, then pops everything
+static void bench_fill_drain(int n, bool include_list) {
+  int *priorities = malloc(sizeof(int) * n);
+  check_address(priorities);
+  srand(n);
+  for (int i = 0; i < n; ++i) {
+    priorities[i] = rand();
+  }
+
+  double start = now_ns();
+  JHeap *hptr = heap_new(16);
+  for (int i = 0; i < n; ++i) {
+    heap_push(hptr, i, priorities[i]);
+  }
+  while (!heap_is_empty(hptr)) {
+    sink = heap_pop(hptr);
+  }
+  double heap_mops = 2.0 * n / (now_ns() - start) * 1e3;
+  heap_destroy(hptr);
+
+  if (include_list) {
+    start = now_ns();
+    SortedNode *head = NULL;
+    for (int i = 0; i < n; ++i) {
+      sorted_push(&head, i, priorities[i]);
+    }
+    while (head != NULL) {
+      sink = sorted_pop(&head);
+    }
+    double list_mops = 2.0 * n / (now_ns() - start) * 1e3;
+    printf("%-12s %10d %16.2f %18.4f\n", "fill+drain", n, heap_mops, list_mops);
+  } else {
+    printf("%-12s %10d %16.2f %18s\n", "fill+drain", n, heap_mops, "-");
+  }
+  free(priorities);
+}
+
+// keeps n items queued, popping the minimum and pushing a later one
+static void bench_monotone(int n, int operations) {
+  srand(n);
+  JHeap *hptr = heap_new(n);
+  JRadixHeap *rptr = radix_heap_new();
+  for (int i = 0; i < n; ++i) {
+    int priority = rand() % 1000;
+    heap_push(hptr, i, priority);
+    radix_heap_push(rptr, i, priority);
+  }
+
+  int *steps = malloc(sizeof(int) * operations);
+  check_address(steps);
+  for (int i = 0; i < operations; ++i) {
+    steps[i] = rand() % 1000;
+  }
+
+  double start = now_ns();
+  for (int i = 0; i < operations; ++i) {
+    int priority = heap_peek_priority(hptr);
+    int id = heap_pop(hptr);
+    heap_push(hptr, id, priority + steps[i]);
+  }
+  double heap_mops = 2.0 * operations / (now_ns() - start) * 1e3;
+
+  start = now_ns();
+  for (int i = 0; i < operations; ++i) {
+    int id;
+    radix_heap_pop(rptr, &id);
+    radix_heap_push(rptr, id, rptr->last_popped + steps[i]);
+  }
+  double radix_mops = 2.0 * operations / (now_ns() - start) * 1e3;
+
+  printf("%-12s %10d %16.2f %18.2f\n", "monotone", n, heap_mops, radix_mops);
+
+  free(steps);
+  heap_destroy(hptr);
+  radix_heap_destroy(rptr);
+}
+
+int main(int argc, char* argv[]) {
+  printf("%-12s %10s %16s %18s\n", "workload", "items", "4-ary Mops/s", "sorted list Mops/s");
+  bench_fill_drain(1000, true);
+  bench_fill_drain(10000, true);
+  bench_fill_drain(50000, true);
+  bench_fill_drain(1000000, false);
+
+  printf("\n%-12s %10s %16s %18s\n", "workload", "items", "4-ary Mops/s", "radix Mops/s");
+  bench_monotone(1000, 10000000);
+  bench_monotone(1000000, 10000000);
+
+  return EXIT_SUCCESS;
+}
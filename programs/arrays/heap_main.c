@@ -0,0 +1,41 @@
+#include <stdio.h>   // for IO
+#include <stdlib.h>  // for malloc
+#include <sys/wait.h>  // for waitpid in the tests
+#include <unistd.h>  // for fork
+#include "array.h"
+#include "array.c"
+#include "heap.h"
+#include "heap.c"
+#include "../allocator/allocator.c"
+
+void run_heap_example();
+
+// Implements a 4-ary min-heap priority queue (JHeap) and a radix heap on
+// top of JArray.
+
+int main(int argc, char* argv[]) {
+  run_all_tests();
+  run_all_heap_tests();
+  run_heap_example();
+
+  return EXIT_SUCCESS;
+}
+
+void run_heap_example() {
+  // task ids with their deadlines
+  int ids[] = {0, 1, 2, 3, 4};
+  int deadlines[] = {30, 10, 50, 20, 40};
+
+  JHeap* hptr = heap_build(ids, deadlines, 5);
+
+  printf(" - Task 2 deadline moved up to 5.\n");
+  heap_decrease_key(hptr, 2, 5);
+
+  printf(" - Running tasks by deadline:\n");
+  while (!heap_is_empty(hptr)) {
+    int deadline = heap_peek_priority(hptr);
+    printf("   task %d (deadline %d)\n", heap_pop(hptr), deadline);
+  }
+
+  heap_destroy(hptr);
+}
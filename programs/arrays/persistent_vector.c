@@ -0,0 +1,1357 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+// persistent vector implementation
+
+// Concatenation may leave up to kPersistentExtras more nodes on a level
+// than the fewest that could hold its slots, and leaves nodes with more
+// than kPersistentWidth - kPersistentInvariant slots alone (the RRB
+// search step invariant). Lookups in relaxed nodes then need at most a
+// couple of steps past the radix guess.
+#define kPersistentInvariant 1
+#define kPersistentExtras 2
+
+static JPersistentLeaf *persistent_leaf_new(Allocator *allocator) {
+  JPersistentLeaf *leaf = allocator_allocate(allocator, sizeof(JPersistentLeaf));
+  if (leaf == NULL) {
+    return NULL;
+  }
+  leaf->header.refcount = 1;
+  leaf->header.count = 0;
+  return leaf;
+}
+
+static JPersistentBranch *persistent_branch_new(Allocator *allocator) {
+  JPersistentBranch *branch = allocator_allocate(allocator, sizeof(JPersistentBranch));
+  if (branch == NULL) {
+    return NULL;
+  }
+  branch->header.refcount = 1;
+  branch->header.count = 0;
+  branch->relaxed = false;
+  return branch;
+}
+
+static inline void persistent_node_retain(JPersistentNode *node) {
+  __atomic_fetch_add(&node->refcount, 1, __ATOMIC_RELAXED);
+}
+
+// Only this version can reach node, so it may be changed in place. The
+// acquire pairs with the release in persistent_node_release: whatever a
+// version that just let go of node did with it happens before our writes.
+static inline bool persistent_node_is_unique(JPersistentNode *node) {
+  return __atomic_load_n(&node->refcount, __ATOMIC_ACQUIRE) == 1;
+}
+
+// Drops one reference to node, the root of a subtree of height shift,
+// and frees whatever is no longer used.
+static void persistent_node_release(Allocator *allocator, JPersistentNode *node, int shift) {
+  if (node == NULL || __atomic_sub_fetch(&node->refcount, 1, __ATOMIC_ACQ_REL) != 0) {
+    return;
+  }
+  if (shift == 0) {
+    allocator_release(allocator, node, sizeof(JPersistentLeaf));
+    return;
+  }
+  JPersistentBranch *branch = (JPersistentBranch *)node;
+  for (int i = 0; i < node->count; ++i) {
+    persistent_node_release(allocator, branch->children[i], shift - kPersistentBits);
+  }
+  allocator_release(allocator, branch, sizeof(JPersistentBranch));
+}
+
+// Number of items under node.
+static int persistent_node_size(const JPersistentNode *node, int shift) {
+  int size = 0;
+  while (shift > 0) {
+    const JPersistentBranch *branch = (const JPersistentBranch *)node;
+    int last = node->count - 1;
+    if (branch->relaxed) {
+      return size + branch->sizes[last];
+    }
+    size += last << shift;
+    node = branch->children[last];
+    shift -= kPersistentBits;
+  }
+  return size + node->count;
+}
+
+// Recomputes sizes after the children of branch changed, and whether it
+// still has to be relaxed.
+static void persistent_branch_fix_sizes(JPersistentBranch *branch, int shift) {
+  int last = branch->header.count - 1;
+  int total = 0;
+  bool relaxed = false;
+  for (int i = 0; i <= last; ++i) {
+    int size = persistent_node_size(branch->children[i], shift - kPersistentBits);
+    total += size;
+    branch->sizes[i] = total;
+    relaxed |= i < last && size != 1 << shift;
+  }
+  branch->relaxed = relaxed;
+}
+
+// Picks the child of branch holding item *index and makes *index relative
+// to that child. Children of a relaxed branch hold at most as many items
+// as balanced ones, so the radix guess is never past the right child.
+static inline int persistent_branch_child_index(const JPersistentBranch *branch, int shift, int *index) {
+  int child = *index >> shift;
+  if (branch->relaxed) {
+    while (branch->sizes[child] <= *index) {
+      ++child;
+    }
+    if (child > 0) {
+      *index -= branch->sizes[child - 1];
+    }
+  } else {
+    *index -= child << shift;
+  }
+  return child;
+}
+
+// New leaf with the first count items of leaf.
+static JPersistentLeaf *persistent_leaf_copy(Allocator *allocator, const JPersistentLeaf *leaf, int count) {
+  JPersistentLeaf *copy = persistent_leaf_new(allocator);
+  if (copy == NULL) {
+    return NULL;
+  }
+  memcpy(copy->items, leaf->items, sizeof(int) * count);
+  copy->header.count = count;
+  return copy;
+}
+
+static JPersistentBranch *persistent_branch_copy(Allocator *allocator, const JPersistentBranch *branch) {
+  JPersistentBranch *copy = persistent_branch_new(allocator);
+  if (copy == NULL) {
+    return NULL;
+  }
+  int count = branch->header.count;
+  copy->header.count = count;
+  copy->relaxed = branch->relaxed;
+  memcpy(copy->sizes, branch->sizes, sizeof(int) * count);
+  memcpy(copy->children, branch->children, sizeof(JPersistentNode *) * count);
+  for (int i = 0; i < count; ++i) {
+    persistent_node_retain(copy->children[i]);
+  }
+  return copy;
+}
+
+// Makes *slot a node only this version uses, copying it if it is shared,
+// and returns it. Returns NULL if out of memory, leaving *slot as it was.
+static JPersistentNode *persistent_node_unique(Allocator *allocator, JPersistentNode **slot, int shift) {
+  JPersistentNode *node = *slot;
+  if (persistent_node_is_unique(node)) {
+    return node;
+  }
+  JPersistentNode *copy;
+  if (shift == 0) {
+    copy = (JPersistentNode *)persistent_leaf_copy(allocator, (JPersistentLeaf *)node, node->count);
+  } else {
+    copy = (JPersistentNode *)persistent_branch_copy(allocator, (JPersistentBranch *)node);
+  }
+  if (copy == NULL) {
+    return NULL;
+  }
+  persistent_node_release(allocator, node, shift);
+  *slot = copy;
+  return copy;
+}
+
+// Puts leaf at the bottom of a chain of one-child branches up to height
+// shift. Takes over the caller's reference to leaf unless it returns NULL.
+static JPersistentNode *persistent_node_path(Allocator *allocator, JPersistentNode *leaf, int shift) {
+  JPersistentNode *node = leaf;
+  for (int level = kPersistentBits; level <= shift; level += kPersistentBits) {
+    JPersistentBranch *branch = persistent_branch_new(allocator);
+    if (branch == NULL) {
+      persistent_node_retain(leaf);  // the caller keeps its reference
+      persistent_node_release(allocator, node, level - kPersistentBits);
+      return NULL;
+    }
+    branch->children[0] = node;
+    branch->sizes[0] = leaf->count;
+    branch->header.count = 1;
+    node = &branch->header;
+  }
+  return node;
+}
+
+// Some branch on the right edge under node can take another child.
+static bool persistent_node_has_room(const JPersistentNode *node, int shift) {
+  while (shift > 0) {
+    if (node->count < kPersistentWidth) {
+      return true;
+    }
+    node = ((const JPersistentBranch *)node)->children[node->count - 1];
+    shift -= kPersistentBits;
+  }
+  return false;
+}
+
+// Adds leaf after the last leaf under *slot, as low down as there is room
+// (see persistent_node_has_room, which must hold). Takes over the
+// caller's reference to leaf on success.
+static ContainerStatus persistent_node_append_leaf(Allocator *allocator, JPersistentNode **slot, int shift,
+                                                   JPersistentNode *leaf) {
+  JPersistentBranch *branch = (JPersistentBranch *)persistent_node_unique(allocator, slot, shift);
+  if (branch == NULL) {
+    return CONTAINER_NO_MEMORY;
+  }
+  int last = branch->header.count - 1;
+  int leaf_size = leaf->count;
+  int child_shift = shift - kPersistentBits;
+
+  if (child_shift > 0 && persistent_node_has_room(branch->children[last], child_shift)) {
+    if (persistent_node_append_leaf(allocator, &branch->children[last], child_shift, leaf) != CONTAINER_OK) {
+      return CONTAINER_NO_MEMORY;
+    }
+    branch->sizes[last] += leaf_size;
+    return CONTAINER_OK;
+  }
+
+  // a balanced branch stays balanced only if the child that stops being
+  // the last one is full
+  bool last_full = branch->relaxed || persistent_node_size(branch->children[last], child_shift) == 1 << shift;
+  JPersistentNode *child = persistent_node_path(allocator, leaf, child_shift);
+  if (child == NULL) {
+    return CONTAINER_NO_MEMORY;
+  }
+  branch->children[last + 1] = child;
+  branch->header.count++;
+  if (last_full) {
+    branch->sizes[last + 1] = branch->sizes[last] + leaf_size;
+  } else {
+    persistent_branch_fix_sizes(branch, shift);
+  }
+  return CONTAINER_OK;
+}
+
+// Adds leaf as the last leaf of the tree, growing a new root when the
+// tree is full. Takes over the caller's reference to leaf on success.
+static ContainerStatus persistent_vector_push_leaf(JPersistentVector *vecptr, JPersistentNode *leaf) {
+  if (vecptr->root == NULL) {
+    vecptr->root = leaf;
+    vecptr->shift = 0;
+    return CONTAINER_OK;
+  }
+  if (persistent_node_has_room(vecptr->root, vecptr->shift)) {
+    return persistent_node_append_leaf(vecptr->allocator, &vecptr->root, vecptr->shift, leaf);
+  }
+
+  JPersistentBranch *root = persistent_branch_new(vecptr->allocator);
+  if (root == NULL) {
+    return CONTAINER_NO_MEMORY;
+  }
+  JPersistentNode *path = persistent_node_path(vecptr->allocator, leaf, vecptr->shift);
+  if (path == NULL) {
+    allocator_release(vecptr->allocator, root, sizeof(JPersistentBranch));
+    return CONTAINER_NO_MEMORY;
+  }
+  root->children[0] = vecptr->root;
+  root->children[1] = path;
+  root->header.count = 2;
+  persistent_branch_fix_sizes(root, vecptr->shift + kPersistentBits);
+  vecptr->root = &root->header;
+  vecptr->shift += kPersistentBits;
+  return CONTAINER_OK;
+}
+
+// Makes the tail a leaf only this version uses.
+static ContainerStatus persistent_vector_own_tail(JPersistentVector *vecptr) {
+  if (persistent_node_is_unique(&vecptr->tail->header)) {
+    return CONTAINER_OK;
+  }
+  JPersistentLeaf *copy = persistent_leaf_copy(vecptr->allocator, vecptr->tail, vecptr->tail_count);
+  if (copy == NULL) {
+    return CONTAINER_NO_MEMORY;
+  }
+  persistent_node_release(vecptr->allocator, &vecptr->tail->header, 0);
+  vecptr->tail = copy;
+  return CONTAINER_OK;
+}
+
+// Moves the tail into the tree, leaving no tail. A tail shared with a
+// longer version (after take) has more items than tail_count, so it is
+// trimmed first, or copied if other versions still use it.
+static ContainerStatus persistent_vector_push_tail(JPersistentVector *vecptr) {
+  if (vecptr->tail->header.count != vecptr->tail_count) {
+    if (persistent_vector_own_tail(vecptr) != CONTAINER_OK) {
+      return CONTAINER_NO_MEMORY;
+    }
+    vecptr->tail->header.count = vecptr->tail_count;
+  }
+  if (persistent_vector_push_leaf(vecptr, &vecptr->tail->header) != CONTAINER_OK) {
+    return CONTAINER_NO_MEMORY;
+  }
+  vecptr->tail = NULL;
+  vecptr->tail_count = 0;
+  return CONTAINER_OK;
+}
+
+// Drops one-child branches from the top of the tree.
+static void persistent_vector_collapse(JPersistentVector *vecptr) {
+  while (vecptr->shift > 0 && vecptr->root->count == 1) {
+    JPersistentNode *child = ((JPersistentBranch *)vecptr->root)->children[0];
+    persistent_node_retain(child);
+    persistent_node_release(vecptr->allocator, vecptr->root, vecptr->shift);
+    vecptr->root = child;
+    vecptr->shift -= kPersistentBits;
+  }
+}
+
+static void persistent_vector_check_index(const JPersistentVector *vecptr, int index) {
+  if (index < 0 || index >= vecptr->size) {
+    fprintf(stderr, "Index out of bounds.\n");
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void persistent_vector_check_range(const JPersistentVector *vecptr, int begin, int end) {
+  if (begin < 0 || begin > end || end > vecptr->size) {
+    fprintf(stderr, "Range out of bounds.\n");
+    exit(EXIT_FAILURE);
+  }
+}
+
+void persistent_vector_init(JPersistentVector *vecptr, Allocator *allocator) {
+  vecptr->size = 0;
+  vecptr->shift = 0;
+  vecptr->root = NULL;
+  vecptr->tail = NULL;
+  vecptr->tail_count = 0;
+  vecptr->allocator = allocator != NULL ? allocator : default_allocator();
+}
+
+void persistent_vector_release(JPersistentVector *vecptr) {
+  persistent_node_release(vecptr->allocator, vecptr->root, vecptr->shift);
+  if (vecptr->tail != NULL) {
+    persistent_node_release(vecptr->allocator, &vecptr->tail->header, 0);
+  }
+  persistent_vector_init(vecptr, vecptr->allocator);
+}
+
+void persistent_vector_snapshot(const JPersistentVector *vecptr, JPersistentVector *out) {
+  *out = *vecptr;
+  if (out->root != NULL) {
+    persistent_node_retain(out->root);
+  }
+  if (out->tail != NULL) {
+    persistent_node_retain(&out->tail->header);
+  }
+}
+
+int persistent_vector_size(const JPersistentVector *vecptr) { return vecptr->size; }
+
+int persistent_vector_at(const JPersistentVector *vecptr, int index) {
+  persistent_vector_check_index(vecptr, index);
+
+  int tree_size = vecptr->size - vecptr->tail_count;
+  if (index >= tree_size) {
+    return vecptr->tail->items[index - tree_size];
+  }
+  const JPersistentNode *node = vecptr->root;
+  for (int shift = vecptr->shift; shift > 0; shift -= kPersistentBits) {
+    const JPersistentBranch *branch = (const JPersistentBranch *)node;
+    node = branch->children[persistent_branch_child_index(branch, shift, &index)];
+  }
+  return ((const JPersistentLeaf *)node)->items[index];
+}
+
+const int *persistent_vector_chunk(const JPersistentVector *vecptr, int index, int *count) {
+  persistent_vector_check_index(vecptr, index);
+
+  int tree_size = vecptr->size - vecptr->tail_count;
+  if (index >= tree_size) {
+    *count = vecptr->size - index;
+    return vecptr->tail->items + (index - tree_size);
+  }
+  const JPersistentNode *node = vecptr->root;
+  for (int shift = vecptr->shift; shift > 0; shift -= kPersistentBits) {
+    const JPersistentBranch *branch = (const JPersistentBranch *)node;
+    node = branch->children[persistent_branch_child_index(branch, shift, &index)];
+  }
+  *count = node->count - index;
+  return ((const JPersistentLeaf *)node)->items + index;
+}
+
+static int *persistent_node_copy_to(const JPersistentNode *node, int shift, int *out) {
+  if (shift == 0) {
+    memcpy(out, ((const JPersistentLeaf *)node)->items, sizeof(int) * node->count);
+    return out + node->count;
+  }
+  const JPersistentBranch *branch = (const JPersistentBranch *)node;
+  for (int i = 0; i < node->count; ++i) {
+    out = persistent_node_copy_to(branch->children[i], shift - kPersistentBits, out);
+  }
+  return out;
+}
+
+void persistent_vector_copy_to(const JPersistentVector *vecptr, int *out) {
+  if (vecptr->root != NULL) {
+    out = persistent_node_copy_to(vecptr->root, vecptr->shift, out);
+  }
+  if (vecptr->tail_count > 0) {
+    memcpy(out, vecptr->tail->items, sizeof(int) * vecptr->tail_count);
+  }
+}
+
+ContainerStatus persistent_vector_transient_push(JPersistentVector *vecptr, int item) {
+  if (vecptr->tail_count == kPersistentWidth) {
+    JPersistentLeaf *leaf = persistent_leaf_new(vecptr->allocator);
+    if (leaf == NULL) {
+      return CONTAINER_NO_MEMORY;
+    }
+    if (persistent_vector_push_tail(vecptr) != CONTAINER_OK) {
+      allocator_release(vecptr->allocator, leaf, sizeof(JPersistentLeaf));
+      return CONTAINER_NO_MEMORY;
+    }
+    vecptr->tail = leaf;
+  } else if (vecptr->tail == NULL) {
+    vecptr->tail = persistent_leaf_new(vecptr->allocator);
+    if (vecptr->tail == NULL) {
+      return CONTAINER_NO_MEMORY;
+    }
+  } else if (persistent_vector_own_tail(vecptr) != CONTAINER_OK) {
+    return CONTAINER_NO_MEMORY;
+  }
+
+  vecptr->tail->items[vecptr->tail_count++] = item;
+  vecptr->tail->header.count = vecptr->tail_count;
+  vecptr->size++;
+  return CONTAINER_OK;
+}
+
+ContainerStatus persistent_vector_transient_set(JPersistentVector *vecptr, int index, int item) {
+  persistent_vector_check_index(vecptr, index);
+
+  int tree_size = vecptr->size - vecptr->tail_count;
+  if (index >= tree_size) {
+    if (persistent_vector_own_tail(vecptr) != CONTAINER_OK) {
+      return CONTAINER_NO_MEMORY;
+    }
+    vecptr->tail->items[index - tree_size] = item;
+    return CONTAINER_OK;
+  }
+
+  // copy the shared part of the path; once one node on it is ours, the
+  // rest below it can only be shared with older versions through it
+  JPersistentNode **slot = &vecptr->root;
+  for (int shift = vecptr->shift; shift > 0; shift -= kPersistentBits) {
+    JPersistentBranch *branch = (JPersistentBranch *)persistent_node_unique(vecptr->allocator, slot, shift);
+    if (branch == NULL) {
+      return CONTAINER_NO_MEMORY;
+    }
+    slot = &branch->children[persistent_branch_child_index(branch, shift, &index)];
+  }
+  JPersistentLeaf *leaf = (JPersistentLeaf *)persistent_node_unique(vecptr->allocator, slot, 0);
+  if (leaf == NULL) {
+    return CONTAINER_NO_MEMORY;
+  }
+  leaf->items[index] = item;
+  return CONTAINER_OK;
+}
+
+ContainerStatus persistent_vector_push(const JPersistentVector *vecptr, int item, JPersistentVector *out) {
+  persistent_vector_snapshot(vecptr, out);
+  if (persistent_vector_transient_push(out, item) != CONTAINER_OK) {
+    persistent_vector_release(out);
+    return CONTAINER_NO_MEMORY;
+  }
+  return CONTAINER_OK;
+}
+
+ContainerStatus persistent_vector_set(const JPersistentVector *vecptr, int index, int item, JPersistentVector *out) {
+  persistent_vector_snapshot(vecptr, out);
+  if (persistent_vector_transient_set(out, index, item) != CONTAINER_OK) {
+    persistent_vector_release(out);
+    return CONTAINER_NO_MEMORY;
+  }
+  return CONTAINER_OK;
+}
+
+// The first count items under node, where count ends on a leaf boundary.
+// Copies the right edge down to that leaf and shares everything left of it.
+static JPersistentNode *persistent_node_take(Allocator *allocator, JPersistentNode *node, int shift, int count) {
+  if (count == persistent_node_size(node, shift)) {
+    persistent_node_retain(node);
+    return node;
+  }
+  const JPersistentBranch *branch = (const JPersistentBranch *)node;
+  int index = count - 1;
+  int child = persistent_branch_child_index(branch, shift, &index);
+
+  JPersistentBranch *copy = persistent_branch_new(allocator);
+  if (copy == NULL) {
+    return NULL;
+  }
+  JPersistentNode *last = persistent_node_take(allocator, branch->children[child], shift - kPersistentBits, index + 1);
+  if (last == NULL) {
+    allocator_release(allocator, copy, sizeof(JPersistentBranch));
+    return NULL;
+  }
+  for (int i = 0; i < child; ++i) {
+    copy->children[i] = branch->children[i];
+    persistent_node_retain(copy->children[i]);
+  }
+  copy->children[child] = last;
+  copy->header.count = child + 1;
+  // a prefix of a balanced branch is balanced
+  copy->relaxed = branch->relaxed;
+  memcpy(copy->sizes, branch->sizes, sizeof(int) * child);
+  copy->sizes[child] = count;
+  return &copy->header;
+}
+
+// node without its first dropped items, dropped < size of node. Copies the
+// left edge down to the first kept item and shares everything right of it.
+static JPersistentNode *persistent_node_drop(Allocator *allocator, JPersistentNode *node, int shift, int dropped) {
+  if (dropped == 0) {
+    persistent_node_retain(node);
+    return node;
+  }
+  if (shift == 0) {
+    JPersistentLeaf *leaf = persistent_leaf_new(allocator);
+    if (leaf == NULL) {
+      return NULL;
+    }
+    leaf->header.count = node->count - dropped;
+    memcpy(leaf->items, ((JPersistentLeaf *)node)->items + dropped, sizeof(int) * leaf->header.count);
+    return &leaf->header;
+  }
+  const JPersistentBranch *branch = (const JPersistentBranch *)node;
+  int index = dropped;
+  int child = persistent_branch_child_index(branch, shift, &index);
+
+  JPersistentBranch *copy = persistent_branch_new(allocator);
+  if (copy == NULL) {
+    return NULL;
+  }
+  JPersistentNode *first = persistent_node_drop(allocator, branch->children[child], shift - kPersistentBits, index);
+  if (first == NULL) {
+    allocator_release(allocator, copy, sizeof(JPersistentBranch));
+    return NULL;
+  }
+  copy->children[0] = first;
+  copy->header.count = node->count - child;
+  for (int i = 1; i < copy->header.count; ++i) {
+    copy->children[i] = branch->children[child + i];
+    persistent_node_retain(copy->children[i]);
+  }
+  if (branch->relaxed) {
+    copy->relaxed = true;
+    for (int i = 0; i < copy->header.count; ++i) {
+      copy->sizes[i] = branch->sizes[child + i] - dropped;
+    }
+  } else {
+    persistent_branch_fix_sizes(copy, shift);
+  }
+  return &copy->header;
+}
+
+ContainerStatus persistent_vector_take(const JPersistentVector *vecptr, int count, JPersistentVector *out) {
+  persistent_vector_check_range(vecptr, 0, count);
+  if (count == vecptr->size) {
+    persistent_vector_snapshot(vecptr, out);
+    return CONTAINER_OK;
+  }
+  persistent_vector_init(out, vecptr->allocator);
+  if (count == 0) {
+    return CONTAINER_OK;
+  }
+
+  int tree_size = vecptr->size - vecptr->tail_count;
+  if (count > tree_size) {
+    // share the whole tail and ignore its last items
+    persistent_vector_snapshot(vecptr, out);
+    out->tail_count = count - tree_size;
+    out->size = count;
+    return CONTAINER_OK;
+  }
+
+  // the leaf holding the last kept item becomes the tail
+  JPersistentNode *node = vecptr->root;
+  int index = count - 1;
+  for (int shift = vecptr->shift; shift > 0; shift -= kPersistentBits) {
+    const JPersistentBranch *branch = (const JPersistentBranch *)node;
+    node = branch->children[persistent_branch_child_index(branch, shift, &index)];
+  }
+  int leaf_start = count - 1 - index;
+  if (leaf_start > 0) {
+    out->root = persistent_node_take(vecptr->allocator, vecptr->root, vecptr->shift, leaf_start);
+    if (out->root == NULL) {
+      return CONTAINER_NO_MEMORY;
+    }
+    out->shift = vecptr->shift;
+    persistent_vector_collapse(out);
+  }
+  persistent_node_retain(node);
+  out->tail = (JPersistentLeaf *)node;
+  out->tail_count = index + 1;
+  out->size = count;
+  return CONTAINER_OK;
+}
+
+ContainerStatus persistent_vector_drop(const JPersistentVector *vecptr, int count, JPersistentVector *out) {
+  persistent_vector_check_range(vecptr, count, vecptr->size);
+  if (count == 0) {
+    persistent_vector_snapshot(vecptr, out);
+    return CONTAINER_OK;
+  }
+  persistent_vector_init(out, vecptr->allocator);
+  if (count == vecptr->size) {
+    return CONTAINER_OK;
+  }
+
+  int tree_size = vecptr->size - vecptr->tail_count;
+  if (count >= tree_size) {
+    // what is left is the end of the tail, moved to the front of a new one
+    JPersistentLeaf *tail = persistent_leaf_new(vecptr->allocator);
+    if (tail == NULL) {
+      return CONTAINER_NO_MEMORY;
+    }
+    int kept = vecptr->size - count;
+    memcpy(tail->items, vecptr->tail->items + (count - tree_size), sizeof(int) * kept);
+    tail->header.count = kept;
+    out->tail = tail;
+    out->tail_count = kept;
+    out->size = kept;
+    return CONTAINER_OK;
+  }
+
+  out->root = persistent_node_drop(vecptr->allocator, vecptr->root, vecptr->shift, count);
+  if (out->root == NULL) {
+    return CONTAINER_NO_MEMORY;
+  }
+  out->shift = vecptr->shift;
+  out->tail = vecptr->tail;
+  persistent_node_retain(&out->tail->header);
+  out->tail_count = vecptr->tail_count;
+  out->size = vecptr->size - count;
+  persistent_vector_collapse(out);
+  return CONTAINER_OK;
+}
+
+ContainerStatus persistent_vector_slice(const JPersistentVector *vecptr, int begin, int end, JPersistentVector *out) {
+  persistent_vector_check_range(vecptr, begin, end);
+  JPersistentVector prefix;
+  if (persistent_vector_take(vecptr, end, &prefix) != CONTAINER_OK) {
+    persistent_vector_init(out, vecptr->allocator);
+    return CONTAINER_NO_MEMORY;
+  }
+  ContainerStatus status = persistent_vector_drop(&prefix, begin, out);
+  persistent_vector_release(&prefix);
+  return status;
+}
+
+// Picks how many slots (items of a leaf, children of a branch) each node
+// of the merged level gets. Starting from the current counts, the first
+// node short of the invariant is spread over the nodes after it until one
+// node's worth of slots is gone, until the level is within
+// kPersistentExtras of the fewest nodes possible. Returns the node count.
+static int persistent_concat_plan(JPersistentNode *const *all, int all_count, int *plan) {
+  int total = 0;
+  for (int i = 0; i < all_count; ++i) {
+    plan[i] = all[i]->count;
+    total += plan[i];
+  }
+  int optimal = (total - 1) / kPersistentWidth + 1;
+
+  int count = all_count;
+  int i = 0;
+  while (count > optimal + kPersistentExtras) {
+    while (plan[i] > kPersistentWidth - kPersistentInvariant) {
+      ++i;
+    }
+    int remaining = plan[i];
+    do {
+      int size = remaining + plan[i + 1] < kPersistentWidth ? remaining + plan[i + 1] : kPersistentWidth;
+      remaining += plan[i + 1] - size;
+      plan[i] = size;
+      ++i;
+    } while (remaining > 0);
+    for (int j = i; j < count - 1; ++j) {
+      plan[j] = plan[j + 1];
+    }
+    --count;
+    --i;
+  }
+  return count;
+}
+
+// Builds the nodes of plan, at height shift, from the slots of all in
+// order. A node whose slots all come from one old node in place is that
+// node, shared. Returns false if out of memory.
+static bool persistent_concat_execute(Allocator *allocator, JPersistentNode *const *all, const int *plan,
+                                      int plan_count, int shift, JPersistentNode **merged) {
+  int source = 0;
+  int offset = 0;
+  for (int i = 0; i < plan_count; ++i) {
+    if (offset == 0 && all[source]->count == plan[i]) {
+      merged[i] = all[source++];
+      persistent_node_retain(merged[i]);
+      continue;
+    }
+
+    JPersistentNode *node = shift == 0 ? (JPersistentNode *)persistent_leaf_new(allocator)
+                                       : (JPersistentNode *)persistent_branch_new(allocator);
+    if (node == NULL) {
+      for (int j = 0; j < i; ++j) {
+        persistent_node_release(allocator, merged[j], shift);
+      }
+      return false;
+    }
+    while (node->count < plan[i]) {
+      const JPersistentNode *old = all[source];
+      int moved = old->count - offset;
+      if (moved > plan[i] - node->count) {
+        moved = plan[i] - node->count;
+      }
+      if (shift == 0) {
+        memcpy(((JPersistentLeaf *)node)->items + node->count, ((const JPersistentLeaf *)old)->items + offset,
+               sizeof(int) * moved);
+      } else {
+        for (int k = 0; k < moved; ++k) {
+          JPersistentNode *child = ((const JPersistentBranch *)old)->children[offset + k];
+          persistent_node_retain(child);
+          ((JPersistentBranch *)node)->children[node->count + k] = child;
+        }
+      }
+      node->count += moved;
+      offset += moved;
+      if (offset == old->count) {
+        ++source;
+        offset = 0;
+      }
+    }
+    if (shift > 0) {
+      persistent_branch_fix_sizes((JPersistentBranch *)node, shift);
+    }
+    merged[i] = node;
+  }
+  return true;
+}
+
+// Merges the children of left (but its last), middle and right (but its
+// first), all branches at height shift, into as few nodes as the plan
+// allows. Returns a branch one level up holding the one or two branches
+// these fill. left and right may be NULL.
+static JPersistentBranch *persistent_node_rebalance(Allocator *allocator, const JPersistentBranch *left,
+                                                    const JPersistentBranch *middle, const JPersistentBranch *right,
+                                                    int shift) {
+  JPersistentNode *all[2 * kPersistentWidth];
+  int all_count = 0;
+  for (int i = 0; left != NULL && i < left->header.count - 1; ++i) {
+    all[all_count++] = left->children[i];
+  }
+  for (int i = 0; i < middle->header.count; ++i) {
+    all[all_count++] = middle->children[i];
+  }
+  for (int i = 1; right != NULL && i < right->header.count; ++i) {
+    all[all_count++] = right->children[i];
+  }
+
+  int plan[2 * kPersistentWidth];
+  int plan_count = persistent_concat_plan(all, all_count, plan);
+
+  JPersistentBranch *top = persistent_branch_new(allocator);
+  JPersistentBranch *halves[2] = {persistent_branch_new(allocator), NULL};
+  if (plan_count > kPersistentWidth) {
+    halves[1] = persistent_branch_new(allocator);
+  }
+  JPersistentNode *merged[2 * kPersistentWidth];
+  if (top == NULL || halves[0] == NULL || (plan_count > kPersistentWidth && halves[1] == NULL) ||
+      !persistent_concat_execute(allocator, all, plan, plan_count, shift - kPersistentBits, merged)) {
+    JPersistentBranch *unused[3] = {top, halves[0], halves[1]};
+    for (int i = 0; i < 3; ++i) {
+      if (unused[i] != NULL) {
+        allocator_release(allocator, unused[i], sizeof(JPersistentBranch));
+      }
+    }
+    return NULL;
+  }
+
+  for (int i = 0; i < plan_count; ++i) {
+    JPersistentBranch *half = halves[i / kPersistentWidth];
+    half->children[half->header.count++] = merged[i];
+  }
+  for (int h = 0; h < 2 && halves[h] != NULL; ++h) {
+    persistent_branch_fix_sizes(halves[h], shift);
+    top->children[top->header.count++] = &halves[h]->header;
+  }
+  persistent_branch_fix_sizes(top, shift + kPersistentBits);
+  return top;
+}
+
+// Joins the trees left and right, walking down the right edge of left and
+// the left edge of right and merging the nodes where they meet. Returns a
+// branch one level above the taller tree holding one or two children.
+// Neither tree is changed.
+static JPersistentBranch *persistent_node_concat(Allocator *allocator, JPersistentNode *left, int left_shift,
+                                                 JPersistentNode *right, int right_shift) {
+  if (left_shift == 0 && right_shift == 0) {
+    JPersistentBranch *pair = persistent_branch_new(allocator);
+    if (pair == NULL) {
+      return NULL;
+    }
+    pair->children[0] = left;
+    pair->children[1] = right;
+    pair->header.count = 2;
+    persistent_node_retain(left);
+    persistent_node_retain(right);
+    persistent_branch_fix_sizes(pair, kPersistentBits);
+    return pair;
+  }
+
+  const JPersistentBranch *left_branch = NULL;
+  const JPersistentBranch *right_branch = NULL;
+  JPersistentNode *left_edge = left;
+  JPersistentNode *right_edge = right;
+  int shift = left_shift > right_shift ? left_shift : right_shift;
+  if (left_shift == shift) {
+    left_branch = (const JPersistentBranch *)left;
+    left_edge = left_branch->children[left->count - 1];
+    left_shift -= kPersistentBits;
+  }
+  if (right_shift == shift) {
+    right_branch = (const JPersistentBranch *)right;
+    right_edge = right_branch->children[0];
+    right_shift -= kPersistentBits;
+  }
+
+  JPersistentBranch *middle = persistent_node_concat(allocator, left_edge, left_shift, right_edge, right_shift);
+  if (middle == NULL) {
+    return NULL;
+  }
+  JPersistentBranch *merged = persistent_node_rebalance(allocator, left_branch, middle, right_branch, shift);
+  persistent_node_release(allocator, &middle->header, shift);
+  return merged;
+}
+
+ContainerStatus persistent_vector_concat(const JPersistentVector *left, const JPersistentVector *right,
+                                         JPersistentVector *out) {
+  if (left->allocator != right->allocator) {
+    fprintf(stderr, "Persistent vectors use different allocators.\n");
+    exit(EXIT_FAILURE);
+  }
+  if (left->size == 0) {
+    persistent_vector_snapshot(right, out);
+    return CONTAINER_OK;
+  }
+  persistent_vector_snapshot(left, out);
+  if (right->root == NULL) {
+    // right is at most one leaf; appending it is cheaper than merging
+    for (int i = 0; i < right->tail_count; ++i) {
+      if (persistent_vector_transient_push(out, right->tail->items[i]) != CONTAINER_OK) {
+        persistent_vector_release(out);
+        return CONTAINER_NO_MEMORY;
+      }
+    }
+    return CONTAINER_OK;
+  }
+
+  // the left tail, even if short, becomes the last leaf of the left tree;
+  // the right tail stays the tail
+  if (persistent_vector_push_tail(out) != CONTAINER_OK) {
+    persistent_vector_release(out);
+    return CONTAINER_NO_MEMORY;
+  }
+  int shift = (out->shift > right->shift ? out->shift : right->shift) + kPersistentBits;
+  JPersistentBranch *root = persistent_node_concat(out->allocator, out->root, out->shift, right->root, right->shift);
+  if (root == NULL) {
+    persistent_vector_release(out);
+    return CONTAINER_NO_MEMORY;
+  }
+  persistent_node_release(out->allocator, out->root, out->shift);
+  out->root = &root->header;
+  out->shift = shift;
+  out->tail = right->tail;
+  persistent_node_retain(&out->tail->header);
+  out->tail_count = right->tail_count;
+  out->size = left->size + right->size;
+  persistent_vector_collapse(out);
+  return CONTAINER_OK;
+}
+
+//=========== tests ===================================
+
+void run_all_persistent_vector_tests() {
+  test_persistent_vector_push_at();
+  test_persistent_vector_versions_are_independent();
+  test_persistent_vector_transient_copies_once();
+  test_persistent_vector_slices();
+  test_persistent_vector_concat();
+  test_persistent_vector_random_against_array();
+  test_persistent_vector_reader_threads();
+  test_persistent_vector_out_of_memory();
+}
+
+// Walks the tree checking counts, sizes tables and balanced branches, and
+// returns the number of items under node.
+static int persistent_node_check(const JPersistentNode *node, int shift) {
+  assert(node->refcount >= 1);
+  assert(node->count >= 1 && node->count <= kPersistentWidth);
+  if (shift == 0) {
+    return node->count;
+  }
+  const JPersistentBranch *branch = (const JPersistentBranch *)node;
+  int total = 0;
+  for (int i = 0; i < node->count; ++i) {
+    int size = persistent_node_check(branch->children[i], shift - kPersistentBits);
+    total += size;
+    if (branch->relaxed) {
+      assert(branch->sizes[i] == total);
+    } else if (i < node->count - 1) {
+      assert(size == 1 << shift);
+    }
+  }
+  return total;
+}
+
+static void persistent_vector_check(const JPersistentVector *vecptr) {
+  int tree_size = vecptr->root != NULL ? persistent_node_check(vecptr->root, vecptr->shift) : 0;
+  assert(tree_size + vecptr->tail_count == vecptr->size);
+  assert((vecptr->tail_count > 0) == (vecptr->size > 0));
+  assert(vecptr->tail_count <= kPersistentWidth);
+}
+
+static void persistent_vector_assert_items(const JPersistentVector *vecptr, const int *expected, int count) {
+  persistent_vector_check(vecptr);
+  assert(persistent_vector_size(vecptr) == count);
+  int *items = malloc(sizeof(int) * (count + 1));
+  persistent_vector_copy_to(vecptr, items);
+  assert(memcmp(items, expected, sizeof(int) * count) == 0);
+  free(items);
+  for (int i = 0; i < count; i += 1 + count / 64) {
+    assert(persistent_vector_at(vecptr, i) == expected[i]);
+  }
+  // from an index in the middle of a leaf, then leaf by leaf
+  for (int i = count / 3, chunk; i < count; i += chunk) {
+    const int *items = persistent_vector_chunk(vecptr, i, &chunk);
+    assert(memcmp(items, expected + i, sizeof(int) * chunk) == 0);
+  }
+}
+
+static void persistent_vector_fill(JPersistentVector *vecptr, int first, int count) {
+  for (int i = 0; i < count; ++i) {
+    assert(persistent_vector_transient_push(vecptr, first + i) == CONTAINER_OK);
+  }
+}
+
+void test_persistent_vector_push_at() {
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+
+  // one leaf, two levels and three levels of tree
+  const int sizes[] = {1, 32, 33, 1024 + 32, 1024 + 33, 40000};
+  for (int s = 0; s < 6; ++s) {
+    JPersistentVector vec;
+    persistent_vector_init(&vec, &tracker.allocator);
+    persistent_vector_fill(&vec, 0, sizes[s]);
+    persistent_vector_check(&vec);
+    for (int i = 0; i < sizes[s]; ++i) {
+      assert(persistent_vector_at(&vec, i) == i);
+    }
+    int expected = 0;
+    for (int i = 0, count; i < sizes[s]; i += count) {
+      const int *items = persistent_vector_chunk(&vec, i, &count);
+      assert(count >= 1 && count <= kPersistentWidth);
+      for (int k = 0; k < count; ++k) {
+        assert(items[k] == expected++);
+      }
+    }
+    assert(expected == sizes[s]);
+    persistent_vector_release(&vec);
+    assert(persistent_vector_size(&vec) == 0);
+  }
+  assert(tracker.bytes_live == 0);
+}
+
+void test_persistent_vector_versions_are_independent() {
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+
+  JPersistentVector versions[101];
+  persistent_vector_init(&versions[0], &tracker.allocator);
+  persistent_vector_fill(&versions[0], 0, 5000);
+  // each version changes one item of the one before
+  for (int v = 1; v <= 100; ++v) {
+    assert(persistent_vector_set(&versions[v - 1], v * 37, -v, &versions[v]) == CONTAINER_OK);
+  }
+  for (int v = 0; v <= 100; ++v) {
+    for (int w = 1; w <= 100; ++w) {
+      assert(persistent_vector_at(&versions[v], w * 37) == (w <= v ? -w : w * 37));
+    }
+  }
+
+  // a push does not show in the version it came from
+  JPersistentVector longer;
+  assert(persistent_vector_push(&versions[100], 7, &longer) == CONTAINER_OK);
+  assert(persistent_vector_size(&longer) == 5001);
+  assert(persistent_vector_size(&versions[100]) == 5000);
+  assert(persistent_vector_at(&longer, 5000) == 7);
+
+  // releasing versions in any order frees exactly what they alone used
+  for (int v = 0; v <= 100; v += 2) {
+    persistent_vector_release(&versions[v]);
+  }
+  assert(persistent_vector_at(&versions[99], 99 * 37) == -99);
+  for (int v = 1; v <= 100; v += 2) {
+    persistent_vector_release(&versions[v]);
+  }
+  persistent_vector_release(&longer);
+  assert(tracker.bytes_live == 0);
+}
+
+void test_persistent_vector_transient_copies_once() {
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+
+  JPersistentVector vec;
+  persistent_vector_init(&vec, &tracker.allocator);
+  persistent_vector_fill(&vec, 0, 1 << 15);  // a full three level tree
+
+  JPersistentVector reader;
+  persistent_vector_snapshot(&vec, &reader);
+  size_t allocations = tracker.allocations;
+  for (int i = 0; i < 32; ++i) {
+    assert(persistent_vector_transient_set(&vec, i, -i) == CONTAINER_OK);
+  }
+  // the root, one branch and one leaf, copied for the first set only
+  assert(tracker.allocations - allocations == 3);
+  for (int i = 0; i < 32; ++i) {
+    assert(persistent_vector_at(&vec, i) == -i);
+    assert(persistent_vector_at(&reader, i) == i);
+  }
+
+  // once the reader lets go, nothing is shared and sets copy nothing
+  persistent_vector_release(&reader);
+  allocations = tracker.allocations;
+  for (int i = 0; i < 1 << 15; i += 1000) {
+    assert(persistent_vector_transient_set(&vec, i, 0) == CONTAINER_OK);
+  }
+  assert(tracker.allocations == allocations);
+
+  persistent_vector_release(&vec);
+  assert(tracker.bytes_live == 0);
+}
+
+void test_persistent_vector_slices() {
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+
+  const int kCount = 3000;
+  int *expected = malloc(sizeof(int) * kCount);
+  for (int i = 0; i < kCount; ++i) {
+    expected[i] = i;
+  }
+  JPersistentVector vec;
+  persistent_vector_init(&vec, &tracker.allocator);
+  persistent_vector_fill(&vec, 0, kCount);
+
+  const int cuts[] = {0, 1, 31, 32, 33, 1000, 1024, 1025, 2975, 2976, 2990, 2999, 3000};
+  for (int b = 0; b < 13; ++b) {
+    for (int e = b; e < 13; ++e) {
+      JPersistentVector slice;
+      assert(persistent_vector_slice(&vec, cuts[b], cuts[e], &slice) == CONTAINER_OK);
+      persistent_vector_assert_items(&slice, expected + cuts[b], cuts[e] - cuts[b]);
+
+      // a slice can keep growing without touching the vector it came from
+      persistent_vector_fill(&slice, -100, 40);
+      assert(persistent_vector_at(&slice, cuts[e] - cuts[b]) == -100);
+      persistent_vector_release(&slice);
+    }
+  }
+  persistent_vector_assert_items(&vec, expected, kCount);
+  persistent_vector_release(&vec);
+  free(expected);
+  assert(tracker.bytes_live == 0);
+}
+
+void test_persistent_vector_concat() {
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+
+  // joins of every pair of shapes: tail only, one leaf, one and two full
+  // branch levels, and the ragged ones in between
+  const int sizes[] = {0, 5, 32, 40, 1000, 1056, 1057, 33000};
+  int *expected = malloc(sizeof(int) * 2 * 33000);
+  for (int l = 0; l < 8; ++l) {
+    for (int r = 0; r < 8; ++r) {
+      JPersistentVector left, right, joined;
+      persistent_vector_init(&left, &tracker.allocator);
+      persistent_vector_init(&right, &tracker.allocator);
+      persistent_vector_fill(&left, 0, sizes[l]);
+      persistent_vector_fill(&right, sizes[l], sizes[r]);
+      assert(persistent_vector_concat(&left, &right, &joined) == CONTAINER_OK);
+      for (int i = 0; i < sizes[l] + sizes[r]; ++i) {
+        expected[i] = i;
+      }
+      persistent_vector_assert_items(&joined, expected, sizes[l] + sizes[r]);
+      persistent_vector_assert_items(&left, expected, sizes[l]);
+      persistent_vector_release(&left);
+      persistent_vector_release(&right);
+      persistent_vector_release(&joined);
+    }
+  }
+
+  // many small joins keep the tree shallow
+  JPersistentVector all;
+  persistent_vector_init(&all, &tracker.allocator);
+  int count = 0;
+  for (int part = 0; part < 2000; ++part) {
+    JPersistentVector piece, joined;
+    persistent_vector_init(&piece, &tracker.allocator);
+    persistent_vector_fill(&piece, count, 1 + part % 45);
+    assert(persistent_vector_concat(&all, &piece, &joined) == CONTAINER_OK);
+    count += 1 + part % 45;
+    persistent_vector_release(&all);
+    persistent_vector_release(&piece);
+    all = joined;
+  }
+  for (int i = 0; i < count; ++i) {
+    expected[i] = i;
+  }
+  persistent_vector_assert_items(&all, expected, count);
+  assert(all.shift <= 3 * kPersistentBits);
+  persistent_vector_release(&all);
+
+  free(expected);
+  assert(tracker.bytes_live == 0);
+}
+
+static unsigned int persistent_vector_test_random(unsigned int *state) {
+  *state = *state * 1103515245u + 12345u;
+  return *state >> 8;
+}
+
+// Random pushes, sets, slices and joins on a handful of versions at once,
+// each followed by a comparison with plain arrays doing the same thing.
+void test_persistent_vector_random_against_array() {
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+
+  enum { kVersions = 6, kMaxItems = 60000, kSteps = 3000 };
+  JPersistentVector versions[kVersions];
+  int *models[kVersions];
+  int sizes[kVersions];
+  for (int v = 0; v < kVersions; ++v) {
+    persistent_vector_init(&versions[v], &tracker.allocator);
+    models[v] = malloc(sizeof(int) * kMaxItems);
+    sizes[v] = 0;
+  }
+  int *scratch = malloc(sizeof(int) * kMaxItems);
+
+  unsigned int state = 7;
+  for (int step = 0; step < kSteps; ++step) {
+    int from = persistent_vector_test_random(&state) % kVersions;
+    int to = persistent_vector_test_random(&state) % kVersions;
+    int other = persistent_vector_test_random(&state) % kVersions;
+    int size = sizes[from];
+    JPersistentVector result;
+    int result_size;
+
+    switch (persistent_vector_test_random(&state) % 6) {
+      case 0: {  // a batch of pushes
+        int pushes = persistent_vector_test_random(&state) % 200;
+        if (size + pushes > kMaxItems) {
+          pushes = kMaxItems - size;
+        }
+        persistent_vector_snapshot(&versions[from], &result);
+        memcpy(scratch, models[from], sizeof(int) * size);
+        for (int i = 0; i < pushes; ++i) {
+          assert(persistent_vector_transient_push(&result, step * 1000 + i) == CONTAINER_OK);
+          scratch[size + i] = step * 1000 + i;
+        }
+        result_size = size + pushes;
+        break;
+      }
+      case 1: {  // a batch of sets
+        persistent_vector_snapshot(&versions[from], &result);
+        memcpy(scratch, models[from], sizeof(int) * size);
+        for (int i = 0; size > 0 && i < 20; ++i) {
+          int index = persistent_vector_test_random(&state) % size;
+          assert(persistent_vector_transient_set(&result, index, -step) == CONTAINER_OK);
+          scratch[index] = -step;
+        }
+        result_size = size;
+        break;
+      }
+      case 2: {  // a slice
+        int begin = size > 0 ? persistent_vector_test_random(&state) % (size + 1) : 0;
+        int end = begin + persistent_vector_test_random(&state) % (size - begin + 1);
+        assert(persistent_vector_slice(&versions[from], begin, end, &result) == CONTAINER_OK);
+        memcpy(scratch, models[from] + begin, sizeof(int) * (end - begin));
+        result_size = end - begin;
+        break;
+      }
+      default: {  // a join, halving the right side if it would be too long
+        JPersistentVector right;
+        int right_size = sizes[other];
+        if (size + right_size > kMaxItems) {
+          right_size = (kMaxItems - size) / 2;
+        }
+        assert(persistent_vector_take(&versions[other], right_size, &right) == CONTAINER_OK);
+        assert(persistent_vector_concat(&versions[from], &right, &result) == CONTAINER_OK);
+        memcpy(scratch, models[from], sizeof(int) * size);
+        memcpy(scratch + size, models[other], sizeof(int) * right_size);
+        result_size = size + right_size;
+        persistent_vector_release(&right);
+        break;
+      }
+    }
+
+    persistent_vector_release(&versions[to]);
+    versions[to] = result;
+    memcpy(models[to], scratch, sizeof(int) * result_size);
+    sizes[to] = result_size;
+    for (int v = 0; v < kVersions; ++v) {
+      persistent_vector_assert_items(&versions[v], models[v], sizes[v]);
+    }
+  }
+
+  for (int v = 0; v < kVersions; ++v) {
+    persistent_vector_release(&versions[v]);
+    free(models[v]);
+  }
+  free(scratch);
+  assert(tracker.bytes_live == 0);
+}
+
+typedef struct PersistentVectorTestShared {
+  pthread_mutex_t lock;
+  JPersistentVector published;
+  bool done;
+} PersistentVectorTestShared;
+
+// Sums every snapshot the writer publishes. The writer only pushes
+// item i at index i and moves amounts between two items, so a consistent
+// view of n items sums to n(n-1)/2.
+static void *persistent_vector_test_reader(void *arg) {
+  PersistentVectorTestShared *shared = arg;
+  long long views = 0;
+  for (;;) {
+    JPersistentVector view;
+    pthread_mutex_lock(&shared->lock);
+    bool done = shared->done;
+    persistent_vector_snapshot(&shared->published, &view);
+    pthread_mutex_unlock(&shared->lock);
+
+    long long sum = 0;
+    int size = persistent_vector_size(&view);
+    for (int i = 0; i < size; ++i) {
+      sum += persistent_vector_at(&view, i);
+    }
+    assert(sum == (long long)size * (size - 1) / 2);
+    persistent_vector_release(&view);
+    ++views;
+    if (done) {
+      break;
+    }
+  }
+  return (void *)(intptr_t)views;
+}
+
+void test_persistent_vector_reader_threads() {
+  PersistentVectorTestShared shared;
+  pthread_mutex_init(&shared.lock, NULL);
+  persistent_vector_init(&shared.published, NULL);
+  shared.done = false;
+
+  pthread_t readers[3];
+  for (int t = 0; t < 3; ++t) {
+    pthread_create(&readers[t], NULL, persistent_vector_test_reader, &shared);
+  }
+
+  JPersistentVector vec;
+  persistent_vector_init(&vec, NULL);
+  unsigned int state = 11;
+  for (int round = 0; round < 300; ++round) {
+    persistent_vector_fill(&vec, persistent_vector_size(&vec), 100);
+    int size = persistent_vector_size(&vec);
+    for (int k = 0; k < 50; ++k) {
+      int from = persistent_vector_test_random(&state) % size;
+      int to = persistent_vector_test_random(&state) % size;
+      int amount = persistent_vector_test_random(&state) % 1000;
+      persistent_vector_transient_set(&vec, from, persistent_vector_at(&vec, from) - amount);
+      persistent_vector_transient_set(&vec, to, persistent_vector_at(&vec, to) + amount);
+    }
+
+    JPersistentVector old = shared.published;
+    pthread_mutex_lock(&shared.lock);
+    persistent_vector_snapshot(&vec, &shared.published);
+    pthread_mutex_unlock(&shared.lock);
+    persistent_vector_release(&old);
+  }
+  pthread_mutex_lock(&shared.lock);
+  shared.done = true;
+  pthread_mutex_unlock(&shared.lock);
+
+  for (int t = 0; t < 3; ++t) {
+    void *views;
+    pthread_join(readers[t], &views);
+    assert((intptr_t)views >= 1);
+  }
+  persistent_vector_release(&vec);
+  persistent_vector_release(&shared.published);
+  pthread_mutex_destroy(&shared.lock);
+}
+
+void test_persistent_vector_out_of_memory() {
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+
+  JPersistentVector vec;
+  persistent_vector_init(&vec, &tracker.allocator);
+  persistent_vector_fill(&vec, 0, 2000);
+  int *expected = malloc(sizeof(int) * 2000);
+  persistent_vector_copy_to(&vec, expected);
+
+  // every operation, failing at each allocation it makes in turn, leaves
+  // the source intact, *out empty and nothing leaked
+  for (int fail_after = 0; fail_after < 8; ++fail_after) {
+    size_t live = tracker.bytes_live;
+    JPersistentVector out, right;
+    persistent_vector_slice(&vec, 500, 1500, &right);
+
+    tracker.fail_after = fail_after;
+    tracker.allocations = 0;
+    if (persistent_vector_set(&vec, 1000, -1, &out) != CONTAINER_OK) {
+      assert(persistent_vector_size(&out) == 0);
+    }
+    persistent_vector_release(&out);
+    tracker.allocations = 0;
+    if (persistent_vector_drop(&vec, 77, &out) != CONTAINER_OK) {
+      assert(persistent_vector_size(&out) == 0);
+    }
+    persistent_vector_release(&out);
+    tracker.allocations = 0;
+    if (persistent_vector_slice(&vec, 33, 1999, &out) != CONTAINER_OK) {
+      assert(persistent_vector_size(&out) == 0);
+    }
+    persistent_vector_release(&out);
+    tracker.allocations = 0;
+    if (persistent_vector_concat(&vec, &right, &out) != CONTAINER_OK) {
+      assert(persistent_vector_size(&out) == 0);
+    }
+    persistent_vector_release(&out);
+    tracker.fail_after = -1;
+
+    persistent_vector_release(&right);
+    persistent_vector_assert_items(&vec, expected, 2000);
+    assert(tracker.bytes_live == live);
+  }
+
+  // a transient push that fails keeps what was pushed before
+  JPersistentVector snapshot;
+  persistent_vector_snapshot(&vec, &snapshot);
+  tracker.fail_after = 0;
+  tracker.allocations = 0;
+  assert(persistent_vector_transient_push(&vec, 1) == CONTAINER_NO_MEMORY);
+  tracker.fail_after = -1;
+  persistent_vector_assert_items(&vec, expected, 2000);
+
+  persistent_vector_release(&snapshot);
+  persistent_vector_release(&vec);
+  free(expected);
+  assert(tracker.bytes_live == 0);
+}
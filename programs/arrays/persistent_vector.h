@@ -0,0 +1,116 @@
+#ifndef PROJECT_PERSISTENT_VECTOR_H
+#define PROJECT_PERSISTENT_VECTOR_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include "../allocator/allocator.h"
+
+// Branching factor of the tree; kPersistentBits bits of an index per
+// level.
+#define kPersistentBits 5
+#define kPersistentWidth (1 << kPersistentBits)
+
+// Persistent (immutable) vector of ints: a 32-way relaxed radix balanced
+// (RRB) tree plus a tail leaf, with reference counted nodes shared
+// between versions.
+//
+//  - snapshot is O(1): it shares the root and tail, so a reader thread
+//    can keep a consistent view while the writer carries on.
+//  - at and set are O(log32 n). set copies the path to the item, so the
+//    old version is untouched; push usually only touches the tail.
+//  - take, drop and slice share everything but the O(log n) nodes along
+//    the cut. concat merges the two trees along the seam (the RRB
+//    concatenation of Bagwell and Rompf), also O(log n) nodes.
+//  - the transient functions change a vector in place, copying only the
+//    nodes that other versions still share, so a batch of changes to a
+//    fresh snapshot copies each path once rather than once per change.
+//
+// Nodes are freed when the last version using them is released. Node
+// reference counts are atomic, so versions can be read and released from
+// any thread; a JPersistentVector handle itself is not synchronized.
+// Versions derived from one another must share one allocator, and that
+// allocator must be thread safe if they are released on several threads.
+
+typedef struct JWImplementationPersistentNode {
+  int refcount;  // atomic
+  int count;     // items in a leaf, children in a branch
+} JPersistentNode;
+
+typedef struct JWImplementationPersistentLeaf {
+  JPersistentNode header;
+  int items[kPersistentWidth];
+} JPersistentLeaf;
+
+// A branch is balanced when every child but the last holds the most it
+// can, so a child index is just bits of the item index. Otherwise it is
+// relaxed, and sizes[i] is the number of items in children[0..i].
+typedef struct JWImplementationPersistentBranch {
+  JPersistentNode header;
+  bool relaxed;
+  int sizes[kPersistentWidth];
+  JPersistentNode *children[kPersistentWidth];
+} JPersistentBranch;
+
+// A version of the vector. Copy it with persistent_vector_snapshot, not
+// by assignment, so the shared nodes are counted.
+typedef struct JWImplementationPersistentVector {
+  int size;
+  int shift;              // height of root * kPersistentBits; 0 when root is a leaf
+  JPersistentNode *root;  // NULL when every item is in the tail
+  JPersistentLeaf *tail;  // the last 1 to 32 items; NULL when empty
+  int tail_count;
+  Allocator *allocator;
+} JPersistentVector;
+
+// persistent vector functions
+
+// Makes an empty vector. A NULL allocator means malloc.
+void persistent_vector_init(JPersistentVector *vecptr, Allocator *allocator);
+// Drops this version; nodes no other version uses are freed. Leaves the
+// handle empty.
+void persistent_vector_release(JPersistentVector *vecptr);
+// O(1) copy of a version into *out.
+void persistent_vector_snapshot(const JPersistentVector *vecptr, JPersistentVector *out);
+int persistent_vector_size(const JPersistentVector *vecptr);
+int persistent_vector_at(const JPersistentVector *vecptr, int index);
+// Items index, index + 1, ... up to the end of the leaf holding index,
+// with *count set to how many there are. Walking the vector a leaf at a
+// time this way costs one tree descent per 32 items instead of one per
+// item. The pointer stays valid while this version is alive.
+const int *persistent_vector_chunk(const JPersistentVector *vecptr, int index, int *count);
+// Copies the items in order to out, which must hold size items.
+void persistent_vector_copy_to(const JPersistentVector *vecptr, int *out);
+
+// The persistent functions leave vecptr as it was and write a new
+// version to *out (which must not be initialized). On CONTAINER_NO_MEMORY
+// *out is left empty.
+ContainerStatus persistent_vector_push(const JPersistentVector *vecptr, int item, JPersistentVector *out);
+ContainerStatus persistent_vector_set(const JPersistentVector *vecptr, int index, int item, JPersistentVector *out);
+// The first count items.
+ContainerStatus persistent_vector_take(const JPersistentVector *vecptr, int count, JPersistentVector *out);
+// All but the first count items.
+ContainerStatus persistent_vector_drop(const JPersistentVector *vecptr, int count, JPersistentVector *out);
+// Items [begin, end).
+ContainerStatus persistent_vector_slice(const JPersistentVector *vecptr, int begin, int end, JPersistentVector *out);
+ContainerStatus persistent_vector_concat(const JPersistentVector *left, const JPersistentVector *right,
+                                         JPersistentVector *out);
+
+// The transient functions change *vecptr in place. On
+// CONTAINER_NO_MEMORY it still holds the items it had before.
+ContainerStatus persistent_vector_transient_push(JPersistentVector *vecptr, int item);
+ContainerStatus persistent_vector_transient_set(JPersistentVector *vecptr, int index, int item);
+
+// tests
+
+void run_all_persistent_vector_tests();
+
+void test_persistent_vector_push_at();
+void test_persistent_vector_versions_are_independent();
+void test_persistent_vector_transient_copies_once();
+void test_persistent_vector_slices();
+void test_persistent_vector_concat();
+void test_persistent_vector_random_against_array();
+void test_persistent_vector_reader_threads();
+void test_persistent_vector_out_of_memory();
+
+#endif  // PROJECT_PERSISTENT_VECTOR_H
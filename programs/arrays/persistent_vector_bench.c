@@ -0,0 +1,236 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>   // for IO
+#include <stdlib.h>  // for malloc
+#include <string.h>
+#include <time.h>
+#include "array.h"
+#include "array.c"
+#include "persistent_vector.h"
+#include "persistent_vector.c"
+#include "../allocator/allocator.c"
+
+// What a reader's consistent view of n ints costs: a full JArray copy
+// against a JPersistentVector snapshot, and then what the writer pays
+// afterwards for each change (a path copy while the snapshot is alive, an
+// in-place transient set once it is not, or a snapshot every 1000 sets).
+// Also reads, building, slicing and joining, each against the
+// JArray/memcpy equivalent.
+
+#define kUpdates 1000000
+#define kReads 10000000
+#define kBatch 1000
+// the 10M array copy per batch takes 30 ms, so its run is cut short
+#define kMaxArrayBatches 50
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile long long sink;
+
+static unsigned int next_random(unsigned int *state) {
+  *state = *state * 1103515245u + 12345u;
+  return *state >> 8;
+}
+
+static void bench_size(int count) {
+  printf("\nn = %d\n", count);
+
+  double start = now_ns();
+  JArray *arrptr = jarray_new(1);
+  for (int i = 0; i < count; ++i) {
+    jarray_push(arrptr, i);
+  }
+  double array_build = now_ns() - start;
+
+  start = now_ns();
+  JPersistentVector vec;
+  persistent_vector_init(&vec, NULL);
+  for (int i = 0; i < count; ++i) {
+    persistent_vector_transient_push(&vec, i);
+  }
+  double vector_build = now_ns() - start;
+  printf("%-34s %12.2f %12.2f ns/item\n", "build by push", array_build / count, vector_build / count);
+
+  // snapshots, repeated enough to time the small ones
+  int rounds = count >= 1000000 ? 20 : 20000000 / count;
+  start = now_ns();
+  for (int r = 0; r < rounds; ++r) {
+    JArray *copy = jarray_new(count);
+    memcpy(copy->data, arrptr->data, sizeof(int) * count);
+    copy->size = count;
+    sink = copy->data[count / 2];
+    jarray_destroy(copy);
+  }
+  double array_snapshot = (now_ns() - start) / rounds;
+  start = now_ns();
+  for (int r = 0; r < rounds; ++r) {
+    JPersistentVector copy;
+    persistent_vector_snapshot(&vec, &copy);
+    sink = copy.size;
+    persistent_vector_release(&copy);
+  }
+  double vector_snapshot = (now_ns() - start) / rounds;
+  printf("%-34s %12.0f %12.0f ns\n", "snapshot", array_snapshot, vector_snapshot);
+
+  // random sets: into the array, as new versions while a snapshot holds
+  // the old one, and in place with nothing else holding the nodes
+  unsigned int state = 1;
+  start = now_ns();
+  for (int i = 0; i < kUpdates; ++i) {
+    arrptr->data[next_random(&state) % count] = i;
+  }
+  double array_set = (now_ns() - start) / kUpdates;
+
+  JPersistentVector reader;
+  persistent_vector_snapshot(&vec, &reader);
+  state = 1;
+  start = now_ns();
+  for (int i = 0; i < kUpdates; ++i) {
+    JPersistentVector next;
+    persistent_vector_set(&vec, next_random(&state) % count, i, &next);
+    persistent_vector_release(&vec);
+    vec = next;
+  }
+  double persistent_set = (now_ns() - start) / kUpdates;
+  persistent_vector_release(&reader);
+
+  state = 1;
+  start = now_ns();
+  for (int i = 0; i < kUpdates; ++i) {
+    persistent_vector_transient_set(&vec, next_random(&state) % count, i);
+  }
+  double transient_set = (now_ns() - start) / kUpdates;
+
+  // a writer publishing a snapshot for readers every kBatch sets: the
+  // array is copied each time, the vector copies each touched path once
+  // per batch
+  JArray *published = NULL;
+  int array_updates = kUpdates < kBatch * kMaxArrayBatches ? kUpdates : kBatch * kMaxArrayBatches;
+  state = 1;
+  start = now_ns();
+  for (int i = 0; i < array_updates; ++i) {
+    if (i % kBatch == 0) {
+      if (published != NULL) {
+        jarray_destroy(published);
+      }
+      published = jarray_new(count);
+      memcpy(published->data, arrptr->data, sizeof(int) * count);
+      published->size = count;
+    }
+    arrptr->data[next_random(&state) % count] = i;
+  }
+  double array_batched = (now_ns() - start) / array_updates;
+  jarray_destroy(published);
+
+  persistent_vector_init(&reader, NULL);
+  state = 1;
+  start = now_ns();
+  for (int i = 0; i < kUpdates; ++i) {
+    if (i % kBatch == 0) {
+      persistent_vector_release(&reader);
+      persistent_vector_snapshot(&vec, &reader);
+    }
+    persistent_vector_transient_set(&vec, next_random(&state) % count, i);
+  }
+  double vector_batched = (now_ns() - start) / kUpdates;
+  persistent_vector_release(&reader);
+
+  printf("%-34s %12.2f %12.2f ns\n", "random set, persistent", array_set, persistent_set);
+  printf("%-34s %12.2f %12.2f ns\n", "random set, transient", array_set, transient_set);
+  printf("%-34s %12.2f %12.2f ns\n", "random set, snapshot per 1000", array_batched, vector_batched);
+
+  // reads
+  long long sum = 0;
+  start = now_ns();
+  for (int i = 0; i < count; ++i) {
+    sum += jarray_at(arrptr, i);
+  }
+  double array_scan = (now_ns() - start) / count;
+  start = now_ns();
+  for (int i = 0; i < count; ++i) {
+    sum += persistent_vector_at(&vec, i);
+  }
+  double vector_scan = (now_ns() - start) / count;
+  start = now_ns();
+  for (int i = 0, chunk; i < count; i += chunk) {
+    const int *items = persistent_vector_chunk(&vec, i, &chunk);
+    for (int k = 0; k < chunk; ++k) {
+      sum += items[k];
+    }
+  }
+  double chunk_scan = (now_ns() - start) / count;
+  printf("%-34s %12.2f %12.2f ns/item\n", "sequential at", array_scan, vector_scan);
+  printf("%-34s %12.2f %12.2f ns/item\n", "sequential by chunk", array_scan, chunk_scan);
+
+  state = 2;
+  start = now_ns();
+  for (int i = 0; i < kReads; ++i) {
+    sum += jarray_at(arrptr, next_random(&state) % count);
+  }
+  double array_random = (now_ns() - start) / kReads;
+  state = 2;
+  start = now_ns();
+  for (int i = 0; i < kReads; ++i) {
+    sum += persistent_vector_at(&vec, next_random(&state) % count);
+  }
+  double vector_random = (now_ns() - start) / kReads;
+  printf("%-34s %12.2f %12.2f ns\n", "random at", array_random, vector_random);
+  sink = sum;
+
+  // the middle half as a new sequence, then two halves joined
+  rounds = count >= 1000000 ? 20 : 2000000 / count;
+  start = now_ns();
+  for (int r = 0; r < rounds; ++r) {
+    JArray *slice = jarray_new(count / 2);
+    memcpy(slice->data, arrptr->data + count / 4, sizeof(int) * (count / 2));
+    sink = slice->data[0];
+    jarray_destroy(slice);
+  }
+  double array_slice = (now_ns() - start) / rounds;
+  start = now_ns();
+  for (int r = 0; r < rounds; ++r) {
+    JPersistentVector slice;
+    persistent_vector_slice(&vec, count / 4, count / 4 + count / 2, &slice);
+    sink = slice.size;
+    persistent_vector_release(&slice);
+  }
+  double vector_slice = (now_ns() - start) / rounds;
+  printf("%-34s %12.0f %12.0f ns\n", "slice of the middle half", array_slice, vector_slice);
+
+  JPersistentVector left, right;
+  persistent_vector_take(&vec, count / 2 + 7, &left);
+  persistent_vector_drop(&vec, count / 2 + 7, &right);
+  start = now_ns();
+  for (int r = 0; r < rounds; ++r) {
+    JArray *joined = jarray_new(count);
+    memcpy(joined->data, arrptr->data, sizeof(int) * count);
+    sink = joined->data[count - 1];
+    jarray_destroy(joined);
+  }
+  double array_concat = (now_ns() - start) / rounds;
+  start = now_ns();
+  for (int r = 0; r < rounds; ++r) {
+    JPersistentVector joined;
+    persistent_vector_concat(&left, &right, &joined);
+    sink = joined.size;
+    persistent_vector_release(&joined);
+  }
+  double vector_concat = (now_ns() - start) / rounds;
+  printf("%-34s %12.0f %12.0f ns\n", "join of two unaligned halves", array_concat, vector_concat);
+
+  persistent_vector_release(&left);
+  persistent_vector_release(&right);
+  persistent_vector_release(&vec);
+  jarray_destroy(arrptr);
+}
+
+int main(int argc, char* argv[]) {
+  printf("%-34s %12s %12s\n", "", "JArray", "persistent");
+  bench_size(1000);
+  bench_size(100000);
+  bench_size(10000000);
+  return EXIT_SUCCESS;
+}
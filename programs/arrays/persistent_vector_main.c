@@ -0,0 +1,15 @@
+#include <stdio.h>   // for IO
+#include <stdlib.h>  // for malloc
+#include "persistent_vector.h"
+#include "persistent_vector.c"
+#include "../allocator/allocator.c"
+
+// Implements a persistent vector (JPersistentVector), an RRB tree whose
+// versions share nodes, so snapshots are O(1).
+
+int main(int argc, char* argv[]) {
+  run_all_persistent_vector_tests();
+  printf("All persistent vector tests passed.\n");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,217 @@
+#include <string.h>
+// segmented array implementation
+
+// Segment of item index: with j = index + kSegmentBase, j's top bit is
+// bit kSegmentBaseBits + segment.
+static inline int segmented_array_segment_of(unsigned int index) {
+  return 31 - __builtin_clz(index + kSegmentBase) - kSegmentBaseBits;
+}
+
+// Offset of item index inside its segment: j with the top bit cleared.
+static inline int segmented_array_offset_of(unsigned int index, int segment) {
+  return (index + kSegmentBase) - (kSegmentBase << segment);
+}
+
+JSegmentedArray *segmented_array_new() {
+  return segmented_array_new_with_allocator(default_allocator());
+}
+
+JSegmentedArray *segmented_array_new_with_allocator(Allocator *allocator) {
+  JSegmentedArray *arrptr = allocator_allocate(allocator, sizeof(JSegmentedArray));
+  if (arrptr == NULL) {
+    return NULL;
+  }
+  arrptr->size = 0;
+  arrptr->segment_count = 0;
+  arrptr->allocator = allocator;
+  return arrptr;
+}
+
+void segmented_array_destroy(JSegmentedArray *arrptr) {
+  for (int k = 0; k < arrptr->segment_count; ++k) {
+    allocator_release(arrptr->allocator, arrptr->segments[k], sizeof(int) * segmented_array_segment_capacity(k));
+  }
+  allocator_release(arrptr->allocator, arrptr, sizeof(JSegmentedArray));
+}
+
+int segmented_array_size(JSegmentedArray *arrptr) { return arrptr->size; }
+
+bool segmented_array_is_empty(JSegmentedArray *arrptr) {
+  return arrptr->size == 0;
+}
+
+int segmented_array_segment_capacity(int segment) { return kSegmentBase << segment; }
+
+ContainerStatus segmented_array_push(JSegmentedArray *arrptr, int item) {
+  int segment = segmented_array_segment_of(arrptr->size);
+  if (segment == arrptr->segment_count) {
+    if (segment == kMaxSegments) {
+      return CONTAINER_NO_MEMORY;
+    }
+    int *new_segment = allocator_allocate(arrptr->allocator, sizeof(int) * segmented_array_segment_capacity(segment));
+    if (new_segment == NULL) {
+      return CONTAINER_NO_MEMORY;
+    }
+    arrptr->segments[segment] = new_segment;
+    arrptr->segment_count++;
+  }
+  arrptr->segments[segment][segmented_array_offset_of(arrptr->size, segment)] = item;
+  arrptr->size++;
+  return CONTAINER_OK;
+}
+
+int segmented_array_pop(JSegmentedArray *arrptr) {
+  if (arrptr->size == 0) {
+    exit(EXIT_FAILURE);
+  }
+  arrptr->size--;
+  int segment = segmented_array_segment_of(arrptr->size);
+  int popped_value = arrptr->segments[segment][segmented_array_offset_of(arrptr->size, segment)];
+
+  // keep at most one empty segment above the last used one, and drop it
+  // once the last used one is half empty
+  int last = arrptr->segment_count - 1;
+  if (last > segment && segmented_array_offset_of(arrptr->size, segment) < segmented_array_segment_capacity(segment) / 2) {
+    allocator_release(arrptr->allocator, arrptr->segments[last], sizeof(int) * segmented_array_segment_capacity(last));
+    arrptr->segment_count--;
+  }
+  return popped_value;
+}
+
+int *segmented_array_address(JSegmentedArray *arrptr, int index) {
+  if (index < 0 || index >= arrptr->size) {
+    exit(EXIT_FAILURE);
+  }
+  int segment = segmented_array_segment_of(index);
+  return &arrptr->segments[segment][segmented_array_offset_of(index, segment)];
+}
+
+int segmented_array_at(JSegmentedArray *arrptr, int index) {
+  return *segmented_array_address(arrptr, index);
+}
+
+void segmented_array_set(JSegmentedArray *arrptr, int index, int value) {
+  *segmented_array_address(arrptr, index) = value;
+}
+
+int *segmented_array_segment(JSegmentedArray *arrptr, int segment, int *count) {
+  int before = kSegmentBase * ((1 << segment) - 1);  // items in earlier segments
+  if (segment >= arrptr->segment_count || arrptr->size <= before) {
+    *count = 0;
+    return NULL;
+  }
+  int in_use = arrptr->size - before;
+  int capacity = segmented_array_segment_capacity(segment);
+  *count = in_use < capacity ? in_use : capacity;
+  return arrptr->segments[segment];
+}
+
+//=========== tests ===================================
+
+void run_all_segmented_array_tests() {
+  test_segmented_array_index_math();
+  test_segmented_array_push_at();
+  test_segmented_array_stable_addresses();
+  test_segmented_array_pop_frees();
+  test_segmented_array_iterate();
+  test_segmented_array_out_of_memory();
+}
+
+void test_segmented_array_index_math() {
+  long long start = 0;
+  for (int segment = 0; segment < kMaxSegments; ++segment) {
+    int capacity = segmented_array_segment_capacity(segment);
+    assert(segmented_array_segment_of(start) == segment);
+    assert(segmented_array_offset_of(start, segment) == 0);
+    assert(segmented_array_segment_of(start + capacity - 1) == segment);
+    assert(segmented_array_offset_of(start + capacity - 1, segment) == capacity - 1);
+    start += capacity;
+  }
+  assert(start == 2147483648LL - kSegmentBase);
+}
+
+void test_segmented_array_push_at() {
+  JSegmentedArray *arrptr = segmented_array_new();
+  for (int i = 0; i < 10000; ++i) {
+    segmented_array_push(arrptr, i * 2);
+  }
+  assert(segmented_array_size(arrptr) == 10000);
+  for (int i = 0; i < 10000; ++i) {
+    assert(segmented_array_at(arrptr, i) == i * 2);
+  }
+  segmented_array_set(arrptr, 4321, -1);
+  assert(segmented_array_at(arrptr, 4321) == -1);
+  segmented_array_destroy(arrptr);
+}
+
+void test_segmented_array_stable_addresses() {
+  JSegmentedArray *arrptr = segmented_array_new();
+  segmented_array_push(arrptr, 7);
+  int *first = segmented_array_address(arrptr, 0);
+  for (int i = 1; i < 100000; ++i) {
+    segmented_array_push(arrptr, i);
+  }
+  assert(first == segmented_array_address(arrptr, 0));
+  assert(*first == 7);
+  segmented_array_destroy(arrptr);
+}
+
+void test_segmented_array_pop_frees() {
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+
+  JSegmentedArray *arrptr = segmented_array_new_with_allocator(&tracker.allocator);
+  for (int i = 0; i < kSegmentBase * 3; ++i) {  // fills segments 0 and 1
+    segmented_array_push(arrptr, i);
+  }
+  segmented_array_push(arrptr, 99);  // opens segment 2
+  assert(arrptr->segment_count == 3);
+
+  // popping back across the boundary keeps segment 2 for a while
+  assert(segmented_array_pop(arrptr) == 99);
+  assert(segmented_array_pop(arrptr) == kSegmentBase * 3 - 1);
+  assert(arrptr->segment_count == 3);
+  size_t allocations = tracker.allocations;
+  segmented_array_push(arrptr, 1);
+  segmented_array_push(arrptr, 2);
+  assert(tracker.allocations == allocations);
+
+  while (segmented_array_size(arrptr) > 0) {
+    segmented_array_pop(arrptr);
+  }
+  assert(arrptr->segment_count == 1);
+  segmented_array_destroy(arrptr);
+  assert(tracker.bytes_live == 0);
+}
+
+void test_segmented_array_iterate() {
+  JSegmentedArray *arrptr = segmented_array_new();
+  for (int i = 0; i < 1000; ++i) {
+    segmented_array_push(arrptr, i);
+  }
+  int expected = 0;
+  for (int segment = 0; segment < kMaxSegments; ++segment) {
+    int count;
+    int *items = segmented_array_segment(arrptr, segment, &count);
+    for (int i = 0; i < count; ++i) {
+      assert(items[i] == expected++);
+    }
+  }
+  assert(expected == 1000);
+  segmented_array_destroy(arrptr);
+}
+
+void test_segmented_array_out_of_memory() {
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+  tracker.fail_after = 2;  // the header and segment 0
+
+  JSegmentedArray *arrptr = segmented_array_new_with_allocator(&tracker.allocator);
+  for (int i = 0; i < kSegmentBase; ++i) {
+    assert(segmented_array_push(arrptr, i) == CONTAINER_OK);
+  }
+  assert(segmented_array_push(arrptr, 99) == CONTAINER_NO_MEMORY);
+  assert(segmented_array_size(arrptr) == kSegmentBase);
+  assert(segmented_array_at(arrptr, kSegmentBase - 1) == kSegmentBase - 1);
+  segmented_array_destroy(arrptr);
+}
@@ -0,0 +1,65 @@
+#ifndef PROJECT_SEGMENTED_ARRAY_H
+#define PROJECT_SEGMENTED_ARRAY_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include "../allocator/allocator.h"
+
+// Items in the first segment; each later segment doubles. Must be a
+// power of two.
+#define kSegmentBase 16
+#define kSegmentBaseBits 4
+// 27 segments hold kSegmentBase * (2^27 - 1) = 2^31 - 16 items, the most
+// an int size can count up to (give or take 15).
+#define kMaxSegments 27
+
+// Vector of ints that grows by adding a segment instead of reallocating,
+// so growth never copies and a pointer to an item stays valid until that
+// item is popped. Segment k holds kSegmentBase << k items, so the segments
+// before k hold kSegmentBase * (2^k - 1) and item i lives in segment
+// floor(log2(i / kSegmentBase + 1)), which is one clz.
+typedef struct JWImplementationSegmentedArray {
+  int size;
+  int segment_count;  // segments allocated, possibly one past the last used
+  int *segments[kMaxSegments];
+  Allocator *allocator;
+} JSegmentedArray;
+
+// segmented array functions
+
+// Returns NULL if out of memory. No segment is allocated until the first
+// push.
+JSegmentedArray *segmented_array_new();
+JSegmentedArray *segmented_array_new_with_allocator(Allocator *allocator);
+void segmented_array_destroy(JSegmentedArray *arrptr);
+int segmented_array_size(JSegmentedArray *arrptr);
+bool segmented_array_is_empty(JSegmentedArray *arrptr);
+// Number of items segment can hold.
+int segmented_array_segment_capacity(int segment);
+// Appends item, allocating a new segment when the last one is full. On
+// CONTAINER_NO_MEMORY the array is unchanged.
+ContainerStatus segmented_array_push(JSegmentedArray *arrptr, int item);
+// Removes the last item and returns it. A segment is freed only once the
+// one below it is half empty, so pushing and popping across a segment
+// boundary does not allocate every time.
+int segmented_array_pop(JSegmentedArray *arrptr);
+int segmented_array_at(JSegmentedArray *arrptr, int index);
+void segmented_array_set(JSegmentedArray *arrptr, int index, int value);
+// Address of the item at index; stable while the item is in the array.
+int *segmented_array_address(JSegmentedArray *arrptr, int index);
+// For iterating segment by segment: returns segment's items and sets
+// *count to how many of them are in use (0 past the last one).
+int *segmented_array_segment(JSegmentedArray *arrptr, int segment, int *count);
+
+// tests
+
+void run_all_segmented_array_tests();
+
+void test_segmented_array_index_math();
+void test_segmented_array_push_at();
+void test_segmented_array_stable_addresses();
+void test_segmented_array_pop_frees();
+void test_segmented_array_iterate();
+void test_segmented_array_out_of_memory();
+
+#endif  // PROJECT_SEGMENTED_ARRAY_H
@@ -0,0 +1,152 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>   // for IO
+#include <stdlib.h>  // for malloc
+#include <string.h>
+#include <time.h>
+#include "array.h"
+#include "array.c"
+#include "segmented_array.h"
+#include "segmented_array.c"
+#include "../allocator/allocator.c"
+
+// Push latency of JArray (realloc on growth) against JSegmentedArray (a
+// new segment on growth) while growing to 1 GB of ints, then the cost of
+// reading everything back. Every push is timed; latencies go into
+// power-of-two buckets, so percentiles are bucket upper bounds, and they
+// include about 20 ns of clock_gettime.
+//
+// glibc serves big blocks with mmap and grows them with mremap, which
+// moves pages instead of copying bytes, so plain JArray growth is cheap
+// there. JArray is also run with a malloc + memcpy + free reallocate,
+// which is what allocators without mremap (pools, arenas, most other
+// mallocs) end up doing.
+
+#define kPushes (1 << 28)
+#define kBuckets 40
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+typedef struct LatencyHistogram {
+  long long counts[kBuckets];
+  double max_ns;
+  double total_ns;
+  long long over_1ms;
+} LatencyHistogram;
+
+static void histogram_add(LatencyHistogram *histogram, double ns) {
+  int bucket = 0;
+  while (bucket < kBuckets - 1 && ns >= (double)(1LL << bucket)) {
+    ++bucket;
+  }
+  histogram->counts[bucket]++;
+  histogram->total_ns += ns;
+  histogram->over_1ms += ns >= 1e6;
+  if (ns > histogram->max_ns) {
+    histogram->max_ns = ns;
+  }
+}
+
+// smallest bucket bound with at least fraction of the pushes at or below
+static double histogram_percentile(LatencyHistogram *histogram, double fraction) {
+  long long wanted = (long long)(fraction * kPushes);
+  long long seen = 0;
+  for (int bucket = 0; bucket < kBuckets; ++bucket) {
+    seen += histogram->counts[bucket];
+    if (seen >= wanted) {
+      return (double)(1LL << bucket);
+    }
+  }
+  return histogram->max_ns;
+}
+
+static void print_histogram(const char *name, LatencyHistogram *histogram) {
+  printf("%-16s %8.0f %8.0f %8.0f %9.0f %12.2f %8lld %9.2f\n", name, histogram_percentile(histogram, 0.5),
+         histogram_percentile(histogram, 0.999), histogram_percentile(histogram, 0.999999), histogram->max_ns / 1e3,
+         histogram->max_ns / 1e6, histogram->over_1ms, histogram->total_ns / 1e9);
+}
+
+static volatile long long sink;
+
+static void *copying_reallocate(void *state, void *ptr, size_t old_size, size_t new_size) {
+  (void)state;
+  void *new_ptr = malloc(new_size);
+  if (new_ptr == NULL) {
+    return NULL;
+  }
+  memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+  free(ptr);
+  return new_ptr;
+}
+
+static void bench_jarray(const char *name, Allocator *allocator, double *scan_ms) {
+  static LatencyHistogram latency;
+  memset(&latency, 0, sizeof(latency));
+
+  JArray *arrptr = jarray_new_with_allocator(1, allocator);
+  for (int i = 0; i < kPushes; ++i) {
+    double start = now_ns();
+    jarray_push(arrptr, i);
+    histogram_add(&latency, now_ns() - start);
+  }
+  print_histogram(name, &latency);
+
+  double start = now_ns();
+  long long sum = 0;
+  for (int i = 0; i < jarray_size(arrptr); ++i) {
+    sum += arrptr->data[i];
+  }
+  *scan_ms = (now_ns() - start) / 1e6;
+  sink = sum;
+  jarray_destroy(arrptr);
+}
+
+int main(int argc, char* argv[]) {
+  static LatencyHistogram segmented_latency;
+
+  printf("%d pushes (%d MB of ints)\n", kPushes, (int)(sizeof(int) * (long long)kPushes >> 20));
+  printf("%-16s %8s %8s %8s %9s %12s %8s %9s\n", "", "p50 ns", "p99.9", "p99.9999", "max us", "max ms",
+         ">1ms", "total s");
+
+  double jarray_scan;
+  bench_jarray("JArray", default_allocator(), &jarray_scan);
+  Allocator copying = {malloc_allocate, copying_reallocate, malloc_release, NULL};
+  bench_jarray("JArray, copying", &copying, &jarray_scan);
+
+  JSegmentedArray *segptr = segmented_array_new();
+  for (int i = 0; i < kPushes; ++i) {
+    double start = now_ns();
+    segmented_array_push(segptr, i);
+    histogram_add(&segmented_latency, now_ns() - start);
+  }
+  print_histogram("JSegmentedArray", &segmented_latency);
+
+  double start = now_ns();
+  long long sum = 0;
+  for (int segment = 0; segment < kMaxSegments; ++segment) {
+    int count;
+    int *items = segmented_array_segment(segptr, segment, &count);
+    for (int i = 0; i < count; ++i) {
+      sum += items[i];
+    }
+  }
+  double segment_scan = (now_ns() - start) / 1e6;
+  sink = sum;
+
+  start = now_ns();
+  sum = 0;
+  for (int i = 0; i < segmented_array_size(segptr); ++i) {
+    sum += segmented_array_at(segptr, i);
+  }
+  double indexed_scan = (now_ns() - start) / 1e6;
+  sink = sum;
+  segmented_array_destroy(segptr);
+
+  printf("\nsum of all items: JArray %.0f ms, JSegmentedArray by segment %.0f ms, by index %.0f ms\n",
+         jarray_scan, segment_scan, indexed_scan);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,15 @@
+#include <stdio.h>   // for IO
+#include <stdlib.h>  // for malloc
+#include "segmented_array.h"
+#include "segmented_array.c"
+#include "../allocator/allocator.c"
+
+// Implements a segmented array (JSegmentedArray) that grows by adding
+// segments, so items never move.
+
+int main(int argc, char* argv[]) {
+  run_all_segmented_array_tests();
+  printf("All segmented array tests passed.\n");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,306 @@
+#include <string.h>
+// small vector implementation
+
+void small_vector_init(JSmallVector *vecptr, Allocator *allocator) {
+  vecptr->size = 0;
+  vecptr->capacity = kSmallVectorInline;
+  vecptr->allocator = allocator != NULL ? allocator : default_allocator();
+}
+
+void small_vector_release(JSmallVector *vecptr) {
+  if (!small_vector_is_inline(vecptr)) {
+    allocator_release(vecptr->allocator, vecptr->storage.heap, sizeof(int) * vecptr->capacity);
+  }
+  vecptr->size = 0;
+  vecptr->capacity = kSmallVectorInline;
+}
+
+JSmallVector *small_vector_new() {
+  return small_vector_new_with_allocator(default_allocator());
+}
+
+JSmallVector *small_vector_new_with_allocator(Allocator *allocator) {
+  JSmallVector *vecptr = allocator_allocate(allocator, sizeof(JSmallVector));
+  if (vecptr == NULL) {
+    return NULL;
+  }
+  small_vector_init(vecptr, allocator);
+  return vecptr;
+}
+
+void small_vector_destroy(JSmallVector *vecptr) {
+  small_vector_release(vecptr);
+  allocator_release(vecptr->allocator, vecptr, sizeof(JSmallVector));
+}
+
+bool small_vector_is_inline(JSmallVector *vecptr) {
+  return vecptr->capacity == kSmallVectorInline;
+}
+
+int *small_vector_data(JSmallVector *vecptr) {
+  return small_vector_is_inline(vecptr) ? vecptr->storage.items : vecptr->storage.heap;
+}
+
+int small_vector_size(JSmallVector *vecptr) { return vecptr->size; }
+
+int small_vector_capacity(JSmallVector *vecptr) { return vecptr->capacity; }
+
+bool small_vector_is_empty(JSmallVector *vecptr) {
+  return vecptr->size == 0;
+}
+
+ContainerStatus small_vector_reserve(JSmallVector *vecptr, int capacity) {
+  if (capacity <= vecptr->capacity) {
+    return CONTAINER_OK;
+  }
+  int new_capacity = vecptr->capacity;
+  while (new_capacity < capacity) {
+    new_capacity *= kGrowthFactor;
+  }
+
+  int *new_data;
+  if (small_vector_is_inline(vecptr)) {
+    // first spill: the items move out of the header
+    new_data = allocator_allocate(vecptr->allocator, sizeof(int) * new_capacity);
+    if (new_data == NULL) {
+      return CONTAINER_NO_MEMORY;
+    }
+    memcpy(new_data, vecptr->storage.items, sizeof(int) * vecptr->size);
+  } else {
+    new_data = allocator_reallocate(vecptr->allocator, vecptr->storage.heap, sizeof(int) * vecptr->capacity,
+                                    sizeof(int) * new_capacity);
+    if (new_data == NULL) {
+      return CONTAINER_NO_MEMORY;
+    }
+  }
+  vecptr->storage.heap = new_data;
+  vecptr->capacity = new_capacity;
+  return CONTAINER_OK;
+}
+
+ContainerStatus small_vector_push(JSmallVector *vecptr, int item) {
+  if (vecptr->size == vecptr->capacity && small_vector_reserve(vecptr, vecptr->size + 1) != CONTAINER_OK) {
+    return CONTAINER_NO_MEMORY;
+  }
+  small_vector_data(vecptr)[vecptr->size++] = item;
+  return CONTAINER_OK;
+}
+
+int small_vector_pop(JSmallVector *vecptr) {
+  if (vecptr->size == 0) {
+    exit(EXIT_FAILURE);
+  }
+  return small_vector_data(vecptr)[--vecptr->size];
+}
+
+int small_vector_at(JSmallVector *vecptr, int index) {
+  if (index < 0 || index >= vecptr->size) {
+    exit(EXIT_FAILURE);
+  }
+  return small_vector_data(vecptr)[index];
+}
+
+void small_vector_set(JSmallVector *vecptr, int index, int value) {
+  if (index < 0 || index >= vecptr->size) {
+    exit(EXIT_FAILURE);
+  }
+  small_vector_data(vecptr)[index] = value;
+}
+
+// Unlike jarray_insert, index may be size (an append).
+ContainerStatus small_vector_insert(JSmallVector *vecptr, int index, int value) {
+  if (index < 0 || index > vecptr->size) {
+    exit(EXIT_FAILURE);
+  }
+  if (vecptr->size == vecptr->capacity && small_vector_reserve(vecptr, vecptr->size + 1) != CONTAINER_OK) {
+    return CONTAINER_NO_MEMORY;
+  }
+
+  int *data = small_vector_data(vecptr);
+  memmove(data + index + 1, data + index, (vecptr->size - index) * sizeof(int));
+  data[index] = value;
+  ++(vecptr->size);
+  return CONTAINER_OK;
+}
+
+ContainerStatus small_vector_prepend(JSmallVector *vecptr, int value) {
+  return small_vector_insert(vecptr, 0, value);
+}
+
+void small_vector_delete(JSmallVector *vecptr, int index) {
+  if (index < 0 || index >= vecptr->size) {
+    exit(EXIT_FAILURE);
+  }
+  int *data = small_vector_data(vecptr);
+  memmove(data + index, data + index + 1, (vecptr->size - index - 1) * sizeof(int));
+  --(vecptr->size);
+}
+
+// one pass, keeping the items that stay
+void small_vector_remove(JSmallVector *vecptr, int value) {
+  int *data = small_vector_data(vecptr);
+  int kept = 0;
+  for (int i = 0; i < vecptr->size; ++i) {
+    if (data[i] != value) {
+      data[kept++] = data[i];
+    }
+  }
+  vecptr->size = kept;
+}
+
+int small_vector_find(JSmallVector *vecptr, int value) {
+  int *data = small_vector_data(vecptr);
+  for (int i = 0; i < vecptr->size; ++i) {
+    if (data[i] == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void small_vector_clear(JSmallVector *vecptr) { vecptr->size = 0; }
+
+void small_vector_shrink_to_fit(JSmallVector *vecptr) {
+  if (small_vector_is_inline(vecptr) || vecptr->size > kSmallVectorInline) {
+    return;
+  }
+  int *heap = vecptr->storage.heap;
+  int heap_capacity = vecptr->capacity;
+  // heap is saved above because the union overlaps it with items
+  memcpy(vecptr->storage.items, heap, sizeof(int) * vecptr->size);
+  vecptr->capacity = kSmallVectorInline;
+  allocator_release(vecptr->allocator, heap, sizeof(int) * heap_capacity);
+}
+
+//=========== tests ===================================
+
+void run_all_small_vector_tests() {
+  test_small_vector_stays_inline();
+  test_small_vector_spills();
+  test_small_vector_insert_delete();
+  test_small_vector_embedded();
+  test_small_vector_shrink_to_fit();
+  test_small_vector_out_of_memory();
+}
+
+void test_small_vector_stays_inline() {
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+
+  JSmallVector vec;
+  small_vector_init(&vec, &tracker.allocator);
+  for (int i = 0; i < kSmallVectorInline; ++i) {
+    small_vector_push(&vec, i * 3);
+  }
+  assert(small_vector_is_inline(&vec));
+  assert(small_vector_size(&vec) == kSmallVectorInline);
+  assert(small_vector_at(&vec, 5) == 15);
+  assert(small_vector_pop(&vec) == (kSmallVectorInline - 1) * 3);
+  small_vector_release(&vec);
+  assert(tracker.allocations == 0);
+}
+
+void test_small_vector_spills() {
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+
+  JSmallVector *vecptr = small_vector_new_with_allocator(&tracker.allocator);
+  assert(tracker.allocations == 1);  // just the header
+  for (int i = 0; i < 100; ++i) {
+    small_vector_push(vecptr, i);
+  }
+  assert(!small_vector_is_inline(vecptr));
+  assert(small_vector_capacity(vecptr) == 128);
+  for (int i = 0; i < 100; ++i) {
+    assert(small_vector_at(vecptr, i) == i);
+  }
+  small_vector_destroy(vecptr);
+  assert(tracker.bytes_live == 0);
+}
+
+void test_small_vector_insert_delete() {
+  JSmallVector vec;
+  small_vector_init(&vec, NULL);
+  for (int i = 0; i < 20; ++i) {
+    small_vector_push(&vec, i % 4);
+  }
+  small_vector_prepend(&vec, 9);
+  small_vector_insert(&vec, 21, 8);  // append by insert
+  small_vector_insert(&vec, 5, 7);
+  assert(small_vector_at(&vec, 0) == 9);
+  assert(small_vector_at(&vec, 5) == 7);
+  assert(small_vector_at(&vec, 22) == 8);
+  small_vector_delete(&vec, 5);
+  assert(small_vector_at(&vec, 5) == 0);
+  small_vector_remove(&vec, 2);
+  assert(small_vector_size(&vec) == 17);
+  assert(small_vector_find(&vec, 2) == -1);
+  assert(small_vector_find(&vec, 3) == 3);
+  small_vector_release(&vec);
+}
+
+// vectors inside another struct, all in one allocation
+void test_small_vector_embedded() {
+  typedef struct Vertex {
+    int id;
+    JSmallVector edges;
+  } Vertex;
+
+  Vertex vertices[8];
+  for (int v = 0; v < 8; ++v) {
+    vertices[v].id = v;
+    small_vector_init(&vertices[v].edges, NULL);
+    for (int e = 0; e < v * 4; ++e) {
+      small_vector_push(&vertices[v].edges, (v + e) % 8);
+    }
+  }
+  assert(small_vector_is_inline(&vertices[4].edges));
+  assert(!small_vector_is_inline(&vertices[7].edges));
+  assert(small_vector_at(&vertices[7].edges, 27) == 2);
+
+  Vertex copy = vertices[3];  // inline, so a full copy
+  small_vector_set(&copy.edges, 0, 100);
+  assert(small_vector_at(&vertices[3].edges, 0) == 3);
+
+  for (int v = 0; v < 8; ++v) {
+    small_vector_release(&vertices[v].edges);
+  }
+}
+
+void test_small_vector_shrink_to_fit() {
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+
+  JSmallVector vec;
+  small_vector_init(&vec, &tracker.allocator);
+  for (int i = 0; i < 40; ++i) {
+    small_vector_push(&vec, i);
+  }
+  while (small_vector_size(&vec) > 10) {
+    small_vector_pop(&vec);
+  }
+  assert(!small_vector_is_inline(&vec));
+  small_vector_shrink_to_fit(&vec);
+  assert(small_vector_is_inline(&vec));
+  assert(tracker.bytes_live == 0);
+  for (int i = 0; i < 10; ++i) {
+    assert(small_vector_at(&vec, i) == i);
+  }
+  small_vector_release(&vec);
+}
+
+void test_small_vector_out_of_memory() {
+  TrackingAllocator tracker;
+  tracking_allocator_init(&tracker, NULL);
+  tracker.fail_after = 0;
+
+  JSmallVector vec;
+  small_vector_init(&vec, &tracker.allocator);
+  for (int i = 0; i < kSmallVectorInline; ++i) {
+    assert(small_vector_push(&vec, i) == CONTAINER_OK);
+  }
+  assert(small_vector_push(&vec, 99) == CONTAINER_NO_MEMORY);
+  assert(small_vector_size(&vec) == kSmallVectorInline);
+  assert(small_vector_is_inline(&vec));
+  assert(small_vector_at(&vec, kSmallVectorInline - 1) == kSmallVectorInline - 1);
+}
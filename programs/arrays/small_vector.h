@@ -0,0 +1,82 @@
+#ifndef PROJECT_SMALL_VECTOR_H
+#define PROJECT_SMALL_VECTOR_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include "../allocator/allocator.h"
+
+// Items kept inside the header before spilling to the heap. 16 ints is
+// one cache line, and covers most of the arrays we keep.
+#define kSmallVectorInline 16
+
+// Vector of ints with small-buffer storage: the first kSmallVectorInline
+// items live in the header itself, and only a vector that outgrows them
+// allocates (one buffer, through allocator). The header can be a local
+// variable or a field of another struct (small_vector_init), or come
+// from the allocator (small_vector_new), so a small vector costs zero or
+// one allocation where JArray always costs two.
+//
+// The data pointer is computed from capacity rather than stored, so the
+// header has no pointer into itself and copying an inline vector by
+// value is a real copy. A spilled vector's copy shares the heap buffer.
+typedef struct JWImplementationSmallVector {
+  int size;
+  int capacity;          // kSmallVectorInline while the items are inline
+  Allocator *allocator;  // for the spilled buffer (and the header if new)
+  union {
+    int *heap;
+    int items[kSmallVectorInline];
+  } storage;
+} JSmallVector;
+
+// small vector functions
+
+// Sets up a vector in caller-owned memory. A NULL allocator means malloc.
+void small_vector_init(JSmallVector *vecptr, Allocator *allocator);
+// Frees a spilled buffer and leaves the vector empty and inline.
+void small_vector_release(JSmallVector *vecptr);
+// Allocates the header too. Returns NULL if out of memory.
+JSmallVector *small_vector_new();
+JSmallVector *small_vector_new_with_allocator(Allocator *allocator);
+void small_vector_destroy(JSmallVector *vecptr);
+
+// Returns the items, inline or on the heap. Invalidated by growth.
+int *small_vector_data(JSmallVector *vecptr);
+int small_vector_size(JSmallVector *vecptr);
+int small_vector_capacity(JSmallVector *vecptr);
+bool small_vector_is_empty(JSmallVector *vecptr);
+// Returns true while the items are still inside the header.
+bool small_vector_is_inline(JSmallVector *vecptr);
+// Makes room for capacity items, spilling to the heap past the inline
+// ones. On CONTAINER_NO_MEMORY the vector is unchanged.
+ContainerStatus small_vector_reserve(JSmallVector *vecptr, int capacity);
+ContainerStatus small_vector_push(JSmallVector *vecptr, int item);
+int small_vector_pop(JSmallVector *vecptr);
+int small_vector_at(JSmallVector *vecptr, int index);
+void small_vector_set(JSmallVector *vecptr, int index, int value);
+ContainerStatus small_vector_insert(JSmallVector *vecptr, int index, int value);
+ContainerStatus small_vector_prepend(JSmallVector *vecptr, int value);
+void small_vector_delete(JSmallVector *vecptr, int index);
+// Removes every item equal to value.
+void small_vector_remove(JSmallVector *vecptr, int value);
+// Returns the index of the first item equal to value, or -1.
+int small_vector_find(JSmallVector *vecptr, int value);
+// Removes all items, keeping any spilled buffer for reuse.
+void small_vector_clear(JSmallVector *vecptr);
+// Moves the items back inline if they fit. Removing items never does
+// this on its own, so a vector that hovers around kSmallVectorInline
+// does not copy back and forth.
+void small_vector_shrink_to_fit(JSmallVector *vecptr);
+
+// tests
+
+void run_all_small_vector_tests();
+
+void test_small_vector_stays_inline();
+void test_small_vector_spills();
+void test_small_vector_insert_delete();
+void test_small_vector_embedded();
+void test_small_vector_shrink_to_fit();
+void test_small_vector_out_of_memory();
+
+#endif  // PROJECT_SMALL_VECTOR_H
@@ -0,0 +1,165 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>   // for IO
+#include <stdlib.h>  // for malloc
+#include <time.h>
+#include "array.h"
+#include "array.c"
+#include "small_vector.h"
+#include "small_vector.c"
+#include "../allocator/allocator.c"
+
+// Allocation-heavy workloads for JArray against JSmallVector:
+//  - short-lived vectors of a few items, created and destroyed in a loop
+//  - adjacency lists of a million vertices, built, walked and freed
+// Allocations are counted with a TrackingAllocator over malloc. Every
+// vector is sized up front for its items, as jarray_new(items) is.
+
+#define kTemporaryRounds 2000000
+#define kVertices 1000000
+#define kMaxDegree 12
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile long sink;
+
+static void bench_temporary(int items) {
+  TrackingAllocator tracker;
+  long checksum = 0;
+
+  tracking_allocator_init(&tracker, NULL);
+  double start = now_ns();
+  for (int r = 0; r < kTemporaryRounds; ++r) {
+    JArray *arrptr = jarray_new_with_allocator(items, &tracker.allocator);
+    for (int i = 0; i < items; ++i) {
+      jarray_push(arrptr, r + i);
+    }
+    checksum += jarray_at(arrptr, items - 1);
+    jarray_destroy(arrptr);
+  }
+  double jarray_ns = (now_ns() - start) / kTemporaryRounds;
+  double jarray_allocations = (double)tracker.allocations / kTemporaryRounds;
+
+  tracking_allocator_init(&tracker, NULL);
+  start = now_ns();
+  for (int r = 0; r < kTemporaryRounds; ++r) {
+    JSmallVector *vecptr = small_vector_new_with_allocator(&tracker.allocator);
+    small_vector_reserve(vecptr, items);
+    for (int i = 0; i < items; ++i) {
+      small_vector_push(vecptr, r + i);
+    }
+    checksum += small_vector_at(vecptr, items - 1);
+    small_vector_destroy(vecptr);
+  }
+  double heap_ns = (now_ns() - start) / kTemporaryRounds;
+  double heap_allocations = (double)tracker.allocations / kTemporaryRounds;
+
+  tracking_allocator_init(&tracker, NULL);
+  start = now_ns();
+  for (int r = 0; r < kTemporaryRounds; ++r) {
+    JSmallVector vec;
+    small_vector_init(&vec, &tracker.allocator);
+    small_vector_reserve(&vec, items);
+    for (int i = 0; i < items; ++i) {
+      small_vector_push(&vec, r + i);
+    }
+    checksum += small_vector_at(&vec, items - 1);
+    small_vector_release(&vec);
+  }
+  double stack_ns = (now_ns() - start) / kTemporaryRounds;
+  double stack_allocations = (double)tracker.allocations / kTemporaryRounds;
+
+  sink = checksum;
+  printf("%6d | %9.1f %7.1f | %9.1f %7.1f | %9.1f %7.1f\n", items, jarray_ns, jarray_allocations, heap_ns,
+         heap_allocations, stack_ns, stack_allocations);
+}
+
+static void bench_adjacency() {
+  int *degrees = malloc(sizeof(int) * kVertices);
+  check_address(degrees);
+  srand(7);
+  for (int v = 0; v < kVertices; ++v) {
+    degrees[v] = rand() % (kMaxDegree + 1);
+  }
+  TrackingAllocator tracker;
+  long checksum = 0;
+
+  tracking_allocator_init(&tracker, NULL);
+  double start = now_ns();
+  JArray **lists = malloc(sizeof(JArray *) * kVertices);
+  check_address(lists);
+  for (int v = 0; v < kVertices; ++v) {
+    lists[v] = jarray_new_with_allocator(1, &tracker.allocator);
+    for (int e = 0; e < degrees[v]; ++e) {
+      jarray_push(lists[v], (v + e * 7919) % kVertices);
+    }
+  }
+  double jarray_build = (now_ns() - start) / 1e6;
+  start = now_ns();
+  for (int v = 0; v < kVertices; ++v) {
+    for (int e = 0; e < jarray_size(lists[v]); ++e) {
+      checksum += lists[v]->data[e];
+    }
+  }
+  double jarray_walk = (now_ns() - start) / 1e6;
+  start = now_ns();
+  for (int v = 0; v < kVertices; ++v) {
+    jarray_destroy(lists[v]);
+  }
+  free(lists);
+  double jarray_free = (now_ns() - start) / 1e6;
+  size_t jarray_allocations = tracker.allocations;
+
+  tracking_allocator_init(&tracker, NULL);
+  start = now_ns();
+  JSmallVector *vectors = malloc(sizeof(JSmallVector) * kVertices);
+  check_address(vectors);
+  for (int v = 0; v < kVertices; ++v) {
+    small_vector_init(&vectors[v], &tracker.allocator);
+    for (int e = 0; e < degrees[v]; ++e) {
+      small_vector_push(&vectors[v], (v + e * 7919) % kVertices);
+    }
+  }
+  double small_build = (now_ns() - start) / 1e6;
+  start = now_ns();
+  for (int v = 0; v < kVertices; ++v) {
+    int *data = small_vector_data(&vectors[v]);
+    for (int e = 0; e < small_vector_size(&vectors[v]); ++e) {
+      checksum += data[e];
+    }
+  }
+  double small_walk = (now_ns() - start) / 1e6;
+  start = now_ns();
+  for (int v = 0; v < kVertices; ++v) {
+    small_vector_release(&vectors[v]);
+  }
+  free(vectors);
+  double small_free = (now_ns() - start) / 1e6;
+  size_t small_allocations = tracker.allocations;
+
+  sink = checksum;
+  printf("%-22s %9s %9s %9s %12s\n", "adjacency lists", "build ms", "walk ms", "free ms", "allocations");
+  printf("%-22s %9.1f %9.1f %9.1f %12zu\n", "JArray * per vertex", jarray_build, jarray_walk, jarray_free,
+         jarray_allocations);
+  printf("%-22s %9.1f %9.1f %9.1f %12zu\n", "embedded JSmallVector", small_build, small_walk, small_free,
+         small_allocations);
+  free(degrees);
+}
+
+int main(int argc, char* argv[]) {
+  printf("ns and allocations per short-lived vector\n");
+  printf("%6s | %17s | %17s | %17s\n", "", "JArray", "JSmallVector new", "JSmallVector stack");
+  printf("%6s | %9s %7s | %9s %7s | %9s %7s\n", "items", "ns", "allocs", "ns", "allocs", "ns", "allocs");
+  int sizes[] = {1, 4, 8, 16, 17, 64};
+  for (int s = 0; s < 6; ++s) {
+    bench_temporary(sizes[s]);
+  }
+
+  printf("\n%d vertices, 0-%d edges each\n", kVertices, kMaxDegree);
+  bench_adjacency();
+
+  return EXIT_SUCCESS;
+}
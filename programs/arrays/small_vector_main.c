@@ -0,0 +1,17 @@
+#include <stdio.h>   // for IO
+#include <stdlib.h>  // for malloc
+#include "array.h"
+#include "array.c"
+#include "small_vector.h"
+#include "small_vector.c"
+#include "../allocator/allocator.c"
+
+// Implements a small vector (JSmallVector) that keeps its first
+// kSmallVectorInline items inside the header.
+
+int main(int argc, char* argv[]) {
+  run_all_small_vector_tests();
+  printf("All small vector tests passed.\n");
+
+  return EXIT_SUCCESS;
+}
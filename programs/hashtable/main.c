@@ -1,6 +1,9 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include <string.h>
+#include "../perf-counters/perf_counters.h"
+#include "sketch.h"
 
 
 #define TABLE_SIZE 10
@@ -8,26 +11,98 @@
 typedef struct Hash_Entry{
     char* key;
     char* value;
-    struct Hash_Entry *next
+    struct Hash_Entry *next;
 }Hash_Entry;
 
+/* bloom is an optional front guard for get: most lookups that miss stop
+after one cache line instead of walking a chain. It only ever gains keys,
+so deleted keys stay in it as false positives until it is rebuilt from
+the table; delete does that once the stale keys outnumber the live ones. */
 typedef struct Hash_Table{
     Hash_Entry **table;
     int size;
+    int count;
+    BloomFilter *bloom;
+    int bloom_stale; // keys deleted since the filter was last built
+    Allocator *allocator;
 }Hash_Table;
 
 
+Hash_Table* create_hashtable(int size);
+Hash_Table* create_hashtable_with_allocator(int size, Allocator *allocator);
+void destroy_hashtable(Hash_Table *hashtable);
+int hash(const char *key, int table_size);
+ContainerStatus insert(Hash_Table *hashtable, const char *key, const char *value);
+bool delete(Hash_Table *hashtable, const char *key);
+Hash_Entry* get(Hash_Table *hashtable, const char *key);
+bool hashtable_enable_bloom(Hash_Table *hashtable, int expected_keys, double false_positive_rate);
+void hashtable_rebuild_bloom(Hash_Table *hashtable);
+void hashtable_disable_bloom(Hash_Table *hashtable);
+
+
+// returns NULL if out of memory
 Hash_Table* create_hashtable(int size){
-    Hash_Table *hashtable = malloc(sizeof(Hash_Table));
-    check_address(hashtable);
-    hashtable->table=malloc(sizeof(Hash_Entry)*size);
+    return create_hashtable_with_allocator(size, default_allocator());
+}
+
+Hash_Table* create_hashtable_with_allocator(int size, Allocator *allocator){
+    Hash_Table *hashtable = allocator_allocate(allocator, sizeof(Hash_Table));
+    if (hashtable == NULL){
+        return NULL;
+    }
+    hashtable->table = allocator_allocate(allocator, sizeof(Hash_Entry *)*size);
+    if (hashtable->table == NULL){
+        allocator_release(allocator, hashtable, sizeof(Hash_Table));
+        return NULL;
+    }
+    hashtable->allocator = allocator;
     hashtable->size = size;
+    hashtable->count = 0;
+    hashtable->bloom = NULL;
+    hashtable->bloom_stale = 0;
     for (int i = 0; i<size; i++){
         hashtable->table[i]=NULL;
     }
     return hashtable;
 }
 
+// copy of string in allocator memory, NULL if out of memory
+static char* copy_string(Allocator *allocator, const char *string){
+    size_t size = strlen(string) + 1;
+    char *copy = allocator_allocate(allocator, size);
+    if (copy != NULL){
+        memcpy(copy, string, size);
+    }
+    return copy;
+}
+
+static void release_string(Allocator *allocator, char *string){
+    if (string != NULL){
+        allocator_release(allocator, string, strlen(string) + 1);
+    }
+}
+
+static void release_entry(Allocator *allocator, Hash_Entry *entry){
+    release_string(allocator, entry->key);
+    release_string(allocator, entry->value);
+    allocator_release(allocator, entry, sizeof(Hash_Entry));
+}
+
+void destroy_hashtable(Hash_Table *hashtable){
+    Allocator *allocator = hashtable->allocator;
+    for (int i = 0; i < hashtable->size; i++){
+        Hash_Entry *current = hashtable->table[i];
+        while (current != NULL){
+            Hash_Entry *next = current->next;
+            release_entry(allocator, current);
+            current = next;
+        }
+    }
+    hashtable_disable_bloom(hashtable);
+    allocator_release(allocator, hashtable->table, sizeof(Hash_Entry *)*hashtable->size);
+    allocator_release(allocator, hashtable, sizeof(Hash_Table));
+}
+
 int hash(const char *key, int table_size){
     unsigned long hash = 0;
     while(*key){
@@ -37,24 +112,44 @@ int hash(const char *key, int table_size){
     return hash % table_size;
 }
 
-void insert(Hash_Table *hashtable, const char *key, const char *value){
+// On CONTAINER_NO_MEMORY the table is unchanged, including the old value
+// of an existing key.
+ContainerStatus insert(Hash_Table *hashtable, const char *key, const char *value){
+    Allocator *allocator = hashtable->allocator;
     int index = hash(key, hashtable->size);
     
     Hash_Entry *hashentry = get(hashtable, key);
     if (hashentry != NULL){
-        free(hashentry->value);
-        hashentry->value=strdup(value);
-        return;
+        char *new_value = copy_string(allocator, value);
+        if (new_value == NULL){
+            return CONTAINER_NO_MEMORY;
+        }
+        release_string(allocator, hashentry->value);
+        hashentry->value = new_value;
+        return CONTAINER_OK;
     }
-    hashentry = malloc(sizeof(Hash_Entry));
-    hashentry->key = strdup(key);
-    hashentry->value = strdup(value);
-
-
+    hashentry = allocator_allocate(allocator, sizeof(Hash_Entry));
+    if (hashentry == NULL){
+        return CONTAINER_NO_MEMORY;
+    }
+    hashentry->key = copy_string(allocator, key);
+    hashentry->value = copy_string(allocator, value);
+    if (hashentry->key == NULL || hashentry->value == NULL){
+        release_entry(allocator, hashentry);
+        return CONTAINER_NO_MEMORY;
+    }
+    hashentry->next = hashtable->table[index];
+    hashtable->table[index] = hashentry;
+    hashtable->count++;
 
+    if (hashtable->bloom != NULL){
+        bloom_add(hashtable->bloom, key);
+    }
+    return CONTAINER_OK;
 }
 
-char* delete(Hash_Table *hashtable, const char *key){
+// returns false if the key was not in the table
+bool delete(Hash_Table *hashtable, const char *key){
     int index = hash(key, hashtable->size);
     Hash_Entry *current = hashtable->table[index];
     Hash_Entry *prev = NULL;
@@ -66,37 +161,134 @@ char* delete(Hash_Table *hashtable, const char *key){
             }else {
                 prev->next = current->next;
             }
-            free(current->key);
-            free(current->value);
-            free(current);
-            printf("Item Deleted");
-            return;
+            release_entry(hashtable->allocator, current);
+            hashtable->count--;
+
+            if (hashtable->bloom != NULL && ++hashtable->bloom_stale > hashtable->count){
+                hashtable_rebuild_bloom(hashtable);
+            }
+            return true;
         }
         prev = current;
         current = current->next;
     }
-
+    return false;
 }
 
 Hash_Entry* get(Hash_Table *hashtable, const char *key){
+    PERF_REGION_BEGIN(hashtable_get);
+    if (hashtable->bloom != NULL && !bloom_might_contain(hashtable->bloom, key)){
+        PERF_COUNT("hashtable.get_bloom_rejected", 1);
+        PERF_REGION_END(hashtable_get);
+        return NULL;
+    }
     int index = hash(key, hashtable->size);
     Hash_Entry *hashentry = hashtable->table[index];
+    int chain_length = 0;
     
     while (hashentry){
+        chain_length++;
         if (strcmp(hashentry->key, key) == 0){
+            PERF_SAMPLE("hashtable.get_chain_length", chain_length);
+            PERF_REGION_END(hashtable_get);
             return hashentry;
         }
 
         hashentry = hashentry->next;
     }
+    PERF_SAMPLE("hashtable.get_chain_length", chain_length);
+    PERF_REGION_END(hashtable_get);
     return NULL;
 }
 
+// Attaches a Bloom filter sized for expected_keys and fills it with the
+// keys already in the table. Returns false if out of memory or if
+// false_positive_rate is not in (0, 1), in which case get works as before.
+bool hashtable_enable_bloom(Hash_Table *hashtable, int expected_keys, double false_positive_rate){
+    BloomFilter *bloom = allocator_allocate(hashtable->allocator, sizeof(BloomFilter));
+    if (bloom == NULL){
+        return false;
+    }
+    if (expected_keys < hashtable->count){
+        expected_keys = hashtable->count;
+    }
+    if (!bloom_init_with_allocator(bloom, expected_keys, false_positive_rate, hashtable->allocator)){
+        allocator_release(hashtable->allocator, bloom, sizeof(BloomFilter));
+        return false;
+    }
+    hashtable_disable_bloom(hashtable);
+    hashtable->bloom = bloom;
+    hashtable_rebuild_bloom(hashtable);
+    return true;
+}
 
+// Clears the filter and adds the live keys again, dropping the deleted
+// ones. O(count), so delete only calls it once stale keys outnumber live.
+void hashtable_rebuild_bloom(Hash_Table *hashtable){
+    if (hashtable->bloom == NULL){
+        return;
+    }
+    bloom_clear(hashtable->bloom);
+    for (int i = 0; i < hashtable->size; i++){
+        for (Hash_Entry *entry = hashtable->table[i]; entry != NULL; entry = entry->next){
+            bloom_add(hashtable->bloom, entry->key);
+        }
+    }
+    hashtable->bloom_stale = 0;
+}
 
-void check_address(void *ptr){
-    if(ptr==NULL){
-        printf("Failure to allocate memory.\n Exiting Program.\n");
-        exit(EXIT_FAILURE);
+void hashtable_disable_bloom(Hash_Table *hashtable){
+    if (hashtable->bloom != NULL){
+        bloom_destroy(hashtable->bloom);
+        allocator_release(hashtable->allocator, hashtable->bloom, sizeof(BloomFilter));
+        hashtable->bloom = NULL;
     }
-}
\ No newline at end of file
+}
+
+
+#ifndef HASHTABLE_BENCH
+int main(){
+    Hash_Table *hashtable = create_hashtable(TABLE_SIZE);
+    char key[16];
+    char value[16];
+
+    for (int i = 0; i < 100; i++){
+        sprintf(key, "key%d", i);
+        sprintf(value, "value%d", i);
+        insert(hashtable, key, value);
+    }
+    insert(hashtable, "key7", "seven");
+    printf("Count: %d\n", hashtable->count); // Expecting 100
+    printf("key7: %s\n", get(hashtable, "key7")->value); // Expecting seven
+    printf("key42: %s\n", get(hashtable, "key42")->value); // Expecting value42
+
+    hashtable_enable_bloom(hashtable, 1000, 0.01);
+    int found = 0;
+    for (int i = 0; i < 100; i++){
+        sprintf(key, "key%d", i);
+        found += get(hashtable, key) != NULL;
+    }
+    printf("Found with filter: %d\n", found); // Expecting 100
+    printf("missing: %s\n", get(hashtable, "missing") ? "found" : "NULL"); // Expecting NULL
+
+    // deleting more than half the keys rebuilds the filter on the way
+    for (int i = 0; i < 60; i++){
+        sprintf(key, "key%d", i);
+        delete(hashtable, key);
+    }
+    printf("Delete twice: %s\n", delete(hashtable, "key0") ? "true" : "false"); // Expecting false
+    printf("Stale after rebuild: %d\n", hashtable->bloom_stale); // Expecting 9
+    found = 0;
+    for (int i = 0; i < 100; i++){
+        sprintf(key, "key%d", i);
+        found += get(hashtable, key) != NULL;
+    }
+    printf("Found after deletes: %d\n", found); // Expecting 40
+
+    insert(hashtable, "key0", "back");
+    printf("key0: %s\n", get(hashtable, "key0")->value); // Expecting back
+
+    destroy_hashtable(hashtable);
+    return 0;
+}
+#endif
@@ -0,0 +1,202 @@
+#include "sketch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <immintrin.h>
+
+// MurmurHash3's 64-bit finalizer
+static uint64_t mix64(uint64_t x){
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+uint64_t sketch_hash(const char *key){
+    uint64_t hash = 0;
+    while(*key){
+        hash = hash * 31 + (unsigned char)*key++;
+    }
+    return mix64(hash);
+}
+
+//=========== HyperLogLog ===================================
+
+void hll_init(HyperLogLog *hll){
+    memset(hll->registers, 0, sizeof(hll->registers));
+}
+
+// the top HLL_PRECISION bits pick the register, the rest give the rank
+void hll_add_hash(HyperLogLog *hll, uint64_t hash){
+    uint32_t index = hash >> (64 - HLL_PRECISION);
+    uint64_t rest = hash << HLL_PRECISION;
+    uint8_t rank = rest == 0 ? 64 - HLL_PRECISION + 1 : __builtin_clzll(rest) + 1;
+    if (rank > hll->registers[index]){
+        hll->registers[index] = rank;
+    }
+}
+
+void hll_add(HyperLogLog *hll, const char *key){
+    hll_add_hash(hll, sketch_hash(key));
+}
+
+double hll_count(const HyperLogLog *hll){
+    double sum = 0;
+    int zeros = 0;
+    for (int i = 0; i < HLL_REGISTERS; i++){
+        sum += ldexp(1.0, -hll->registers[i]);
+        zeros += hll->registers[i] == 0;
+    }
+    double m = HLL_REGISTERS;
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+
+    // small counts: linear counting on the empty registers is more exact
+    if (estimate <= 2.5 * m && zeros > 0){
+        estimate = m * log(m / zeros);
+    }
+    return estimate;
+}
+
+__attribute__((target("avx2")))
+static void hll_merge_avx2(uint8_t *into, const uint8_t *from){
+    for (int i = 0; i < HLL_REGISTERS; i += 32){
+        __m256i a = _mm256_load_si256((const __m256i *)(into + i));
+        __m256i b = _mm256_load_si256((const __m256i *)(from + i));
+        _mm256_store_si256((__m256i *)(into + i), _mm256_max_epu8(a, b));
+    }
+}
+
+// SSE2 is part of x86-64, so this is the fallback
+static void hll_merge_sse2(uint8_t *into, const uint8_t *from){
+    for (int i = 0; i < HLL_REGISTERS; i += 16){
+        __m128i a = _mm_load_si128((const __m128i *)(into + i));
+        __m128i b = _mm_load_si128((const __m128i *)(from + i));
+        _mm_store_si128((__m128i *)(into + i), _mm_max_epu8(a, b));
+    }
+}
+
+void hll_merge(HyperLogLog *into, const HyperLogLog *from){
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")){
+        hll_merge_avx2(into->registers, from->registers);
+    }else{
+        hll_merge_sse2(into->registers, from->registers);
+    }
+}
+
+//=========== Bloom filter ===================================
+
+bool bloom_init(BloomFilter *filter, size_t expected_items, double false_positive_rate){
+    return bloom_init_with_allocator(filter, expected_items, false_positive_rate, default_allocator());
+}
+
+bool bloom_init_with_allocator(BloomFilter *filter, size_t expected_items, double false_positive_rate,
+                               Allocator *allocator){
+    // written so NaN fails too
+    if (!(false_positive_rate > 0 && false_positive_rate < 1)){
+        return false;
+    }
+    if (expected_items == 0){
+        expected_items = 1;
+    }
+    // the textbook optimum for an unblocked filter, plus 20% because
+    // keeping each key in one block makes some blocks fuller than others
+    double bits = -(double)expected_items * log(false_positive_rate) / (M_LN2 * M_LN2);
+    uint32_t block_count = (uint32_t)ceil(bits * 1.2 / BLOOM_BLOCK_BITS);
+    if (block_count < 1){
+        block_count = 1;
+    }
+    int hashes = (int)lround(bits / expected_items * M_LN2);
+    if (hashes < 1){
+        hashes = 1;
+    }
+    if (hashes > BLOOM_MAX_HASHES){
+        hashes = BLOOM_MAX_HASHES;
+    }
+
+    // Allocator has no alignment argument, so take one block extra and
+    // start at the first block boundary inside it
+    size_t storage_size = sizeof(BloomBlock) * ((size_t)block_count + 1);
+    void *storage = allocator_allocate(allocator, storage_size);
+    if (storage == NULL){
+        return false;
+    }
+    uintptr_t aligned = ((uintptr_t)storage + sizeof(BloomBlock) - 1) & ~(uintptr_t)(sizeof(BloomBlock) - 1);
+    filter->blocks = (BloomBlock *)aligned;
+    filter->storage = storage;
+    filter->storage_size = storage_size;
+    filter->allocator = allocator;
+    memset(filter->blocks, 0, sizeof(BloomBlock) * (size_t)block_count);
+    filter->block_count = block_count;
+    filter->hashes = hashes;
+    return true;
+}
+
+void bloom_destroy(BloomFilter *filter){
+    allocator_release(filter->allocator, filter->storage, filter->storage_size);
+    filter->storage = NULL;
+    filter->blocks = NULL;
+}
+
+void bloom_clear(BloomFilter *filter){
+    memset(filter->blocks, 0, bloom_bytes(filter));
+}
+
+size_t bloom_bytes(const BloomFilter *filter){
+    return sizeof(BloomBlock) * (size_t)filter->block_count;
+}
+
+// The top 32 bits pick the block, scaled to block_count with a multiply
+// instead of a modulo. The bit positions inside it come from
+// double hashing on a second mix of the hash: position i is
+// first + i * step (mod 512), with step odd so the positions differ.
+void bloom_add_hash(BloomFilter *filter, uint64_t hash){
+    BloomBlock *block = &filter->blocks[((hash >> 32) * filter->block_count) >> 32];
+    uint64_t bits = mix64(hash);
+    uint32_t first = (uint32_t)bits;
+    uint32_t step = (uint32_t)(bits >> 32) | 1;
+    for (int i = 0; i < filter->hashes; i++){
+        uint32_t position = (first + i * step) & (BLOOM_BLOCK_BITS - 1);
+        block->words[position >> 6] |= 1ULL << (position & 63);
+    }
+}
+
+bool bloom_might_contain_hash(const BloomFilter *filter, uint64_t hash){
+    const BloomBlock *block = &filter->blocks[((hash >> 32) * filter->block_count) >> 32];
+    uint64_t bits = mix64(hash);
+    uint32_t first = (uint32_t)bits;
+    uint32_t step = (uint32_t)(bits >> 32) | 1;
+    for (int i = 0; i < filter->hashes; i++){
+        uint32_t position = (first + i * step) & (BLOOM_BLOCK_BITS - 1);
+        if (!(block->words[position >> 6] & (1ULL << (position & 63)))){
+            return false;
+        }
+    }
+    return true;
+}
+
+void bloom_add(BloomFilter *filter, const char *key){
+    bloom_add_hash(filter, sketch_hash(key));
+}
+
+bool bloom_might_contain(const BloomFilter *filter, const char *key){
+    return bloom_might_contain_hash(filter, sketch_hash(key));
+}
+
+bool bloom_merge(BloomFilter *into, const BloomFilter *from){
+    if (into->block_count != from->block_count || into->hashes != from->hashes){
+        return false;
+    }
+    // plain word loop; gcc vectorizes it at -O2 -ftree-vectorize and up
+    uint64_t *a = into->blocks[0].words;
+    const uint64_t *b = from->blocks[0].words;
+    size_t words = (size_t)into->block_count * (BLOOM_BLOCK_BITS / 64);
+    for (size_t i = 0; i < words; i++){
+        a[i] |= b[i];
+    }
+    return true;
+}
@@ -0,0 +1,77 @@
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "../allocator/allocator.h"
+
+/* Fixed-size sketches for when a full Hash_Table is more than we need.
+
+- HyperLogLog answers "about how many distinct keys" in 16 KB whatever
+  the input size, with about 0.8% standard error.
+- BloomFilter answers "probably seen / definitely not seen". Its size is
+  set once from the expected item count and the false positive rate
+  wanted. Each key touches one 64-byte block, so a lookup is one cache
+  miss.
+
+Both hash keys with the same hash * 31 + c loop as hash() in main.c,
+widened to 64 bits and finished with a bit mixer, since the sketches
+need well spread high bits.
+
+Sketches built on different threads combine with hll_merge and
+bloom_merge; merging gives the same result as adding every key to one
+sketch. */
+
+#define HLL_PRECISION 14
+#define HLL_REGISTERS (1 << HLL_PRECISION)
+#define BLOOM_BLOCK_BITS 512
+#define BLOOM_MAX_HASHES 16
+
+typedef struct HyperLogLog{
+    // the longest run of leading zeros + 1 seen for each bucket
+    _Alignas(64) uint8_t registers[HLL_REGISTERS];
+}HyperLogLog;
+
+typedef struct BloomBlock{
+    _Alignas(64) uint64_t words[BLOOM_BLOCK_BITS / 64];
+}BloomBlock;
+
+typedef struct BloomFilter{
+    BloomBlock *blocks;   // storage rounded up to a block boundary
+    void *storage;
+    size_t storage_size;
+    uint32_t block_count;
+    int hashes;           // bits set per key
+    Allocator *allocator;
+}BloomFilter;
+
+//Prototypes
+uint64_t sketch_hash(const char *key);
+
+void hll_init(HyperLogLog *hll);
+void hll_add(HyperLogLog *hll, const char *key);
+void hll_add_hash(HyperLogLog *hll, uint64_t hash);
+double hll_count(const HyperLogLog *hll);
+// into = max(into, from) register by register
+void hll_merge(HyperLogLog *into, const HyperLogLog *from);
+
+// returns false if out of memory or false_positive_rate is not in (0, 1)
+bool bloom_init(BloomFilter *filter, size_t expected_items, double false_positive_rate);
+bool bloom_init_with_allocator(BloomFilter *filter, size_t expected_items, double false_positive_rate,
+                               Allocator *allocator);
+void bloom_destroy(BloomFilter *filter);
+// removes every key, keeping the size
+void bloom_clear(BloomFilter *filter);
+void bloom_add(BloomFilter *filter, const char *key);
+void bloom_add_hash(BloomFilter *filter, uint64_t hash);
+bool bloom_might_contain(const BloomFilter *filter, const char *key);
+bool bloom_might_contain_hash(const BloomFilter *filter, uint64_t hash);
+// ORs from into into; false if the two were not created with the same
+// expected_items and false_positive_rate
+bool bloom_merge(BloomFilter *into, const BloomFilter *from);
+size_t bloom_bytes(const BloomFilter *filter);
+
+
+
+#endif
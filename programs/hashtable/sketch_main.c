@@ -0,0 +1,163 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include "sketch.h"
+
+/* Checks the sketches in sketch.c and times them.
+
+    gcc -O2 sketch_main.c sketch.c -lm -pthread -o sketch
+    ./sketch */
+
+#define THREADS 4
+#define KEYS_PER_THREAD 250000
+
+static double now_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void make_key(char *key, const char *prefix, int n){
+    sprintf(key, "%s%d", prefix, n);
+}
+
+typedef struct Shard{
+    int first;
+    int count;
+    HyperLogLog hll;
+    BloomFilter bloom;
+}Shard;
+
+// each thread fills its own sketches; nothing is shared until the merge
+static void *fill_shard(void *arg){
+    Shard *shard = arg;
+    char key[32];
+    hll_init(&shard->hll);
+    for (int i = shard->first; i < shard->first + shard->count; i++){
+        make_key(key, "user-", i);
+        hll_add(&shard->hll, key);
+        bloom_add(&shard->bloom, key);
+    }
+    return NULL;
+}
+
+int main(){
+    int total = THREADS * KEYS_PER_THREAD;
+    char key[32];
+    int failures = 0;
+
+    // one sketch fed every key, then every key again
+    HyperLogLog *whole = malloc(sizeof(HyperLogLog));
+    BloomFilter whole_bloom;
+    bloom_init(&whole_bloom, total, 0.01);
+    hll_init(whole);
+    double start = now_ns();
+    for (int pass = 0; pass < 2; pass++){
+        for (int i = 0; i < total; i++){
+            make_key(key, "user-", i);
+            hll_add(whole, key);
+            bloom_add(&whole_bloom, key);
+        }
+    }
+    double add_ns = (now_ns() - start) / (2.0 * total);
+
+    double estimate = hll_count(whole);
+    double error = fabs(estimate - total) / total;
+    printf("HLL: %d distinct, estimate %.0f, error %.2f%%\n", total, estimate, error * 100);
+    failures += error > 0.03;
+
+    HyperLogLog small;
+    hll_init(&small);
+    for (int i = 0; i < 1000; i++){
+        make_key(key, "small-", i % 100);
+        hll_add(&small, key);
+    }
+    printf("HLL: 100 distinct, estimate %.1f\n", hll_count(&small)); // Expecting about 100
+    failures += fabs(hll_count(&small) - 100) > 3;
+
+    // the same keys split over threads, then merged
+    Shard *shards = malloc(sizeof(Shard) * THREADS);
+    pthread_t threads[THREADS];
+    for (int t = 0; t < THREADS; t++){
+        shards[t].first = t * KEYS_PER_THREAD;
+        shards[t].count = KEYS_PER_THREAD;
+        bloom_init(&shards[t].bloom, total, 0.01);
+        pthread_create(&threads[t], NULL, fill_shard, &shards[t]);
+    }
+    for (int t = 0; t < THREADS; t++){
+        pthread_join(threads[t], NULL);
+    }
+    for (int t = 1; t < THREADS; t++){
+        hll_merge(&shards[0].hll, &shards[t].hll);
+        bloom_merge(&shards[0].bloom, &shards[t].bloom);
+    }
+    bool hll_same = memcmp(shards[0].hll.registers, whole->registers, HLL_REGISTERS) == 0;
+    bool bloom_same = memcmp(shards[0].bloom.blocks, whole_bloom.blocks, bloom_bytes(&whole_bloom)) == 0;
+    printf("Merged HLL matches single: %s\n", hll_same ? "true" : "false"); // Expecting true
+    printf("Merged Bloom matches single: %s\n", bloom_same ? "true" : "false"); // Expecting true
+    failures += !hll_same + !bloom_same;
+
+    BloomFilter other;
+    bloom_init(&other, total / 2, 0.01);
+    bool refused = !bloom_merge(&other, &whole_bloom);
+    printf("Merge of different sizes refused: %s\n", refused ? "true" : "false"); // Expecting true
+    failures += !refused;
+    bloom_destroy(&other);
+
+    // rates outside (0, 1) are refused; a rate near 1 still gets one block
+    bool rejected = !bloom_init(&other, 100, 0) && !bloom_init(&other, 100, 1) &&
+                    !bloom_init(&other, 100, -0.5) && !bloom_init(&other, 100, NAN);
+    printf("Bad false positive rates refused: %s\n", rejected ? "true" : "false"); // Expecting true
+    failures += !rejected;
+    bool one_block = bloom_init(&other, 1, 0.99) && other.block_count == 1;
+    printf("Loose filter has one block: %s\n", one_block ? "true" : "false"); // Expecting true
+    failures += !one_block;
+    if (one_block){
+        bloom_add(&other, "key");
+        failures += !bloom_might_contain(&other, "key");
+        bloom_destroy(&other);
+    }
+
+    // no false negatives, and about 1% false positives
+    int missing = 0;
+    for (int i = 0; i < total; i++){
+        make_key(key, "user-", i);
+        missing += !bloom_might_contain(&whole_bloom, key);
+    }
+    int false_positives = 0;
+    start = now_ns();
+    for (int i = 0; i < total; i++){
+        make_key(key, "stranger-", i);
+        false_positives += bloom_might_contain(&whole_bloom, key);
+    }
+    double query_ns = (now_ns() - start) / total;
+    double rate = (double)false_positives / total;
+    printf("Bloom: %d false negatives, %.3f%% false positives (target 1%%), %d hashes\n",
+           missing, rate * 100, whole_bloom.hashes);
+    failures += missing != 0 || rate > 0.02;
+
+    printf("Memory: HLL %zu bytes, Bloom %zu bytes for %d keys\n",
+           sizeof(HyperLogLog), bloom_bytes(&whole_bloom), total);
+    printf("Time: %.1f ns per add to both, %.1f ns per Bloom query (key formatting included)\n",
+           add_ns, query_ns);
+
+    start = now_ns();
+    for (int i = 0; i < 10000; i++){
+        hll_merge(&shards[0].hll, &shards[1 + i % (THREADS - 1)].hll);
+    }
+    printf("Time: %.0f ns per HLL merge\n", (now_ns() - start) / 10000);
+
+    for (int t = 0; t < THREADS; t++){
+        bloom_destroy(&shards[t].bloom);
+    }
+    free(shards);
+    bloom_destroy(&whole_bloom);
+    free(whole);
+
+    printf("%s\n", failures == 0 ? "All sketch tests passed" : "Sketch tests FAILED");
+    return failures != 0;
+}
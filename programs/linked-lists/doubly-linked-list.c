@@ -0,0 +1,319 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../allocator/allocator.h"
+
+/* Doubly linked variant of linked-list-a1.c. Keeping a tail pointer and a
+prev link on every node makes push/pop/peek O(1) at both ends, so the list
+can be used as a deque. value_at and value_n_from_end walk from whichever
+end is closer. */
+
+typedef struct DNode{
+    int data;
+    struct DNode *next;
+    struct DNode *prev;
+}DNode;
+
+typedef struct DLinkedList{
+    DNode *head;
+    DNode *tail;
+    int size;
+    Allocator *allocator;
+}DLinkedList;
+
+
+
+
+DLinkedList* dlist_create();
+DLinkedList* dlist_create_with_allocator(Allocator *allocator);
+void dlist_destroy(DLinkedList *list);
+int dlist_size(DLinkedList *list);
+bool dlist_empty(DLinkedList *list);
+int dlist_value_at(DLinkedList *list, int index);
+ContainerStatus dlist_push_front(DLinkedList *list, int value);
+int dlist_pop_front(DLinkedList *list);
+ContainerStatus dlist_push_back(DLinkedList *list, int value);
+int dlist_pop_back(DLinkedList *list);
+int dlist_front(DLinkedList *list);
+int dlist_back(DLinkedList *list);
+ContainerStatus dlist_insert(DLinkedList *list, int index, int value);
+void dlist_erase(DLinkedList *list, int index);
+int dlist_value_n_from_end(DLinkedList *list, int n);
+void dlist_reverse(DLinkedList *list);
+void dlist_remove_value(DLinkedList *list, int value);
+
+
+
+// returns NULL if out of memory
+DLinkedList* dlist_create(){
+    return dlist_create_with_allocator(default_allocator());
+}
+
+DLinkedList* dlist_create_with_allocator(Allocator *allocator){
+    DLinkedList *list = allocator_allocate(allocator, sizeof(DLinkedList));
+    if (list == NULL){
+        return NULL;
+    }
+    list->allocator = allocator;
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+    return list;
+}
+
+void dlist_destroy(DLinkedList *list){
+    DNode *current = list->head;
+    while(current != NULL){
+        DNode *next = current->next;
+        allocator_release(list->allocator, current, sizeof(DNode));
+        current = next;
+    }
+    allocator_release(list->allocator, list, sizeof(DLinkedList));
+}
+
+int dlist_size(DLinkedList *list){
+    return list->size;
+}
+
+bool dlist_empty(DLinkedList *list){
+    return list->size==0;
+}
+
+// walks from the closer end, so the worst case is size/2 steps
+static DNode* dlist_node_at(DLinkedList *list, int index){
+    DNode *current;
+    if(index < list->size / 2){
+        current = list->head;
+        for(int i = 0; i < index; i++){
+            current = current->next;
+        }
+    }else{
+        current = list->tail;
+        for(int i = list->size - 1; i > index; i--){
+            current = current->prev;
+        }
+    }
+    return current;
+}
+
+// unlinks node from the list and frees it, returning its value
+static int dlist_unlink(DLinkedList *list, DNode *node){
+    if(node->prev != NULL){
+        node->prev->next = node->next;
+    }else{
+        list->head = node->next;
+    }
+    if(node->next != NULL){
+        node->next->prev = node->prev;
+    }else{
+        list->tail = node->prev;
+    }
+    int removed_value = node->data;
+    allocator_release(list->allocator, node, sizeof(DNode));
+    list->size--;
+    return removed_value;
+}
+
+int dlist_value_at(DLinkedList *list, int index){
+    if(index < 0 || index >= list->size){
+        return -1;
+    }
+    return dlist_node_at(list, index)->data;
+}
+
+// the push and insert functions return CONTAINER_NO_MEMORY and leave the
+// list unchanged when a node cannot be allocated
+ContainerStatus dlist_push_front(DLinkedList *list, int value){
+    DNode *new_node = allocator_allocate(list->allocator, sizeof(DNode));
+    if (new_node == NULL){
+        return CONTAINER_NO_MEMORY;
+    }
+
+    new_node->data = value;
+    new_node->prev = NULL;
+    new_node->next = list->head;
+    if(list->head != NULL){
+        list->head->prev = new_node;
+    }else{
+        list->tail = new_node;
+    }
+    list->head = new_node;
+    list->size++;
+    return CONTAINER_OK;
+}
+
+int dlist_pop_front(DLinkedList *list){
+    if(dlist_empty(list)){
+        return -1;
+    }
+    return dlist_unlink(list, list->head);
+}
+
+ContainerStatus dlist_push_back(DLinkedList *list, int value){
+    DNode *new_node = allocator_allocate(list->allocator, sizeof(DNode));
+    if (new_node == NULL){
+        return CONTAINER_NO_MEMORY;
+    }
+
+    new_node->data = value;
+    new_node->next = NULL;
+    new_node->prev = list->tail;
+    if(list->tail != NULL){
+        list->tail->next = new_node;
+    }else{
+        list->head = new_node;
+    }
+    list->tail = new_node;
+    list->size++;
+    return CONTAINER_OK;
+}
+
+int dlist_pop_back(DLinkedList *list){
+    if(dlist_empty(list)){
+        return -1;
+    }
+    return dlist_unlink(list, list->tail);
+}
+
+int dlist_front(DLinkedList *list){
+    if(dlist_empty(list)){
+        return -1;
+    }
+    return list->head->data;
+}
+
+int dlist_back(DLinkedList *list){
+    if(dlist_empty(list)){
+        return -1;
+    }
+    return list->tail->data;
+}
+
+// an index out of range is ignored
+ContainerStatus dlist_insert(DLinkedList *list, int index, int value){
+    if(index < 0 || index > list->size){
+        return CONTAINER_OK;
+    }
+
+    if (index == 0){
+        return dlist_push_front(list, value);
+    }else if(index == list->size){
+        return dlist_push_back(list, value);
+    }
+
+    DNode *new_node = allocator_allocate(list->allocator, sizeof(DNode));
+    if(new_node == NULL){
+        return CONTAINER_NO_MEMORY;
+    }
+    DNode *current = dlist_node_at(list, index); // node being shifted right
+    new_node->data = value;
+    new_node->next = current;
+    new_node->prev = current->prev;
+    current->prev->next = new_node;
+    current->prev = new_node;
+    list->size++;
+    return CONTAINER_OK;
+}
+
+void dlist_erase(DLinkedList *list, int index){
+    if(index < 0 || index >= list->size){
+        return;
+    }
+    dlist_unlink(list, dlist_node_at(list, index));
+}
+
+int dlist_value_n_from_end(DLinkedList *list, int n){
+    if(n < 0 || n >= list->size){
+        return -1;
+    }
+
+    DNode *current = list->tail;
+    for(int i = 0; i < n; i++){
+        current = current->prev;
+    }
+    return current->data;
+}
+
+void dlist_reverse(DLinkedList *list){
+    DNode *current = list->head;
+    while(current != NULL){
+        DNode *next = current->next;
+        current->next = current->prev;
+        current->prev = next;
+        current = next;
+    }
+    DNode *old_head = list->head;
+    list->head = list->tail;
+    list->tail = old_head;
+}
+
+void dlist_remove_value(DLinkedList *list, int value){
+    DNode *current = list->head;
+    while(current != NULL && current->data != value){
+        current = current->next;
+    }
+    if(current != NULL){
+        dlist_unlink(list, current);
+    }
+}
+
+
+
+#ifndef LINKED_LIST_BENCH
+int main() {
+    DLinkedList* list = dlist_create();
+
+    printf("Testing empty list:\n");
+    printf("Is empty? %s\n", dlist_empty(list) ? "true" : "false");
+    printf("Front: %d\n", dlist_front(list)); // Expecting -1
+    printf("Back: %d\n", dlist_back(list)); // Expecting -1
+    printf("Pop back: %d\n", dlist_pop_back(list)); // Expecting -1
+
+    printf("\nTesting push_front and push_back:\n");
+    dlist_push_front(list, 10);
+    dlist_push_back(list, 20);
+    dlist_push_front(list, 5);
+    dlist_push_back(list, 25);
+    printf("Size: %d\n", dlist_size(list)); // Expecting 4
+    printf("Front: %d\n", dlist_front(list)); // Expecting 5
+    printf("Back: %d\n", dlist_back(list)); // Expecting 25
+    printf("Value at index 2: %d\n", dlist_value_at(list, 2)); // Expecting 20
+
+    printf("\nTesting pop_front and pop_back:\n");
+    printf("Pop front: %d\n", dlist_pop_front(list)); // Expecting 5
+    printf("Pop back: %d\n", dlist_pop_back(list)); // Expecting 25
+    printf("Back: %d\n", dlist_back(list)); // Expecting 20
+
+    printf("\nTesting insert and erase:\n");
+    dlist_insert(list, 1, 15);
+    printf("Value at index 1 (after insert): %d\n", dlist_value_at(list, 1)); // Expecting 15
+    dlist_erase(list, 1);
+    printf("Value at index 1 (after erase): %d\n", dlist_value_at(list, 1)); // Expecting 20
+
+    printf("\nTesting value_n_from_end:\n");
+    dlist_push_back(list, 30);
+    printf("Value 1 from end: %d\n", dlist_value_n_from_end(list, 1)); // Expecting 20
+    printf("Value 2 from end: %d\n", dlist_value_n_from_end(list, 2)); // Expecting 10
+
+    printf("\nTesting reverse:\n");
+    dlist_reverse(list);
+    printf("Front after reverse: %d\n", dlist_front(list)); // Expecting 30
+    printf("Back after reverse: %d\n", dlist_back(list)); // Expecting 10
+
+    printf("\nTesting remove_value:\n");
+    dlist_push_front(list, 30);
+    dlist_remove_value(list, 30);
+    printf("Size after removing 30: %d\n", dlist_size(list)); // Expecting 3
+    printf("Front after removing 30: %d\n", dlist_front(list)); // Expecting 30
+
+    printf("\nFinal state of the list:\n");
+    for (int i = 0; i < dlist_size(list); i++) {
+        printf("Value at index %d: %d\n", i, dlist_value_at(list, i));
+    }
+
+    dlist_destroy(list);
+
+    printf("\nAll tests completed.\n");
+    return 0;
+}
+#endif
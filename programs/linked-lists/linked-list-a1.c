@@ -1,46 +1,133 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include "../perf-counters/perf_counters.h"
+#include "../allocator/allocator.h"
 
 
 typedef struct Node{
     int data;
+    bool pooled; // part of a NodePool block, sits in the padding after data
     struct Node *next;
 }Node;
 
+// one allocation holding many nodes, made by list_from_array
+typedef struct NodePool{
+    struct NodePool *next;
+    int count;
+    Node nodes[];
+}NodePool;
+
 typedef struct LinkedList{
     Node *head;
+    Node *tail;
     int size;
+    Node *free_nodes; // removed pooled nodes, reused before allocating
+    Node *last_free_node;
+    NodePool *pools;
+    NodePool *last_pool; // the ends let splice hand both lists over in O(1)
+    Allocator *allocator;
 }LinkedList;
 
 
 
 
 LinkedList* create_list();
+LinkedList* create_list_with_allocator(Allocator *allocator);
 int size(LinkedList *list);
 bool empty(LinkedList *list);
 int value_at(LinkedList *list, int index);
-void push_front(LinkedList *list, int value);
+ContainerStatus push_front(LinkedList *list, int value);
 int pop_front(LinkedList *list);
-void push_back(LinkedList *list, int value);
+ContainerStatus push_back(LinkedList *list, int value);
 int pop_back(LinkedList *list);
 int front(LinkedList *list);
 int back(LinkedList *list);
-void insert (LinkedList *list, int index, int value);
+ContainerStatus insert (LinkedList *list, int index, int value);
 void erase(LinkedList *list, int index);
 int value_n_from_end(LinkedList *list, int n);
 void reverse(LinkedList *list);
 void remove_value(LinkedList *list, int value);   
+void destroy_list(LinkedList *list);
+LinkedList* list_from_array(const int *values, int count);
+LinkedList* list_from_array_with_allocator(const int *values, int count, Allocator *allocator);
+bool list_concat(LinkedList *dest, LinkedList *src);
+bool list_splice(LinkedList *dest, int index, LinkedList *src);
+void list_sort(LinkedList *list);
 
 
 
+// returns NULL if out of memory
 LinkedList* create_list(){
-    LinkedList *list = malloc(sizeof(LinkedList));
+    return create_list_with_allocator(default_allocator());
+}
+
+LinkedList* create_list_with_allocator(Allocator *allocator){
+    LinkedList *list = allocator_allocate(allocator, sizeof(LinkedList));
+    if (list == NULL){
+        return NULL;
+    }
+    list->allocator = allocator;
     list->head = NULL;
+    list->tail = NULL;
     list->size = 0;
+    list->free_nodes = NULL;
+    list->last_free_node = NULL;
+    list->pools = NULL;
+    list->last_pool = NULL;
     return list;
 }
 
+void destroy_list(LinkedList *list){
+    Node *current = list->head;
+    while(current != NULL){
+        Node *next = current->next;
+        if(!current->pooled){
+            allocator_release(list->allocator, current, sizeof(Node));
+        }
+        current = next;
+    }
+    NodePool *pool = list->pools;
+    while(pool != NULL){
+        NodePool *next = pool->next;
+        allocator_release(list->allocator, pool, sizeof(NodePool) + sizeof(Node) * pool->count);
+        pool = next;
+    }
+    allocator_release(list->allocator, list, sizeof(LinkedList));
+}
+
+// takes a recycled pooled node if there is one, otherwise allocates one
+static Node* new_node(LinkedList *list, int value){
+    Node *node = list->free_nodes;
+    if(node != NULL){
+        list->free_nodes = node->next;
+        if(list->free_nodes == NULL){
+            list->last_free_node = NULL;
+        }
+    }else{
+        node = allocator_allocate(list->allocator, sizeof(Node));
+        if(node == NULL){
+            return NULL;
+        }
+        node->pooled = false;
+        PERF_COUNT("list.node_mallocs", 1);
+    }
+    node->data = value;
+    return node;
+}
+
+static void release_node(LinkedList *list, Node *node){
+    if(node->pooled){
+        node->next = list->free_nodes;
+        list->free_nodes = node;
+        if(list->last_free_node == NULL){
+            list->last_free_node = node;
+        }
+    }else{
+        allocator_release(list->allocator, node, sizeof(Node));
+    }
+}
+
 int size(LinkedList *list){
     return list->size;
 }
@@ -53,24 +140,32 @@ int value_at(LinkedList *list, int index){
     if(empty(list) || index < 0 || index>= list->size){
         return -1;
     }
+    PERF_REGION_BEGIN(list_value_at);
     Node *current = list->head;
     for(int i = 0; i < index; i++){
         current = current->next;
     }
+    PERF_SAMPLE("list.value_at_hops", index);
+    PERF_REGION_END(list_value_at);
     return current->data;
 }
 
 
-void push_front(LinkedList *list, int value){
-    Node *new_node = malloc(sizeof(Node));
-    if (new_node == NULL){
-        return;
+// push_front, push_back and insert return CONTAINER_NO_MEMORY and leave
+// the list unchanged when a node cannot be allocated
+ContainerStatus push_front(LinkedList *list, int value){
+    Node *node = new_node(list, value);
+    if (node == NULL){
+        return CONTAINER_NO_MEMORY;
     }
 
-    new_node->data=value;
-    new_node->next=list->head;
-    list->head = new_node;
+    node->next=list->head;
+    list->head = node;
+    if(list->tail == NULL){
+        list->tail = node;
+    }
     list->size++;
+    return CONTAINER_OK;
 }
 
 int pop_front(LinkedList *list){
@@ -79,32 +174,29 @@ int pop_front(LinkedList *list){
     }
     Node *old_head = list->head;
     list->head = old_head->next;
+    if(list->head == NULL){
+        list->tail = NULL;
+    }
     int removed_value = old_head->data;
-    free(old_head);
+    release_node(list, old_head);
     list->size--;
     return removed_value;
 }
 
-void push_back(LinkedList *list, int value){
+ContainerStatus push_back(LinkedList *list, int value){
     if(empty(list)){
-        push_front(list, value);
-        return;
+        return push_front(list, value);
     }
-    Node *new_node = malloc(sizeof(Node));
-    if(new_node == NULL){
-        return;
+    Node *node = new_node(list, value);
+    if(node == NULL){
+        return CONTAINER_NO_MEMORY;
     }
-    new_node->data=value;
-    new_node->next=NULL;
-
-    Node *current = list->head;
+    node->next=NULL;
 
-    while(current->next!=NULL){ //gets to last item
-        current = current->next;
-    }
-    current->next = new_node;
+    list->tail->next = node;
+    list->tail = node;
     list->size++;
-
+    return CONTAINER_OK;
 }
 
 int pop_back(LinkedList *list){
@@ -122,7 +214,8 @@ int pop_back(LinkedList *list){
     Node *old_node = current->next;
     int return_value = old_node->data;
     current->next = NULL;
-    free(old_node);
+    list->tail = current;
+    release_node(list, old_node);
     list->size--;
     return return_value;
 }
@@ -138,35 +231,33 @@ int back(LinkedList *list){
     if(empty(list)){
         return -1;
     }
-    Node *current = list->head;
-    while(current->next!=NULL){
-        current = current->next;
-    }
-    return current->data;
+    return list->tail->data;
 }
 
-void insert (LinkedList *list, int index, int value){
+// an index out of range is ignored
+ContainerStatus insert (LinkedList *list, int index, int value){
     if(index < 0 || index> list->size){
-        return;
+        return CONTAINER_OK;
     }
 
     if (index == 0){
-        push_front(list, value);
-        return;
+        return push_front(list, value);
+    }else if(index == list->size){
+        return push_back(list, value);
     }
 
-    Node *new_node = malloc(sizeof(Node));
-    new_node->data = value;
-    if(new_node == NULL){
-        return;
+    Node *node = new_node(list, value);
+    if(node == NULL){
+        return CONTAINER_NO_MEMORY;
     }
     Node *current = list->head;
     for(int i = 0; i<index-1; i++){
         current = current->next;
     }
-    new_node->next = current->next;
-    current->next = new_node;
+    node->next = current->next;
+    current->next = node;
     list->size++;
+    return CONTAINER_OK;
 }
 
 void erase(LinkedList *list, int index){
@@ -174,6 +265,9 @@ void erase(LinkedList *list, int index){
         return;
     }else if(index<0 || index>=list->size){
         return;
+    }else if(index == 0){
+        pop_front(list);
+        return;
     }
 
     Node *current = list->head;
@@ -182,7 +276,10 @@ void erase(LinkedList *list, int index){
     }
     Node *removed_node = current->next;
     current->next=removed_node->next;
-    free(removed_node);
+    if(list->tail == removed_node){
+        list->tail = current;
+    }
+    release_node(list, removed_node);
     list->size--;
 }
 
@@ -214,6 +311,7 @@ void reverse(LinkedList *list){
         current = next;
 
     }
+    list->tail = list->head;
     list->head = prev;
 }
 
@@ -234,15 +332,179 @@ void remove_value(LinkedList *list, int value){
     if(current->next != NULL){
         Node *removed_value = current->next;
         current->next= removed_value->next;
-        free(removed_value);
+        if(list->tail == removed_value){
+            list->tail = current;
+        }
+        release_node(list, removed_value);
         list->size--;
 
     }
 }    
 
+// Builds a list from count values with a single allocation for all nodes.
+// Returns NULL if out of memory.
+LinkedList* list_from_array(const int *values, int count){
+    return list_from_array_with_allocator(values, count, default_allocator());
+}
+
+LinkedList* list_from_array_with_allocator(const int *values, int count, Allocator *allocator){
+    LinkedList *list = create_list_with_allocator(allocator);
+    if(list == NULL || count <= 0){
+        return list;
+    }
+
+    NodePool *pool = allocator_allocate(allocator, sizeof(NodePool) + sizeof(Node) * count);
+    if(pool == NULL){
+        allocator_release(allocator, list, sizeof(LinkedList));
+        return NULL;
+    }
+    pool->next = NULL;
+    pool->count = count;
+    list->pools = pool;
+    list->last_pool = pool;
+
+    Node *nodes = pool->nodes;
+    for(int i = 0; i < count; i++){
+        nodes[i].data = values[i];
+        nodes[i].pooled = true;
+        nodes[i].next = &nodes[i + 1];
+    }
+    nodes[count - 1].next = NULL;
+    list->head = &nodes[0];
+    list->tail = &nodes[count - 1];
+    list->size = count;
+    return list;
+}
+
+// hands src's pools and recycled nodes to dest, since dest now owns the nodes
+static void adopt_storage(LinkedList *dest, LinkedList *src){
+    if(src->pools != NULL){
+        src->last_pool->next = dest->pools;
+        dest->pools = src->pools;
+        if(dest->last_pool == NULL){
+            dest->last_pool = src->last_pool;
+        }
+        src->pools = NULL;
+        src->last_pool = NULL;
+    }
+    if(src->free_nodes != NULL){
+        src->last_free_node->next = dest->free_nodes;
+        dest->free_nodes = src->free_nodes;
+        if(dest->last_free_node == NULL){
+            dest->last_free_node = src->last_free_node;
+        }
+        src->free_nodes = NULL;
+        src->last_free_node = NULL;
+    }
+}
+
+// Moves every node of src to the end of dest in O(1). src is left empty.
+// Returns false, moving nothing, under the same rules as list_splice.
+bool list_concat(LinkedList *dest, LinkedList *src){
+    return list_splice(dest, dest->size, src);
+}
+
+// Moves every node of src into dest before position index, leaving src
+// empty. Only the walk to index is O(n), linking src in is O(1). The
+// nodes change owner, so both lists must use the same allocator.
+// Returns false and moves nothing if they don't, if index is out of
+// range or if dest and src are the same list.
+bool list_splice(LinkedList *dest, int index, LinkedList *src){
+    if(index < 0 || index > dest->size || dest == src || dest->allocator != src->allocator){
+        return false;
+    }
+    adopt_storage(dest, src);
+    if(empty(src)){
+        return true;
+    }
+
+    if(index == 0){
+        src->tail->next = dest->head;
+        dest->head = src->head;
+        if(dest->tail == NULL){
+            dest->tail = src->tail;
+        }
+    }else if(index == dest->size){
+        dest->tail->next = src->head;
+        dest->tail = src->tail;
+    }else{
+        Node *current = dest->head;
+        for(int i = 0; i < index - 1; i++){
+            current = current->next;
+        }
+        src->tail->next = current->next;
+        current->next = src->head;
+    }
+    dest->size += src->size;
+
+    src->head = NULL;
+    src->tail = NULL;
+    src->size = 0;
+    return true;
+}
+
+// Bottom-up merge sort: merges runs of width 1, 2, 4, ... in place by
+// relinking nodes. No recursion and no allocation, O(n log n) and stable.
+void list_sort(LinkedList *list){
+    if(list->size < 2){
+        return;
+    }
+
+    for(int width = 1; width < list->size; width *= 2){
+        Node *remaining = list->head;
+        Node *merged_tail = NULL;
+        list->head = NULL;
+
+        while(remaining != NULL){
+            // cut two runs of up to width nodes off the front of remaining
+            Node *left = remaining;
+            Node *right = left;
+            for(int i = 1; i < width && right->next != NULL; i++){
+                right = right->next;
+            }
+            Node *left_end = right;
+            right = left_end->next;
+            left_end->next = NULL;
+
+            remaining = NULL;
+            if(right != NULL){
+                Node *right_end = right;
+                for(int i = 1; i < width && right_end->next != NULL; i++){
+                    right_end = right_end->next;
+                }
+                remaining = right_end->next;
+                right_end->next = NULL;
+            }
+
+            // merge left and right onto the end of the output
+            while(left != NULL || right != NULL){
+                Node *next;
+                if(right == NULL || (left != NULL && left->data <= right->data)){
+                    next = left;
+                    left = left->next;
+                }else{
+                    next = right;
+                    right = right->next;
+                }
+                if(merged_tail == NULL){
+                    list->head = next;
+                }else{
+                    merged_tail->next = next;
+                }
+                merged_tail = next;
+            }
+        }
+        merged_tail->next = NULL;
+        list->tail = merged_tail;
+    }
+}
+
 
 
 
+#ifndef LINKED_LIST_BENCH
+#include "../allocator/allocator.c"
+
 int main() {
     LinkedList* list = create_list();
 
@@ -306,12 +568,69 @@ int main() {
         printf("Value at index %d: %d\n", i, value_at(list, i));
     }
 
-    // Free the list
-    while (!empty(list)) {
-        pop_front(list);
+    printf("\nTesting list_from_array, list_concat and list_splice:\n");
+    int values[] = {7, 3, 9, 1};
+    LinkedList *pooled = list_from_array(values, 4);
+    printf("Pooled size: %d\n", size(pooled)); // Expecting 4
+    printf("Pooled back: %d\n", back(pooled)); // Expecting 1
+    printf("Concat: %s\n", list_concat(list, pooled) ? "moved" : "refused"); // Expecting moved
+    printf("Size after concat: %d\n", size(list)); // Expecting 7
+    printf("Back after concat: %d\n", back(list)); // Expecting 1
+    printf("Pooled size after concat: %d\n", size(pooled)); // Expecting 0
+    int more[] = {42, 42};
+    LinkedList *spliced = list_from_array(more, 2);
+    printf("Splice past the end: %s\n", list_splice(list, 8, spliced) ? "moved" : "refused"); // Expecting refused
+    printf("Splice: %s\n", list_splice(list, 1, spliced) ? "moved" : "refused"); // Expecting moved
+    printf("Value at index 1 after splice: %d\n", value_at(list, 1)); // Expecting 42
+    printf("Size after splice: %d\n", size(list)); // Expecting 9
+    destroy_list(pooled);
+    destroy_list(spliced);
+
+    // recycled pooled nodes move with their pool and are reused by dest
+    int recycled[] = {1, 2, 3, 4};
+    LinkedList *first = list_from_array(recycled, 4);
+    LinkedList *second = list_from_array(recycled, 4);
+    pop_front(first);
+    pop_front(second);
+    pop_front(second);
+    list_concat(first, second);
+    list_concat(first, second); // src is empty now, nothing moves
+    for (int i = 0; i < 3; i++) {
+        push_back(first, 50 + i); // takes the three recycled nodes
+    }
+    printf("Size after reusing nodes: %d\n", size(first)); // Expecting 8
+    printf("Back after reusing nodes: %d\n", back(first)); // Expecting 52
+    destroy_list(first);
+    destroy_list(second);
+
+    printf("\nTesting list_sort:\n");
+    list_sort(list);
+    for (int i = 0; i < size(list); i++) {
+        printf("%d ", value_at(list, i)); // Expecting 1 3 7 9 10 20 30 42 42
     }
-    free(list);
+    printf("\nBack after sort: %d\n", back(list)); // Expecting 42
+
+    destroy_list(list);
+
+    printf("\nTesting out of memory:\n");
+    TrackingAllocator tracker;
+    tracking_allocator_init(&tracker, NULL);
+    LinkedList *tracked = create_list_with_allocator(&tracker.allocator);
+    push_back(tracked, 1);
+    tracker.fail_after = tracker.allocations;
+    printf("push_back: %s\n", push_back(tracked, 2) == CONTAINER_NO_MEMORY ? "no memory" : "ok"); // Expecting no memory
+    printf("insert: %s\n", insert(tracked, 0, 2) == CONTAINER_NO_MEMORY ? "no memory" : "ok"); // Expecting no memory
+    printf("Size: %d, back: %d\n", size(tracked), back(tracked)); // Expecting 1, 1
+    // nodes can't change allocator, so lists on different ones don't splice
+    LinkedList *plain = list_from_array(values, 4);
+    printf("Concat across allocators: %s\n", list_concat(tracked, plain) ? "moved" : "refused"); // Expecting refused
+    printf("Sizes: %d, %d\n", size(tracked), size(plain)); // Expecting 1, 4
+    destroy_list(plain);
+    printf("list_from_array: %s\n", list_from_array_with_allocator(values, 4, &tracker.allocator) ? "ok" : "NULL"); // Expecting NULL
+    destroy_list(tracked);
+    printf("Bytes live: %zu\n", tracker.bytes_live); // Expecting 0
 
     printf("\nAll tests completed.\n");
     return 0;
 }
+#endif
@@ -0,0 +1,284 @@
+#define LINKED_LIST_BENCH
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#include "linked-list-a1.c"
+#include "doubly-linked-list.c"
+#include "unrolled-linked-list.c"
+#include "skip-list.c"
+
+/* Times the tail operations of the singly linked list in linked-list-a1.c
+against the doubly linked variant. The singly list keeps a tail pointer but
+still has to walk the whole list for pop_back/value_n_from_end, so it gets
+far fewer repetitions at large sizes.
+
+The traversal section times full walks (value_at of the last index,
+remove_value of a missing value, reverse) of the singly list against the
+unrolled list. "scattered" links the singly nodes in shuffled allocation
+order, which is what a long-lived heap looks like.
+
+The positional section times random value_at and insert+erase of the
+singly list against the indexable skip list.
+
+The bulk section builds a list with a push_back loop and with
+list_from_array, then sorts it with list_sort.
+
+    gcc -O2 linked-list-bench.c -o bench
+    ./bench            (1K, 1M and 10M elements)
+    ./bench 1000000    (stop at 1M) */
+
+static double now_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile int sink;
+
+static void bench_singly(int n){
+    LinkedList *list = create_list();
+    for(int i = 0; i < n; i++){
+        push_front(list, i);
+    }
+    int reps = n <= 1000 ? 100000 : (n <= 1000000 ? 200 : 20);
+
+    double start = now_ns();
+    for(int i = 0; i < reps; i++){
+        sink = back(list);
+    }
+    double back_ns = (now_ns() - start) / reps;
+
+    start = now_ns();
+    for(int i = 0; i < reps; i++){
+        push_back(list, i);
+        sink = pop_back(list);
+    }
+    double push_pop_ns = (now_ns() - start) / reps;
+
+    start = now_ns();
+    for(int i = 0; i < reps; i++){
+        sink = value_n_from_end(list, 0);
+    }
+    double nth_ns = (now_ns() - start) / reps;
+
+    printf("%-8s %10d %14.1f %18.1f %20.1f\n", "singly", n, back_ns, push_pop_ns, nth_ns);
+
+    destroy_list(list);
+}
+
+static void bench_doubly(int n){
+    DLinkedList *list = dlist_create();
+    for(int i = 0; i < n; i++){
+        dlist_push_front(list, i);
+    }
+    int reps = 1000000;
+
+    double start = now_ns();
+    for(int i = 0; i < reps; i++){
+        sink = dlist_back(list);
+    }
+    double back_ns = (now_ns() - start) / reps;
+
+    start = now_ns();
+    for(int i = 0; i < reps; i++){
+        dlist_push_back(list, i);
+        sink = dlist_pop_back(list);
+    }
+    double push_pop_ns = (now_ns() - start) / reps;
+
+    start = now_ns();
+    for(int i = 0; i < reps; i++){
+        sink = dlist_value_n_from_end(list, 0);
+    }
+    double nth_ns = (now_ns() - start) / reps;
+
+    printf("%-8s %10d %14.1f %18.1f %20.1f\n", "doubly", n, back_ns, push_pop_ns, nth_ns);
+
+    dlist_destroy(list);
+}
+
+// builds a singly list whose nodes are linked in random address order
+static LinkedList* build_scattered(int n){
+    LinkedList *list = create_list();
+    Node **nodes = malloc(sizeof(Node *) * n);
+    for(int i = 0; i < n; i++){
+        nodes[i] = allocator_allocate(list->allocator, sizeof(Node));
+        nodes[i]->data = i;
+        nodes[i]->pooled = false;
+    }
+    srand(42);
+    for(int i = n - 1; i > 0; i--){
+        int j = ((long)rand() * RAND_MAX + rand()) % (i + 1);
+        Node *temp = nodes[i];
+        nodes[i] = nodes[j];
+        nodes[j] = temp;
+    }
+    for(int i = 0; i < n; i++){
+        nodes[i]->next = list->head;
+        list->head = nodes[i];
+    }
+    list->tail = nodes[0];
+    list->size = n;
+    free(nodes);
+    return list;
+}
+
+static void bench_singly_walks(const char *name, LinkedList *list, int reps){
+    int n = size(list);
+
+    double start = now_ns();
+    for(int i = 0; i < reps; i++){
+        sink = value_at(list, n - 1);
+    }
+    double at_ms = (now_ns() - start) / reps / 1e6;
+
+    start = now_ns();
+    for(int i = 0; i < reps; i++){
+        remove_value(list, -1);
+    }
+    double remove_ms = (now_ns() - start) / reps / 1e6;
+
+    start = now_ns();
+    for(int i = 0; i < reps; i++){
+        reverse(list);
+    }
+    double reverse_ms = (now_ns() - start) / reps / 1e6;
+
+    printf("%-10s %10d %14.3f %18.3f %14.3f\n", name, n, at_ms, remove_ms, reverse_ms);
+
+    destroy_list(list);
+}
+
+static void bench_unrolled_walks(int n, int reps){
+    UnrolledList *list = ulist_create();
+    for(int i = 0; i < n; i++){
+        ulist_push_back(list, i);
+    }
+
+    double start = now_ns();
+    for(int i = 0; i < reps; i++){
+        sink = ulist_value_at(list, n - 1);
+    }
+    double at_ms = (now_ns() - start) / reps / 1e6;
+
+    start = now_ns();
+    for(int i = 0; i < reps; i++){
+        ulist_remove_value(list, -1);
+    }
+    double remove_ms = (now_ns() - start) / reps / 1e6;
+
+    start = now_ns();
+    for(int i = 0; i < reps; i++){
+        ulist_reverse(list);
+    }
+    double reverse_ms = (now_ns() - start) / reps / 1e6;
+
+    printf("%-10s %10d %14.3f %18.3f %14.3f\n", "unrolled", n, at_ms, remove_ms, reverse_ms);
+
+    ulist_destroy(list);
+}
+
+static void bench_positional(int n){
+    LinkedList *list = create_list();
+    SkipList *skip = skiplist_create();
+    for(int i = 0; i < n; i++){
+        push_front(list, i);
+        skiplist_push_front(skip, i);
+    }
+    int slow_reps = n <= 1000 ? 100000 : (n <= 1000000 ? 200 : 20);
+    int fast_reps = 1000000;
+
+    srand(7);
+    double start = now_ns();
+    for(int i = 0; i < slow_reps; i++){
+        sink = value_at(list, rand() % n);
+    }
+    double at_ns = (now_ns() - start) / slow_reps;
+    start = now_ns();
+    for(int i = 0; i < slow_reps; i++){
+        int index = rand() % n;
+        insert(list, index, i);
+        erase(list, index);
+    }
+    double edit_ns = (now_ns() - start) / slow_reps;
+    printf("%-8s %10d %16.1f %20.1f\n", "singly", n, at_ns, edit_ns);
+
+    start = now_ns();
+    for(int i = 0; i < fast_reps; i++){
+        sink = skiplist_value_at(skip, rand() % n);
+    }
+    at_ns = (now_ns() - start) / fast_reps;
+    start = now_ns();
+    for(int i = 0; i < fast_reps; i++){
+        int index = rand() % n;
+        skiplist_insert(skip, index, i);
+        skiplist_erase(skip, index);
+    }
+    edit_ns = (now_ns() - start) / fast_reps;
+    printf("%-8s %10d %16.1f %20.1f\n", "skip", n, at_ns, edit_ns);
+
+    destroy_list(list);
+    skiplist_destroy(skip);
+}
+
+static void bench_bulk(int n){
+    int *values = malloc(sizeof(int) * n);
+    srand(11);
+    for(int i = 0; i < n; i++){
+        values[i] = rand();
+    }
+
+    double start = now_ns();
+    LinkedList *list = create_list();
+    for(int i = 0; i < n; i++){
+        push_back(list, values[i]);
+    }
+    double push_ms = (now_ns() - start) / 1e6;
+    destroy_list(list);
+
+    start = now_ns();
+    list = list_from_array(values, n);
+    double from_array_ms = (now_ns() - start) / 1e6;
+
+    start = now_ns();
+    list_sort(list);
+    double sort_ms = (now_ns() - start) / 1e6;
+
+    printf("%10d %18.2f %20.2f %14.2f\n", n, push_ms, from_array_ms, sort_ms);
+    destroy_list(list);
+    free(values);
+}
+
+int main(int argc, char *argv[]){
+    int sizes[] = {1000, 1000000, 10000000};
+    int max_size = argc > 1 ? atoi(argv[1]) : sizes[2];
+
+    printf("%-8s %10s %14s %18s %20s\n", "list", "size", "back ns/op", "push+pop ns/op", "n_from_end ns/op");
+    for(int i = 0; i < 3 && sizes[i] <= max_size; i++){
+        bench_singly(sizes[i]);
+        bench_doubly(sizes[i]);
+    }
+
+    printf("\n%-10s %10s %14s %18s %14s\n", "list", "size", "value_at ms", "remove_value ms", "reverse ms");
+    for(int i = 0; i < 3 && sizes[i] <= max_size; i++){
+        int n = sizes[i];
+        int reps = n <= 1000 ? 10000 : (n <= 1000000 ? 20 : 4);
+        LinkedList *list = create_list();
+        for(int j = 0; j < n; j++){
+            push_front(list, j);
+        }
+        bench_singly_walks("singly", list, reps);
+        bench_singly_walks("scattered", build_scattered(n), reps);
+        bench_unrolled_walks(n, reps);
+    }
+
+    printf("\n%-8s %10s %16s %20s\n", "list", "size", "value_at ns/op", "insert+erase ns/op");
+    for(int i = 0; i < 3 && sizes[i] <= max_size; i++){
+        bench_positional(sizes[i]);
+    }
+
+    printf("\n%10s %18s %20s %14s\n", "size", "push_back loop ms", "list_from_array ms", "list_sort ms");
+    for(int i = 0; i < 3 && sizes[i] <= max_size; i++){
+        bench_bulk(sizes[i]);
+    }
+    return 0;
+}
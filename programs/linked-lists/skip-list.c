@@ -0,0 +1,567 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "../allocator/allocator.h"
+
+/* Indexable skip list. Every forward link stores its span (how many
+positions it jumps over), so value_at/insert/erase by position take
+expected O(log n) instead of the O(n) walk in linked-list-a1.c. push_front
+skips the search entirely: it links an expected 1.33 levels and bumps the
+span of the remaining head links.
+
+One writer may mutate the list while any number of readers call
+skiplist_read_value_at at the same time. Readers never take a lock: the
+writer bumps a sequence counter around every change (readers retry if it
+moved) and, once skiplist_enable_concurrent_reads has been called, erased
+nodes are kept on a retire list until no reader that could still see them
+is active (epoch based reclamation).
+
+    gcc -O2 -pthread skip-list.c -o skiplist */
+
+#define SKIPLIST_MAX_LEVEL 32
+#define SKIPLIST_MAX_READERS 16
+#define SKIPLIST_CACHE_LINE 64
+
+typedef struct SkipNode SkipNode;
+
+typedef struct SkipLink{
+    SkipNode *next;
+    int span;
+}SkipLink;
+
+struct SkipNode{
+    int data;
+    int level;
+    SkipLink links[];
+};
+
+typedef struct RetiredNode{
+    SkipNode *node;
+    uint64_t epoch;
+}RetiredNode;
+
+// one slot per reader, on its own cache line so readers don't share
+typedef struct ReaderSlot{
+    _Alignas(SKIPLIST_CACHE_LINE) uint64_t epoch; // 0 when the reader is not inside a read
+    char pad[SKIPLIST_CACHE_LINE - sizeof(uint64_t)];
+}ReaderSlot;
+
+typedef struct SkipList{
+    SkipNode *head;
+    int level;
+    int size;
+    uint64_t random_state;
+
+    bool concurrent;
+    uint64_t sequence; // odd while the writer is mutating
+    uint64_t epoch;
+    RetiredNode *retired;
+    int retired_count;
+    int retired_capacity;
+    ReaderSlot readers[SKIPLIST_MAX_READERS];
+    Allocator *allocator;
+    void *storage; // the allocation the list was aligned inside
+}SkipList;
+
+
+
+
+SkipList* skiplist_create();
+SkipList* skiplist_create_with_allocator(Allocator *allocator);
+void skiplist_destroy(SkipList *list);
+int skiplist_size(SkipList *list);
+bool skiplist_empty(SkipList *list);
+int skiplist_value_at(SkipList *list, int index);
+int skiplist_front(SkipList *list);
+ContainerStatus skiplist_push_front(SkipList *list, int value);
+int skiplist_pop_front(SkipList *list);
+ContainerStatus skiplist_insert(SkipList *list, int index, int value);
+ContainerStatus skiplist_erase(SkipList *list, int index);
+void skiplist_enable_concurrent_reads(SkipList *list);
+bool skiplist_read_value_at(SkipList *list, int reader_id, int index, int *value);
+
+
+
+static size_t skiplist_node_size(int level){
+    return sizeof(SkipNode) + sizeof(SkipLink) * level;
+}
+
+static SkipNode* skiplist_new_node(SkipList *list, int level, int value){
+    SkipNode *node = allocator_allocate(list->allocator, skiplist_node_size(level));
+    if(node == NULL){
+        return NULL;
+    }
+    node->data = value;
+    node->level = level;
+    return node;
+}
+
+static void skiplist_release_node(SkipList *list, SkipNode *node){
+    allocator_release(list->allocator, node, skiplist_node_size(node->level));
+}
+
+// returns NULL if out of memory
+SkipList* skiplist_create(){
+    return skiplist_create_with_allocator(default_allocator());
+}
+
+SkipList* skiplist_create_with_allocator(Allocator *allocator){
+    // the reader slots need cache line alignment, which Allocator does not
+    // promise, so take a line extra and align inside it
+    void *storage = allocator_allocate(allocator, sizeof(SkipList) + SKIPLIST_CACHE_LINE - 1);
+    if(storage == NULL){
+        return NULL;
+    }
+    uintptr_t aligned = ((uintptr_t)storage + SKIPLIST_CACHE_LINE - 1) & ~(uintptr_t)(SKIPLIST_CACHE_LINE - 1);
+    SkipList *list = (SkipList *)aligned;
+    list->allocator = allocator;
+    list->storage = storage;
+    list->head = skiplist_new_node(list, SKIPLIST_MAX_LEVEL, 0);
+    if(list->head == NULL){
+        allocator_release(allocator, storage, sizeof(SkipList) + SKIPLIST_CACHE_LINE - 1);
+        return NULL;
+    }
+    for(int i = 0; i < SKIPLIST_MAX_LEVEL; i++){
+        list->head->links[i].next = NULL;
+        list->head->links[i].span = 1;
+    }
+    list->level = 1;
+    list->size = 0;
+    list->random_state = 0x9E3779B97F4A7C15ULL;
+    list->concurrent = false;
+    list->sequence = 0;
+    list->epoch = 1;
+    list->retired = NULL;
+    list->retired_count = 0;
+    list->retired_capacity = 0;
+    for(int i = 0; i < SKIPLIST_MAX_READERS; i++){
+        list->readers[i].epoch = 0;
+    }
+    return list;
+}
+
+void skiplist_destroy(SkipList *list){
+    SkipNode *current = list->head;
+    while(current != NULL){
+        SkipNode *next = current->links[0].next;
+        skiplist_release_node(list, current);
+        current = next;
+    }
+    for(int i = 0; i < list->retired_count; i++){
+        skiplist_release_node(list, list->retired[i].node);
+    }
+    allocator_release(list->allocator, list->retired, sizeof(RetiredNode) * list->retired_capacity);
+    allocator_release(list->allocator, list->storage, sizeof(SkipList) + SKIPLIST_CACHE_LINE - 1);
+}
+
+int skiplist_size(SkipList *list){
+    return list->size;
+}
+
+bool skiplist_empty(SkipList *list){
+    return list->size==0;
+}
+
+// level k is picked with probability (1/4)^(k-1)
+static int skiplist_random_level(SkipList *list){
+    uint64_t x = list->random_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    list->random_state = x;
+
+    int level = 1 + __builtin_ctzll(x | (1ULL << 62)) / 2;
+    return level < SKIPLIST_MAX_LEVEL ? level : SKIPLIST_MAX_LEVEL;
+}
+
+//=========== writer side ===================================
+
+static void skiplist_write_begin(SkipList *list){
+    __atomic_store_n(&list->sequence, list->sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void skiplist_write_end(SkipList *list){
+    __atomic_store_n(&list->sequence, list->sequence + 1, __ATOMIC_RELEASE);
+}
+
+// frees retired nodes that no active reader can still be looking at
+static void skiplist_reclaim(SkipList *list){
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    uint64_t oldest = UINT64_MAX;
+    for(int i = 0; i < SKIPLIST_MAX_READERS; i++){
+        uint64_t epoch = __atomic_load_n(&list->readers[i].epoch, __ATOMIC_SEQ_CST);
+        if(epoch != 0 && epoch < oldest){
+            oldest = epoch;
+        }
+    }
+
+    int kept = 0;
+    for(int i = 0; i < list->retired_count; i++){
+        if(list->retired[i].epoch < oldest){
+            skiplist_release_node(list, list->retired[i].node);
+        }else{
+            list->retired[kept++] = list->retired[i];
+        }
+    }
+    list->retired_count = kept;
+}
+
+// makes room on the retire list for one more node, before erase unlinks
+// anything, so running out of memory leaves the list as it was
+static ContainerStatus skiplist_reserve_retired(SkipList *list){
+    if(!list->concurrent || list->retired_count < list->retired_capacity){
+        return CONTAINER_OK;
+    }
+    skiplist_reclaim(list);
+    if(list->retired_count < list->retired_capacity){
+        return CONTAINER_OK;
+    }
+    int new_capacity = list->retired_capacity ? list->retired_capacity * 2 : 64;
+    RetiredNode *new_retired = allocator_reallocate(list->allocator, list->retired,
+                                                    sizeof(RetiredNode) * list->retired_capacity,
+                                                    sizeof(RetiredNode) * new_capacity);
+    if(new_retired == NULL){
+        return CONTAINER_NO_MEMORY;
+    }
+    list->retired = new_retired;
+    list->retired_capacity = new_capacity;
+    return CONTAINER_OK;
+}
+
+// the retire list has room, skiplist_reserve_retired made sure of it
+static void skiplist_free_node(SkipList *list, SkipNode *node){
+    if(!list->concurrent){
+        skiplist_release_node(list, node);
+        return;
+    }
+
+    list->retired[list->retired_count].node = node;
+    list->retired[list->retired_count].epoch = list->epoch;
+    list->retired_count++;
+    __atomic_store_n(&list->epoch, list->epoch + 1, __ATOMIC_SEQ_CST);
+}
+
+// links node in after update[i] on each of its levels, rank[i] is the
+// position of update[i] and prev_rank the position of the new node's
+// predecessor
+static void skiplist_link(SkipList *list, SkipNode *node, SkipNode **update, int *rank, int prev_rank){
+    if(node->level > list->level){
+        for(int i = list->level; i < node->level; i++){
+            rank[i] = 0;
+            update[i] = list->head;
+            __atomic_store_n(&update[i]->links[i].span, list->size + 1, __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&list->level, node->level, __ATOMIC_RELEASE);
+    }
+
+    for(int i = 0; i < node->level; i++){
+        SkipLink *link = &update[i]->links[i];
+        node->links[i].next = link->next;
+        node->links[i].span = link->span - (prev_rank - rank[i]);
+        __atomic_store_n(&link->span, prev_rank - rank[i] + 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&link->next, node, __ATOMIC_RELEASE);
+    }
+    for(int i = node->level; i < list->level; i++){
+        __atomic_store_n(&update[i]->links[i].span, update[i]->links[i].span + 1, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&list->size, list->size + 1, __ATOMIC_RELAXED);
+}
+
+// fills update/rank with the last node before position target_rank on each level
+static void skiplist_find_predecessors(SkipList *list, int target_rank, SkipNode **update, int *rank){
+    SkipNode *current = list->head;
+    int traversed = 0;
+    for(int i = list->level - 1; i >= 0; i--){
+        while(current->links[i].next != NULL && traversed + current->links[i].span < target_rank){
+            traversed += current->links[i].span;
+            current = current->links[i].next;
+        }
+        update[i] = current;
+        rank[i] = traversed;
+    }
+}
+
+int skiplist_value_at(SkipList *list, int index){
+    if(index < 0 || index >= list->size){
+        return -1;
+    }
+
+    int target_rank = index + 1;
+    SkipNode *current = list->head;
+    int traversed = 0;
+    for(int i = list->level - 1; i >= 0; i--){
+        while(current->links[i].next != NULL && traversed + current->links[i].span <= target_rank){
+            traversed += current->links[i].span;
+            current = current->links[i].next;
+        }
+        if(traversed == target_rank){
+            break;
+        }
+    }
+    return current->data;
+}
+
+int skiplist_front(SkipList *list){
+    if(skiplist_empty(list)){
+        return -1;
+    }
+    return list->head->links[0].next->data;
+}
+
+// push_front and insert return CONTAINER_NO_MEMORY and leave the list
+// unchanged when the node cannot be allocated
+ContainerStatus skiplist_push_front(SkipList *list, int value){
+    SkipNode *node = skiplist_new_node(list, skiplist_random_level(list), value);
+    if(node == NULL){
+        return CONTAINER_NO_MEMORY;
+    }
+
+    SkipNode *update[SKIPLIST_MAX_LEVEL];
+    int rank[SKIPLIST_MAX_LEVEL];
+    int levels = node->level > list->level ? node->level : list->level;
+    for(int i = 0; i < levels; i++){
+        update[i] = list->head;
+        rank[i] = 0;
+    }
+
+    skiplist_write_begin(list);
+    skiplist_link(list, node, update, rank, 0);
+    skiplist_write_end(list);
+    return CONTAINER_OK;
+}
+
+// an index out of range is ignored
+ContainerStatus skiplist_insert(SkipList *list, int index, int value){
+    if(index < 0 || index > list->size){
+        return CONTAINER_OK;
+    }
+
+    if(index == 0){
+        return skiplist_push_front(list, value);
+    }
+
+    SkipNode *node = skiplist_new_node(list, skiplist_random_level(list), value);
+    if(node == NULL){
+        return CONTAINER_NO_MEMORY;
+    }
+
+    SkipNode *update[SKIPLIST_MAX_LEVEL];
+    int rank[SKIPLIST_MAX_LEVEL];
+    skiplist_find_predecessors(list, index + 1, update, rank);
+
+    skiplist_write_begin(list);
+    skiplist_link(list, node, update, rank, rank[0]);
+    skiplist_write_end(list);
+    return CONTAINER_OK;
+}
+
+// With concurrent reads on, the erased node goes on the retire list; if
+// that list cannot grow, erase returns CONTAINER_NO_MEMORY and removes
+// nothing. An index out of range is ignored.
+ContainerStatus skiplist_erase(SkipList *list, int index){
+    if(index < 0 || index >= list->size){
+        return CONTAINER_OK;
+    }
+    if(skiplist_reserve_retired(list) != CONTAINER_OK){
+        return CONTAINER_NO_MEMORY;
+    }
+
+    SkipNode *update[SKIPLIST_MAX_LEVEL];
+    int rank[SKIPLIST_MAX_LEVEL];
+    skiplist_find_predecessors(list, index + 1, update, rank);
+    SkipNode *node = update[0]->links[0].next;
+
+    skiplist_write_begin(list);
+    for(int i = 0; i < list->level; i++){
+        SkipLink *link = &update[i]->links[i];
+        if(link->next == node){
+            __atomic_store_n(&link->span, link->span + node->links[i].span - 1, __ATOMIC_RELAXED);
+            __atomic_store_n(&link->next, node->links[i].next, __ATOMIC_RELEASE);
+        }else{
+            __atomic_store_n(&link->span, link->span - 1, __ATOMIC_RELAXED);
+        }
+    }
+    while(list->level > 1 && list->head->links[list->level - 1].next == NULL){
+        __atomic_store_n(&list->level, list->level - 1, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&list->size, list->size - 1, __ATOMIC_RELAXED);
+    skiplist_write_end(list);
+
+    skiplist_free_node(list, node);
+    return CONTAINER_OK;
+}
+
+// returns -1, removing nothing, if the list is empty or erase runs out of memory
+int skiplist_pop_front(SkipList *list){
+    if(skiplist_empty(list)){
+        return -1;
+    }
+    int removed_value = skiplist_front(list);
+    if(skiplist_erase(list, 0) != CONTAINER_OK){
+        return -1;
+    }
+    return removed_value;
+}
+
+// must be called before any reader thread starts
+void skiplist_enable_concurrent_reads(SkipList *list){
+    list->concurrent = true;
+}
+
+//=========== reader side ===================================
+
+// Looks up index without locking while the writer may be mutating. Returns
+// false if index is out of range. reader_id must be unique per thread and
+// below SKIPLIST_MAX_READERS.
+bool skiplist_read_value_at(SkipList *list, int reader_id, int index, int *value){
+    ReaderSlot *slot = &list->readers[reader_id];
+    __atomic_store_n(&slot->epoch, __atomic_load_n(&list->epoch, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    bool found;
+    for(;;){
+        uint64_t sequence = __atomic_load_n(&list->sequence, __ATOMIC_ACQUIRE);
+        if(sequence & 1){
+            continue; // writer in progress
+        }
+
+        int size = __atomic_load_n(&list->size, __ATOMIC_RELAXED);
+        int target_rank = index + 1;
+        int traversed = 0;
+        int result = -1;
+        found = false;
+        if(index >= 0 && index < size){
+            SkipNode *current = list->head;
+            for(int i = __atomic_load_n(&list->level, __ATOMIC_ACQUIRE) - 1; i >= 0; i--){
+                for(;;){
+                    SkipNode *next = __atomic_load_n(&current->links[i].next, __ATOMIC_ACQUIRE);
+                    int span = __atomic_load_n(&current->links[i].span, __ATOMIC_RELAXED);
+                    if(next == NULL || traversed + span > target_rank){
+                        break;
+                    }
+                    traversed += span;
+                    current = next;
+                }
+                if(traversed == target_rank){
+                    break;
+                }
+            }
+            found = traversed == target_rank;
+            result = __atomic_load_n(&current->data, __ATOMIC_RELAXED);
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&list->sequence, __ATOMIC_RELAXED) == sequence){
+            if(found){
+                *value = result;
+            }else if(index >= 0 && index < size){
+                continue; // torn read, spans did not add up
+            }
+            break;
+        }
+    }
+
+    __atomic_store_n(&slot->epoch, 0, __ATOMIC_RELEASE);
+    return found;
+}
+
+
+
+#ifndef LINKED_LIST_BENCH
+#include <assert.h>
+#include <pthread.h>
+
+typedef struct ReaderArgs{
+    SkipList *list;
+    int reader_id;
+    int reads;
+    int mismatches;
+}ReaderArgs;
+
+// the writer erases position k and puts k back, so a validated read of
+// index i sees either i or (between the two calls, for i >= k) i + 1
+static void* reader_thread(void *arg){
+    ReaderArgs *args = arg;
+    uint64_t x = 88172645463325252ULL + args->reader_id;
+    for(int i = 0; i < args->reads; i++){
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        int index = x % 1000;
+        int value;
+        if(skiplist_read_value_at(args->list, args->reader_id, index, &value) && value != index && value != index + 1){
+            args->mismatches++;
+        }
+    }
+    return NULL;
+}
+
+static void test_concurrent_reads(){
+    SkipList *list = skiplist_create();
+    skiplist_enable_concurrent_reads(list);
+    for(int i = 999; i >= 0; i--){
+        skiplist_push_front(list, i);
+    }
+
+    enum { kReaders = 3 };
+    pthread_t threads[kReaders];
+    ReaderArgs args[kReaders];
+    for(int i = 0; i < kReaders; i++){
+        args[i] = (ReaderArgs){list, i, 200000, 0};
+        pthread_create(&threads[i], NULL, reader_thread, &args[i]);
+    }
+
+    // erase and re-insert the same position over and over
+    for(int i = 0; i < 200000; i++){
+        int index = (i * 7919) % 1000;
+        skiplist_erase(list, index);
+        skiplist_insert(list, index, index);
+    }
+
+    int mismatches = 0;
+    for(int i = 0; i < kReaders; i++){
+        pthread_join(threads[i], NULL);
+        mismatches += args[i].mismatches;
+    }
+    printf("Concurrent reads with one writer, mismatches: %d\n", mismatches); // Expecting 0
+    assert(mismatches == 0);
+    skiplist_destroy(list);
+}
+
+int main() {
+    SkipList* list = skiplist_create();
+
+    printf("Testing push_front and insert:\n");
+    skiplist_push_front(list, 10);
+    skiplist_push_front(list, 5);
+    skiplist_insert(list, 2, 25);
+    skiplist_insert(list, 2, 20);
+    printf("Size: %d\n", skiplist_size(list)); // Expecting 4
+    printf("Front: %d\n", skiplist_front(list)); // Expecting 5
+    printf("Value at index 2: %d\n", skiplist_value_at(list, 2)); // Expecting 20
+    printf("Value at index 3: %d\n", skiplist_value_at(list, 3)); // Expecting 25
+
+    printf("\nTesting erase and pop_front:\n");
+    skiplist_erase(list, 1);
+    printf("Value at index 1 (after erase): %d\n", skiplist_value_at(list, 1)); // Expecting 20
+    printf("Pop front: %d\n", skiplist_pop_front(list)); // Expecting 5
+    printf("Size: %d\n", skiplist_size(list)); // Expecting 2
+
+    printf("\nTesting positional access on 100000 items:\n");
+    for(int i = 0; i < 100000; i++){
+        skiplist_insert(list, skiplist_size(list), i);
+    }
+    printf("Value at index 50002: %d\n", skiplist_value_at(list, 50002)); // Expecting 50000
+    skiplist_erase(list, 50002);
+    printf("Value at index 50002 (after erase): %d\n", skiplist_value_at(list, 50002)); // Expecting 50001
+    skiplist_destroy(list);
+
+    printf("\n");
+    test_concurrent_reads();
+
+    printf("\nAll tests completed.\n");
+    return 0;
+}
+#endif
@@ -0,0 +1,376 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "../allocator/allocator.h"
+
+/* Unrolled linked list. Each node holds a small array of ints sized to
+ULIST_NODE_BYTES (two cache lines by default), so walking the list touches
+one pointer per ULIST_NODE_CAPACITY values instead of one per value. Nodes
+split in half when an insert hits a full node, and an erase that leaves a
+node less than half full borrows from or merges with the next node.
+
+The Allocator interface has no alignment argument, so ulist_create uses
+one built on aligned_alloc to keep each node on its own two lines. Nodes
+from another allocator get whatever alignment it gives. */
+
+#define ULIST_CACHE_LINE 64
+#define ULIST_NODE_BYTES (2 * ULIST_CACHE_LINE)
+#define ULIST_NODE_CAPACITY ((ULIST_NODE_BYTES - sizeof(void *) - sizeof(int)) / sizeof(int))
+
+typedef struct UNode{
+    struct UNode *next;
+    int count;
+    int data[ULIST_NODE_CAPACITY];
+}UNode;
+
+typedef struct UnrolledList{
+    UNode *head;
+    UNode *tail;
+    int size;
+    Allocator *allocator;
+}UnrolledList;
+
+
+
+
+UnrolledList* ulist_create();
+UnrolledList* ulist_create_with_allocator(Allocator *allocator);
+void ulist_destroy(UnrolledList *list);
+int ulist_size(UnrolledList *list);
+bool ulist_empty(UnrolledList *list);
+int ulist_value_at(UnrolledList *list, int index);
+ContainerStatus ulist_push_front(UnrolledList *list, int value);
+ContainerStatus ulist_push_back(UnrolledList *list, int value);
+int ulist_pop_front(UnrolledList *list);
+ContainerStatus ulist_insert(UnrolledList *list, int index, int value);
+void ulist_erase(UnrolledList *list, int index);
+void ulist_reverse(UnrolledList *list);
+void ulist_remove_value(UnrolledList *list, int value);
+
+
+
+// aligned_alloc wants a multiple of the alignment
+static size_t ulist_round_to_line(size_t size){
+    return (size + ULIST_CACHE_LINE - 1) / ULIST_CACHE_LINE * ULIST_CACHE_LINE;
+}
+
+static void* ulist_aligned_allocate(void *state, size_t size){
+    (void)state;
+    return aligned_alloc(ULIST_CACHE_LINE, ulist_round_to_line(size));
+}
+
+static void* ulist_aligned_reallocate(void *state, void *ptr, size_t old_size, size_t new_size){
+    void *moved = ulist_aligned_allocate(state, new_size);
+    if(moved != NULL && ptr != NULL){
+        memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+        free(ptr);
+    }
+    return moved;
+}
+
+static Allocator* ulist_aligned_allocator(void){
+    static Allocator allocator = {ulist_aligned_allocate, ulist_aligned_reallocate, malloc_release, NULL};
+    return &allocator;
+}
+
+static UNode* ulist_new_node(UnrolledList *list){
+    UNode *node = allocator_allocate(list->allocator, sizeof(UNode));
+    if(node == NULL){
+        return NULL;
+    }
+    node->next = NULL;
+    node->count = 0;
+    return node;
+}
+
+// returns NULL if out of memory
+UnrolledList* ulist_create(){
+    return ulist_create_with_allocator(ulist_aligned_allocator());
+}
+
+UnrolledList* ulist_create_with_allocator(Allocator *allocator){
+    UnrolledList *list = allocator_allocate(allocator, sizeof(UnrolledList));
+    if(list == NULL){
+        return NULL;
+    }
+    list->allocator = allocator;
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+    return list;
+}
+
+void ulist_destroy(UnrolledList *list){
+    UNode *current = list->head;
+    while(current != NULL){
+        UNode *next = current->next;
+        allocator_release(list->allocator, current, sizeof(UNode));
+        current = next;
+    }
+    allocator_release(list->allocator, list, sizeof(UnrolledList));
+}
+
+int ulist_size(UnrolledList *list){
+    return list->size;
+}
+
+bool ulist_empty(UnrolledList *list){
+    return list->size==0;
+}
+
+// finds the node holding index and stores the offset inside it in *offset
+// (and the node before it in *prev, when prev is not NULL)
+static UNode* ulist_find(UnrolledList *list, int index, int *offset, UNode **prev){
+    UNode *before = NULL;
+    UNode *current = list->head;
+    while(index >= current->count){
+        index -= current->count;
+        before = current;
+        current = current->next;
+    }
+    *offset = index;
+    if(prev != NULL){
+        *prev = before;
+    }
+    return current;
+}
+
+// moves the upper half of a full node into a new node after it
+static UNode* ulist_split(UnrolledList *list, UNode *node){
+    UNode *new_node = ulist_new_node(list);
+    if(new_node == NULL){
+        return NULL;
+    }
+    int keep = node->count / 2;
+    new_node->count = node->count - keep;
+    memcpy(new_node->data, node->data + keep, new_node->count * sizeof(int));
+    node->count = keep;
+
+    new_node->next = node->next;
+    node->next = new_node;
+    if(list->tail == node){
+        list->tail = new_node;
+    }
+    return new_node;
+}
+
+// frees an empty node, prev is the node before it (NULL for the head)
+static void ulist_unlink_node(UnrolledList *list, UNode *prev, UNode *node){
+    if(prev == NULL){
+        list->head = node->next;
+    }else{
+        prev->next = node->next;
+    }
+    if(list->tail == node){
+        list->tail = prev;
+    }
+    allocator_release(list->allocator, node, sizeof(UNode));
+}
+
+int ulist_value_at(UnrolledList *list, int index){
+    if(index < 0 || index >= list->size){
+        return -1;
+    }
+    int offset;
+    UNode *node = ulist_find(list, index, &offset, NULL);
+    return node->data[offset];
+}
+
+// the push and insert functions return CONTAINER_NO_MEMORY and leave the
+// list unchanged when they need a node and cannot get one
+ContainerStatus ulist_push_front(UnrolledList *list, int value){
+    UNode *node = list->head;
+    if(node == NULL || node->count == (int)ULIST_NODE_CAPACITY){
+        node = ulist_new_node(list);
+        if(node == NULL){
+            return CONTAINER_NO_MEMORY;
+        }
+        node->next = list->head;
+        list->head = node;
+        if(list->tail == NULL){
+            list->tail = node;
+        }
+    }
+    memmove(node->data + 1, node->data, node->count * sizeof(int));
+    node->data[0] = value;
+    node->count++;
+    list->size++;
+    return CONTAINER_OK;
+}
+
+ContainerStatus ulist_push_back(UnrolledList *list, int value){
+    UNode *node = list->tail;
+    if(node == NULL || node->count == (int)ULIST_NODE_CAPACITY){
+        node = ulist_new_node(list);
+        if(node == NULL){
+            return CONTAINER_NO_MEMORY;
+        }
+        if(list->tail != NULL){
+            list->tail->next = node;
+        }else{
+            list->head = node;
+        }
+        list->tail = node;
+    }
+    node->data[node->count++] = value;
+    list->size++;
+    return CONTAINER_OK;
+}
+
+int ulist_pop_front(UnrolledList *list){
+    if(ulist_empty(list)){
+        return -1;
+    }
+    int removed_value = ulist_value_at(list, 0);
+    ulist_erase(list, 0);
+    return removed_value;
+}
+
+// an index out of range is ignored
+ContainerStatus ulist_insert(UnrolledList *list, int index, int value){
+    if(index < 0 || index > list->size){
+        return CONTAINER_OK;
+    }
+
+    if(index == 0){
+        return ulist_push_front(list, value);
+    }else if(index == list->size){
+        return ulist_push_back(list, value);
+    }
+
+    int offset;
+    UNode *node = ulist_find(list, index, &offset, NULL);
+    if(node->count == (int)ULIST_NODE_CAPACITY){
+        UNode *new_node = ulist_split(list, node);
+        if(new_node == NULL){
+            return CONTAINER_NO_MEMORY;
+        }
+        if(offset > node->count){
+            offset -= node->count;
+            node = new_node;
+        }
+    }
+    memmove(node->data + offset + 1, node->data + offset, (node->count - offset) * sizeof(int));
+    node->data[offset] = value;
+    node->count++;
+    list->size++;
+    return CONTAINER_OK;
+}
+
+void ulist_erase(UnrolledList *list, int index){
+    if(index < 0 || index >= list->size){
+        return;
+    }
+
+    int offset;
+    UNode *prev;
+    UNode *node = ulist_find(list, index, &offset, &prev);
+    memmove(node->data + offset, node->data + offset + 1, (node->count - offset - 1) * sizeof(int));
+    node->count--;
+    list->size--;
+
+    if(node->count == 0){
+        ulist_unlink_node(list, prev, node);
+        return;
+    }
+
+    const int half = ULIST_NODE_CAPACITY / 2;
+    UNode *next = node->next;
+    if(node->count >= half || next == NULL){
+        return;
+    }
+    if(next->count > half){
+        // borrow one value from the next node
+        node->data[node->count++] = next->data[0];
+        memmove(next->data, next->data + 1, (next->count - 1) * sizeof(int));
+        next->count--;
+    }else{
+        // both nodes are at most half full, merge next into node
+        memcpy(node->data + node->count, next->data, next->count * sizeof(int));
+        node->count += next->count;
+        next->count = 0;
+        ulist_unlink_node(list, node, next);
+    }
+}
+
+void ulist_reverse(UnrolledList *list){
+    UNode *prev = NULL;
+    UNode *current = list->head;
+    list->tail = current;
+    while(current != NULL){
+        for(int i = 0, j = current->count - 1; i < j; i++, j--){
+            int temp = current->data[i];
+            current->data[i] = current->data[j];
+            current->data[j] = temp;
+        }
+        UNode *next = current->next;
+        current->next = prev;
+        prev = current;
+        current = next;
+    }
+    list->head = prev;
+}
+
+void ulist_remove_value(UnrolledList *list, int value){
+    int index = 0;
+    for(UNode *node = list->head; node != NULL; node = node->next){
+        for(int i = 0; i < node->count; i++){
+            if(node->data[i] == value){
+                ulist_erase(list, index + i);
+                return;
+            }
+        }
+        index += node->count;
+    }
+}
+
+
+
+#ifndef LINKED_LIST_BENCH
+int main() {
+    UnrolledList* list = ulist_create();
+
+    printf("Node capacity: %d ints\n", (int)ULIST_NODE_CAPACITY);
+
+    printf("\nTesting push_front and push_back:\n");
+    ulist_push_front(list, 10);
+    ulist_push_back(list, 20);
+    ulist_push_front(list, 5);
+    ulist_push_back(list, 25);
+    printf("Size: %d\n", ulist_size(list)); // Expecting 4
+    printf("Value at index 2: %d\n", ulist_value_at(list, 2)); // Expecting 20
+
+    printf("\nTesting insert and erase across node splits:\n");
+    for(int i = 0; i < 100; i++){
+        ulist_insert(list, 2, i);
+    }
+    printf("Size: %d\n", ulist_size(list)); // Expecting 104
+    printf("Value at index 2: %d\n", ulist_value_at(list, 2)); // Expecting 99
+    printf("Value at index 101: %d\n", ulist_value_at(list, 101)); // Expecting 0
+    for(int i = 0; i < 100; i++){
+        ulist_erase(list, 2);
+    }
+    printf("Size: %d\n", ulist_size(list)); // Expecting 4
+    printf("Value at index 2: %d\n", ulist_value_at(list, 2)); // Expecting 20
+
+    printf("\nTesting reverse:\n");
+    ulist_reverse(list);
+    printf("Front after reverse: %d\n", ulist_value_at(list, 0)); // Expecting 25
+    printf("Back after reverse: %d\n", ulist_value_at(list, 3)); // Expecting 5
+
+    printf("\nTesting remove_value:\n");
+    ulist_remove_value(list, 20);
+    printf("Size after removing 20: %d\n", ulist_size(list)); // Expecting 3
+
+    printf("\nFinal state of the list:\n");
+    for (int i = 0; i < ulist_size(list); i++) {
+        printf("Value at index %d: %d\n", i, ulist_value_at(list, i));
+    }
+
+    ulist_destroy(list);
+
+    printf("\nAll tests completed.\n");
+    return 0;
+}
+#endif
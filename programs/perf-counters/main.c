@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "perf_counters.h"
+#include "../arrays/array.h"
+#include "../arrays/array.c"
+
+/* Example and smoke test: a JArray workload with a benchmark region
+around it. Run the instrumented build to get the JSON report.
+
+    gcc -O2 -DPERF_COUNTERS main.c perf_counters.c -pthread -o perf_example
+    PERF_COUNTERS_OUT=perf.jsonl ./perf_example
+
+Built without -DPERF_COUNTERS (and without perf_counters.c) it runs the
+same workload with no instrumentation. */
+
+#define PUSHES 1000000
+#define INSERTS 2000
+
+int main(){
+    PERF_REGION_BEGIN(example_workload);
+    JArray *array = jarray_new(1);
+    for (int i = 0; i < PUSHES; i++){
+        jarray_push(array, i);
+    }
+    for (int i = 0; i < INSERTS; i++){
+        jarray_insert(array, (i * 7919) % array->size, i);
+    }
+    assert(jarray_size(array) == PUSHES + INSERTS);
+    jarray_destroy(array);
+    PERF_REGION_END(example_workload);
+
+#ifdef PERF_COUNTERS
+    perf_report();
+#else
+    printf("Built without PERF_COUNTERS, nothing to report.\n");
+#endif
+    return 0;
+}
@@ -0,0 +1,180 @@
+#define _GNU_SOURCE
+#include "perf_counters.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+static const char *event_names[PERF_EVENT_COUNT] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+};
+
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} events[PERF_EVENT_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+// counters are per thread: perf_event_open(pid = 0, cpu = -1) counts the
+// calling thread on whatever CPU it runs
+typedef struct ThreadCounters{
+    bool opened;
+    int fds[PERF_EVENT_COUNT]; // -1 if that event could not be opened
+}ThreadCounters;
+
+static _Thread_local ThreadCounters thread_counters;
+
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static PerfRegion *regions = NULL;
+static PerfStat *stats = NULL;
+
+static int open_event(int index){
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = events[index].type;
+    attr.config = events[index].config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void open_thread_counters(ThreadCounters *counters){
+    for (int i = 0; i < PERF_EVENT_COUNT; i++){
+        counters->fds[i] = open_event(i);
+    }
+    counters->opened = true;
+}
+
+void perf_read(uint64_t values[PERF_EVENT_COUNT]){
+    ThreadCounters *counters = &thread_counters;
+    if (!counters->opened){
+        open_thread_counters(counters);
+    }
+    for (int i = 0; i < PERF_EVENT_COUNT; i++){
+        values[i] = 0;
+        if (counters->fds[i] >= 0 && read(counters->fds[i], &values[i], sizeof(uint64_t)) != sizeof(uint64_t)){
+            values[i] = 0;
+        }
+    }
+}
+
+void perf_region_add(PerfRegion *region, const uint64_t start[PERF_EVENT_COUNT]){
+    uint64_t end[PERF_EVENT_COUNT];
+    perf_read(end);
+    for (int i = 0; i < PERF_EVENT_COUNT; i++){
+        __atomic_fetch_add(&region->totals[i], end[i] - start[i], __ATOMIC_RELAXED);
+    }
+    __atomic_fetch_add(&region->calls, 1, __ATOMIC_RELAXED);
+}
+
+void perf_stat_add(PerfStat *stat, uint64_t value){
+    __atomic_fetch_add(&stat->count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stat->sum, value, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&stat->max, __ATOMIC_RELAXED);
+    while (value > max && !__atomic_compare_exchange_n(&stat->max, &max, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+    }
+}
+
+static bool reported = false;
+
+static void report_at_exit(){
+    if (!reported){
+        perf_report();
+    }
+}
+
+static void register_report(){
+    static bool registered = false;
+    if (!registered){
+        atexit(report_at_exit);
+        registered = true;
+    }
+}
+
+PerfRegion* perf_region_register(PerfRegion *region){
+    pthread_mutex_lock(&registry_lock);
+    register_report();
+    PerfRegion *existing = regions;
+    while (existing != NULL && strcmp(existing->name, region->name) != 0){
+        existing = existing->next;
+    }
+    if (existing == NULL){
+        region->next = regions;
+        regions = region;
+        existing = region;
+    }
+    pthread_mutex_unlock(&registry_lock);
+    return existing;
+}
+
+PerfStat* perf_stat_register(PerfStat *stat){
+    pthread_mutex_lock(&registry_lock);
+    register_report();
+    PerfStat *existing = stats;
+    while (existing != NULL && strcmp(existing->name, stat->name) != 0){
+        existing = existing->next;
+    }
+    if (existing == NULL){
+        stat->next = stats;
+        stats = stat;
+        existing = stat;
+    }
+    pthread_mutex_unlock(&registry_lock);
+    return existing;
+}
+
+// the hardware fields are null when the event could not be opened
+static bool event_available(int index){
+    ThreadCounters *counters = &thread_counters;
+    if (!counters->opened){
+        open_thread_counters(counters);
+    }
+    return counters->fds[index] >= 0;
+}
+
+void perf_report(void){
+    const char *path = getenv("PERF_COUNTERS_OUT");
+    FILE *out = path != NULL ? fopen(path, "a") : stderr;
+    if (out == NULL){
+        out = stderr;
+    }
+
+    pthread_mutex_lock(&registry_lock);
+    reported = true;
+    for (PerfRegion *region = regions; region != NULL; region = region->next){
+        uint64_t calls = __atomic_load_n(&region->calls, __ATOMIC_RELAXED);
+        fprintf(out, "{\"type\":\"region\",\"name\":\"%s\",\"calls\":%llu", region->name, (unsigned long long)calls);
+        for (int i = 0; i < PERF_EVENT_COUNT; i++){
+            if (event_available(i)){
+                fprintf(out, ",\"%s\":%llu", event_names[i],
+                        (unsigned long long)__atomic_load_n(&region->totals[i], __ATOMIC_RELAXED));
+            }else{
+                fprintf(out, ",\"%s\":null", event_names[i]);
+            }
+        }
+        fprintf(out, "}\n");
+    }
+    for (PerfStat *stat = stats; stat != NULL; stat = stat->next){
+        fprintf(out, "{\"type\":\"stat\",\"name\":\"%s\",\"count\":%llu,\"sum\":%llu,\"max\":%llu}\n", stat->name,
+                (unsigned long long)__atomic_load_n(&stat->count, __ATOMIC_RELAXED),
+                (unsigned long long)__atomic_load_n(&stat->sum, __ATOMIC_RELAXED),
+                (unsigned long long)__atomic_load_n(&stat->max, __ATOMIC_RELAXED));
+    }
+    pthread_mutex_unlock(&registry_lock);
+
+    if (out != stderr){
+        fclose(out);
+    }
+}
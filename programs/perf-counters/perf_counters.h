@@ -0,0 +1,105 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+/* Optional instrumentation for the containers and benchmarks.
+
+Build with -DPERF_COUNTERS and link perf_counters.c to turn it on:
+
+    gcc -O2 -DPERF_COUNTERS main.c ../perf-counters/perf_counters.c
+
+Without PERF_COUNTERS every macro below expands to nothing, so the
+instrumented code is the same as before.
+
+Two kinds of data are collected:
+
+- regions: PERF_REGION_BEGIN(name) / PERF_REGION_END(name) around any
+  block (one container operation or a whole benchmark loop) add the
+  cycles, instructions, L1D read misses, LLC misses and branch misses
+  of the calling thread, read with perf_event_open, to the totals for
+  name. Each begin/end is a read() syscall, so put regions around
+  operations only when that overhead is acceptable.
+- stats: PERF_COUNT(name, amount) and PERF_SAMPLE(name, value) keep a
+  count, sum and max per name. Use them for resizes, allocations, probe
+  lengths and chain lengths. They cost one atomic add each.
+
+At exit one JSON object per region and per stat is written, one per
+line, to the file named by $PERF_COUNTERS_OUT or to stderr. If the
+kernel refuses perf_event_open (no PMU, perf_event_paranoid too high)
+the hardware fields are null and stats still work. */
+
+#ifdef PERF_COUNTERS
+
+#include <stdint.h>
+
+#define PERF_EVENT_COUNT 5
+
+typedef struct PerfRegion{
+    const char *name;
+    uint64_t calls;
+    uint64_t totals[PERF_EVENT_COUNT];
+    struct PerfRegion *next;
+}PerfRegion;
+
+typedef struct PerfStat{
+    const char *name;
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    struct PerfStat *next;
+}PerfStat;
+
+//Prototypes
+// return the record to update: the first one registered under that name
+PerfRegion* perf_region_register(PerfRegion *region);
+PerfStat* perf_stat_register(PerfStat *stat);
+// fills values with the calling thread's current counter readings
+void perf_read(uint64_t values[PERF_EVENT_COUNT]);
+void perf_region_add(PerfRegion *region, const uint64_t start[PERF_EVENT_COUNT]);
+void perf_stat_add(PerfStat *stat, uint64_t value);
+// writes everything collected so far; runs at exit unless called before
+void perf_report(void);
+
+// Each use site keeps a static record and registers it on first use;
+// sites sharing a name all update the first record with that name.
+#define PERF_REGION_BEGIN(name) \
+    uint64_t perf_start_##name[PERF_EVENT_COUNT]; \
+    perf_read(perf_start_##name)
+
+#define PERF_REGION_END(name) \
+    do{ \
+        static PerfRegion perf_region_##name = {#name, 0, {0}, NULL}; \
+        static PerfRegion *perf_registered_##name = NULL; \
+        PerfRegion *perf_target = __atomic_load_n(&perf_registered_##name, __ATOMIC_ACQUIRE); \
+        if (perf_target == NULL){ \
+            perf_target = perf_region_register(&perf_region_##name); \
+            __atomic_store_n(&perf_registered_##name, perf_target, __ATOMIC_RELEASE); \
+        } \
+        perf_region_add(perf_target, perf_start_##name); \
+    }while(0)
+
+#define PERF_SAMPLE(name, value) \
+    do{ \
+        static PerfStat perf_stat = {name, 0, 0, 0, NULL}; \
+        static PerfStat *perf_registered = NULL; \
+        PerfStat *perf_target = __atomic_load_n(&perf_registered, __ATOMIC_ACQUIRE); \
+        if (perf_target == NULL){ \
+            perf_target = perf_stat_register(&perf_stat); \
+            __atomic_store_n(&perf_registered, perf_target, __ATOMIC_RELEASE); \
+        } \
+        perf_stat_add(perf_target, (uint64_t)(value)); \
+    }while(0)
+
+#define PERF_COUNT(name, amount) PERF_SAMPLE(name, amount)
+
+#else
+
+#define PERF_REGION_BEGIN(name) do{}while(0)
+#define PERF_REGION_END(name) do{}while(0)
+#define PERF_SAMPLE(name, value) do{}while(0)
+#define PERF_COUNT(name, amount) do{}while(0)
+
+#endif
+
+
+
+#endif
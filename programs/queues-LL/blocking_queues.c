@@ -0,0 +1,78 @@
+#define _GNU_SOURCE
+#include "blocking_queues.h"
+#include "queues.h"
+#include "../queues-array/parking.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+struct BlockingLinkedQueue{
+    Queue *queue;
+    pthread_mutex_t lock; // guards queue
+    Parking not_empty;    // consumers waiting for an item
+    int spin_limit;
+};
+
+BlockingLinkedQueue* blq_create(){
+    return blq_create_with_allocator(default_allocator());
+}
+
+BlockingLinkedQueue* blq_create_with_allocator(Allocator *allocator){
+    BlockingLinkedQueue *queue = allocator_allocate(allocator, sizeof(BlockingLinkedQueue));
+    if (queue == NULL){
+        return NULL;
+    }
+    queue->queue = create_queue_with_allocator(allocator);
+    if (queue->queue == NULL){
+        allocator_release(allocator, queue, sizeof(BlockingLinkedQueue));
+        return NULL;
+    }
+    pthread_mutex_init(&queue->lock, NULL);
+    parking_init(&queue->not_empty);
+    queue->spin_limit = PARK_MIN_SPIN;
+    return queue;
+}
+
+void blq_destroy(BlockingLinkedQueue *queue){
+    pthread_mutex_destroy(&queue->lock);
+    Allocator *allocator = queue->queue->allocator;
+    destroy_queue(queue->queue);
+    allocator_release(allocator, queue, sizeof(BlockingLinkedQueue));
+}
+
+ContainerStatus blq_add(BlockingLinkedQueue *queue, int item){
+    pthread_mutex_lock(&queue->lock);
+    ContainerStatus status = add(queue->queue, item);
+    pthread_mutex_unlock(&queue->lock);
+
+    if (status == CONTAINER_OK){
+        parking_wake_one(&queue->not_empty);
+    }
+    return status;
+}
+
+bool blq_try_dequeue(BlockingLinkedQueue *queue, int *item){
+    pthread_mutex_lock(&queue->lock);
+    if (is_empty(queue->queue)){
+        pthread_mutex_unlock(&queue->lock);
+        return false;
+    }
+    *item = remove_item(queue->queue);
+    pthread_mutex_unlock(&queue->lock);
+    return true;
+}
+
+static bool try_dequeue_op(void *queue, int *item){
+    return blq_try_dequeue(queue, item);
+}
+
+bool blq_dequeue_wait(BlockingLinkedQueue *queue, int *item, int timeout_ms){
+    return parking_wait_for(queue, try_dequeue_op, item, &queue->not_empty, &queue->spin_limit, timeout_ms);
+}
+
+bool blq_is_empty(BlockingLinkedQueue *queue){
+    pthread_mutex_lock(&queue->lock);
+    bool empty = is_empty(queue->queue);
+    pthread_mutex_unlock(&queue->lock);
+    return empty;
+}
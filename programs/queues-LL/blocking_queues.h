@@ -0,0 +1,36 @@
+#ifndef BLOCKING_QUEUES_H
+#define BLOCKING_QUEUES_H
+
+#include <stdbool.h>
+#include "../allocator/allocator.h"
+
+/* Blocking mode for the linked Queue in queues.h. Consumers of a plain
+Queue have to spin on is_empty() or let remove_item exit through
+check_null when the queue runs dry; blq_dequeue_wait waits for an item
+instead, with the same adaptive spin and futex park as the array
+BlockingQueue (see ../queues-array/parking.h).
+
+The Queue is unbounded, so adding never waits, and only fails when out
+of memory. The struct is opaque so this header can sit next to the array
+Queue, which has the same type name, in one program. */
+
+typedef struct BlockingLinkedQueue BlockingLinkedQueue;
+
+//Prototypes
+BlockingLinkedQueue* blq_create();
+// NULL if out of memory
+BlockingLinkedQueue* blq_create_with_allocator(Allocator *allocator);
+// only call once no thread is waiting on the queue
+void blq_destroy(BlockingLinkedQueue *queue);
+// CONTAINER_NO_MEMORY leaves the queue unchanged
+ContainerStatus blq_add(BlockingLinkedQueue *queue, int item);
+bool blq_try_dequeue(BlockingLinkedQueue *queue, int *item);
+// Dequeues into *item, waiting up to timeout_ms for an item to arrive
+// (timeout_ms < 0 waits forever, 0 only tries once). Returns false on
+// timeout.
+bool blq_dequeue_wait(BlockingLinkedQueue *queue, int *item, int timeout_ms);
+bool blq_is_empty(BlockingLinkedQueue *queue);
+
+
+
+#endif
@@ -0,0 +1,109 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+#include <time.h>
+#include <pthread.h>
+#include "blocking_queues.h"
+#include "../queues-array/wakeup_bench.h"
+
+/* Tests for the blocking linked Queue, then its wake-up latency in the
+same table as the array BlockingQueue (../queues-array/blocking_queue.c).
+
+    gcc -O2 -pthread blocking_queues_main.c blocking_queues.c queues.c -o blocking
+    ./blocking */
+
+static void test_timeouts(){
+    BlockingLinkedQueue *queue = blq_create();
+    int item;
+
+    int64_t start = wakeup_now_ns();
+    assert(!blq_dequeue_wait(queue, &item, 20));
+    assert(wakeup_now_ns() - start >= 20000000);
+    assert(!blq_try_dequeue(queue, &item) && blq_is_empty(queue));
+
+    for (int i = 0; i < 100; i++){
+        assert(blq_add(queue, i) == CONTAINER_OK); // never full
+    }
+    for (int i = 0; i < 100; i++){
+        assert(blq_dequeue_wait(queue, &item, 0) && item == i);
+    }
+    assert(blq_is_empty(queue));
+    blq_destroy(queue);
+}
+
+static void* delayed_add(void *arg){
+    struct timespec delay = {0, 20000000};
+    nanosleep(&delay, NULL);
+    blq_add(arg, 42);
+    return NULL;
+}
+
+// a consumer parked with no timeout is woken by the add
+static void test_wakeup(){
+    BlockingLinkedQueue *queue = blq_create();
+    pthread_t producer;
+    assert(pthread_create(&producer, NULL, delayed_add, queue) == 0);
+    int item;
+    assert(blq_dequeue_wait(queue, &item, -1) && item == 42);
+    pthread_join(producer, NULL);
+    blq_destroy(queue);
+}
+
+static void* consume(void *arg){
+    long sum = 0;
+    for (int i = 0; i < 100000; i++){
+        int item;
+        blq_dequeue_wait(arg, &item, -1);
+        sum += item;
+    }
+    return (void *)sum;
+}
+
+// two consumers against one producer, every item arrives exactly once
+static void test_many_consumers(){
+    BlockingLinkedQueue *queue = blq_create();
+    pthread_t consumers[2];
+    for (int t = 0; t < 2; t++){
+        assert(pthread_create(&consumers[t], NULL, consume, queue) == 0);
+    }
+    long expected = 0;
+    for (int i = 0; i < 200000; i++){
+        assert(blq_add(queue, i) == CONTAINER_OK);
+        expected += i;
+    }
+    long sum = 0;
+    for (int t = 0; t < 2; t++){
+        void *part;
+        pthread_join(consumers[t], &part);
+        sum += (long)part;
+    }
+    assert(sum == expected && blq_is_empty(queue));
+    blq_destroy(queue);
+}
+
+static void send_add(void *queue, int item){
+    blq_add(queue, item);
+}
+
+static void receive_wait(void *queue, int *item){
+    blq_dequeue_wait(queue, item, -1);
+}
+
+int main(){
+    test_timeouts();
+    test_wakeup();
+    test_many_consumers();
+    printf("Timeout and wake-up tests passed.\n\n");
+
+    print_wakeup_header();
+    int gaps[] = {0, 10, 100};
+    for (int i = 0; i < 3; i++){
+        BlockingLinkedQueue *queue = blq_create();
+        measure_wakeup((WakeupQueue){"linked", queue, send_add, receive_wait}, gaps[i]);
+        blq_destroy(queue);
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include "queues.h"
+#include "lockfree_queues.h"
+
+/* Throughput of the lock-free queue against Queue from queues.c behind a
+single pthread mutex. Every thread adds and then removes an item, so the
+queue stays short and all threads hit head and tail the whole time.
+
+    gcc -O2 -pthread queues.c lockfree_queues.c lockfree_bench.c -o bench
+    ./bench */
+
+#define OPS_PER_THREAD 1000000
+
+typedef struct BenchArgs{
+    Queue *queue;
+    pthread_mutex_t *lock;
+    LFQueue *lf_queue;
+}BenchArgs;
+
+static double now_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void* mutex_worker(void *arg){
+    BenchArgs *args = arg;
+    for(int i = 0; i < OPS_PER_THREAD; i++){
+        pthread_mutex_lock(args->lock);
+        add(args->queue, i);
+        pthread_mutex_unlock(args->lock);
+
+        pthread_mutex_lock(args->lock);
+        if(!is_empty(args->queue)){
+            remove_item(args->queue);
+        }
+        pthread_mutex_unlock(args->lock);
+    }
+    return NULL;
+}
+
+static void* lockfree_worker(void *arg){
+    BenchArgs *args = arg;
+    int thread_id = lf_register_thread(args->lf_queue);
+    int item;
+    for(int i = 0; i < OPS_PER_THREAD; i++){
+        lf_add(args->lf_queue, thread_id, i);
+        lf_remove_item(args->lf_queue, thread_id, &item);
+    }
+    lf_unregister_thread(args->lf_queue, thread_id);
+    return NULL;
+}
+
+static double run(int thread_count, void *(*worker)(void *), BenchArgs *args){
+    pthread_t threads[64];
+    double start = now_ns();
+    for(int i = 0; i < thread_count; i++){
+        pthread_create(&threads[i], NULL, worker, args);
+    }
+    for(int i = 0; i < thread_count; i++){
+        pthread_join(threads[i], NULL);
+    }
+    double seconds = (now_ns() - start) / 1e9;
+    return 2.0 * OPS_PER_THREAD * thread_count / seconds / 1e6;
+}
+
+int main(){
+    int thread_counts[] = {1, 2, 4, 8, 16};
+
+    printf("%8s %18s %20s\n", "threads", "mutex Mops/s", "lock-free Mops/s");
+    for(int i = 0; i < 5; i++){
+        pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+        BenchArgs args = {create_queue(), &lock, lf_create_queue()};
+
+        double mutex_mops = run(thread_counts[i], mutex_worker, &args);
+        double lockfree_mops = run(thread_counts[i], lockfree_worker, &args);
+        printf("%8d %18.2f %20.2f\n", thread_counts[i], mutex_mops, lockfree_mops);
+
+        while(!is_empty(args.queue)){
+            remove_item(args.queue);
+        }
+        destroy_queue(args.queue);
+        lf_destroy_queue(args.lf_queue);
+    }
+    return 0;
+}
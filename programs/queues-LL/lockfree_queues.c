@@ -0,0 +1,235 @@
+#include "lockfree_queues.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+// a thread scans the hazard pointers once it has this many retired nodes,
+// which is more than twice the number that can be protected at once
+#define LF_RETIRE_THRESHOLD (2 * 2 * LF_MAX_THREADS)
+
+#define LF_QUEUE_STORAGE (sizeof(LFQueue) + LF_CACHE_LINE - 1)
+
+static LFQueueNode* lf_new_node(LFQueue *queue, int item){
+    LFQueueNode *node = allocator_allocate(queue->allocator, sizeof(LFQueueNode));
+    if (node == NULL){
+        return NULL;
+    }
+    node->data = item;
+    node->next = NULL;
+    return node;
+}
+
+static void lf_release_node(LFQueue *queue, LFQueueNode *node){
+    allocator_release(queue->allocator, node, sizeof(LFQueueNode));
+}
+
+// returns NULL if out of memory
+LFQueue* lf_create_queue(){
+    return lf_create_queue_with_allocator(default_allocator());
+}
+
+LFQueue* lf_create_queue_with_allocator(Allocator *allocator){
+    // the hazard records need cache line alignment, which Allocator does
+    // not promise, so take a line extra and align inside it
+    void *storage = allocator_allocate(allocator, LF_QUEUE_STORAGE);
+    if (storage == NULL){
+        return NULL;
+    }
+    LFQueue *queue = (LFQueue *)(((uintptr_t)storage + LF_CACHE_LINE - 1) & ~(uintptr_t)(LF_CACHE_LINE - 1));
+    queue->allocator = allocator;
+    queue->storage = storage;
+    LFQueueNode *dummy = lf_new_node(queue, 0);
+    if (dummy == NULL){
+        allocator_release(allocator, storage, LF_QUEUE_STORAGE);
+        return NULL;
+    }
+    queue->head = dummy;
+    queue->tail = dummy;
+    for(int i = 0; i < LF_MAX_THREADS; i++){
+        queue->records[i].hazard[0] = NULL;
+        queue->records[i].hazard[1] = NULL;
+        queue->records[i].active = false;
+        queue->records[i].retired = NULL;
+        queue->records[i].retired_count = 0;
+    }
+    return queue;
+}
+
+// only call once every thread has stopped using the queue
+void lf_destroy_queue(LFQueue *queue){
+    LFQueueNode *current = queue->head;
+    while(current != NULL){
+        LFQueueNode *next = current->next;
+        lf_release_node(queue, current);
+        current = next;
+    }
+    for(int i = 0; i < LF_MAX_THREADS; i++){
+        LFHazardRecord *record = &queue->records[i];
+        for(int j = 0; j < record->retired_count; j++){
+            lf_release_node(queue, record->retired[j]);
+        }
+        allocator_release(queue->allocator, record->retired, sizeof(LFQueueNode *) * LF_RETIRE_THRESHOLD);
+    }
+    allocator_release(queue->allocator, queue->storage, LF_QUEUE_STORAGE);
+}
+
+// Claims a hazard pointer slot for the calling thread. Returns -1 if all
+// LF_MAX_THREADS slots are taken.
+int lf_register_thread(LFQueue *queue){
+    for(int i = 0; i < LF_MAX_THREADS; i++){
+        LFHazardRecord *record = &queue->records[i];
+        bool expected = false;
+        if(__atomic_compare_exchange_n(&record->active, &expected, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)){
+            if(record->retired == NULL){
+                record->retired = allocator_allocate(queue->allocator, sizeof(LFQueueNode *) * LF_RETIRE_THRESHOLD);
+                if(record->retired == NULL){
+                    __atomic_store_n(&record->active, false, __ATOMIC_RELEASE);
+                    return -1;
+                }
+            }
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Gives the slot back. Nodes it still has retired stay with the slot and
+// are freed by the next thread to claim it, or by lf_destroy_queue.
+void lf_unregister_thread(LFQueue *queue, int thread_id){
+    LFHazardRecord *record = &queue->records[thread_id];
+    __atomic_store_n(&record->hazard[0], NULL, __ATOMIC_RELEASE);
+    __atomic_store_n(&record->hazard[1], NULL, __ATOMIC_RELEASE);
+    __atomic_store_n(&record->active, false, __ATOMIC_RELEASE);
+}
+
+// Publishes node in the given hazard slot and checks that it is still
+// what *source points at. Once this returns true the node can't be freed
+// until the slot is cleared.
+static bool lf_protect(LFHazardRecord *record, int slot, LFQueueNode *node, LFQueueNode **source){
+    __atomic_store_n(&record->hazard[slot], node, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(source, __ATOMIC_SEQ_CST) == node;
+}
+
+static void lf_clear_hazards(LFHazardRecord *record){
+    __atomic_store_n(&record->hazard[0], NULL, __ATOMIC_RELEASE);
+    __atomic_store_n(&record->hazard[1], NULL, __ATOMIC_RELEASE);
+}
+
+// frees every retired node that no thread has a hazard pointer on
+static void lf_scan(LFQueue *queue, LFHazardRecord *record){
+    LFQueueNode *hazards[2 * LF_MAX_THREADS];
+    int hazard_count = 0;
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    for(int i = 0; i < LF_MAX_THREADS; i++){
+        for(int slot = 0; slot < 2; slot++){
+            LFQueueNode *node = __atomic_load_n(&queue->records[i].hazard[slot], __ATOMIC_SEQ_CST);
+            if(node != NULL){
+                hazards[hazard_count++] = node;
+            }
+        }
+    }
+
+    int kept = 0;
+    for(int i = 0; i < record->retired_count; i++){
+        LFQueueNode *node = record->retired[i];
+        bool protected = false;
+        for(int j = 0; j < hazard_count && !protected; j++){
+            protected = hazards[j] == node;
+        }
+        if(protected){
+            record->retired[kept++] = node;
+        }else{
+            lf_release_node(queue, node);
+        }
+    }
+    record->retired_count = kept;
+}
+
+static void lf_retire(LFQueue *queue, LFHazardRecord *record, LFQueueNode *node){
+    record->retired[record->retired_count++] = node;
+    if(record->retired_count == LF_RETIRE_THRESHOLD){
+        lf_scan(queue, record);
+    }
+}
+
+bool lf_add(LFQueue *queue, int thread_id, int item){
+    LFQueueNode *new_item = lf_new_node(queue, item);
+    if (new_item == NULL){
+        return false;
+    }
+    LFHazardRecord *record = &queue->records[thread_id];
+
+    LFQueueNode *tail;
+    for(;;){
+        tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+        if(!lf_protect(record, 0, tail, &queue->tail)){
+            continue;
+        }
+        LFQueueNode *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+        if(tail != __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE)){
+            continue;
+        }
+        if(next != NULL){
+            // tail is lagging behind, help the other thread move it
+            __atomic_compare_exchange_n(&queue->tail, &tail, next, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+            continue;
+        }
+        LFQueueNode *expected = NULL;
+        if(__atomic_compare_exchange_n(&tail->next, &expected, new_item, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)){
+            break;
+        }
+    }
+    __atomic_compare_exchange_n(&queue->tail, &tail, new_item, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+    lf_clear_hazards(record);
+    return true;
+}
+
+// Stores the oldest item in *item and returns true, or returns false if
+// the queue is empty.
+bool lf_remove_item(LFQueue *queue, int thread_id, int *item){
+    LFHazardRecord *record = &queue->records[thread_id];
+
+    LFQueueNode *head;
+    for(;;){
+        head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+        if(!lf_protect(record, 0, head, &queue->head)){
+            continue;
+        }
+        LFQueueNode *tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+        LFQueueNode *next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+        if(!lf_protect(record, 1, next, &head->next) ||
+           head != __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE)){
+            continue;
+        }
+        if(next == NULL){
+            lf_clear_hazards(record);
+            return false;
+        }
+        if(head == tail){
+            __atomic_compare_exchange_n(&queue->tail, &tail, next, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+            continue;
+        }
+        int data = next->data;
+        if(__atomic_compare_exchange_n(&queue->head, &head, next, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)){
+            *item = data;
+            break;
+        }
+    }
+    // next is the new dummy, the old one can go once nobody is reading it
+    lf_clear_hazards(record);
+    lf_retire(queue, record, head);
+    return true;
+}
+
+bool lf_is_empty(LFQueue *queue, int thread_id){
+    LFHazardRecord *record = &queue->records[thread_id];
+    LFQueueNode *head;
+    do{
+        head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    }while(!lf_protect(record, 0, head, &queue->head));
+    bool empty = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE) == NULL;
+    lf_clear_hazards(record);
+    return empty;
+}
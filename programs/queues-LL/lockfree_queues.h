@@ -0,0 +1,52 @@
+#ifndef LOCKFREE_QUEUES_H
+#define LOCKFREE_QUEUES_H
+
+#include <stdbool.h>
+#include "../allocator/allocator.h"
+
+/* Michael-Scott lock-free queue with the same shape as Queue in queues.h.
+Any number of threads may add and remove at the same time. Removed nodes
+are freed through hazard pointers, so each thread first claims a slot with
+lf_register_thread and passes it to every call.
+
+Nodes are allocated and released from every thread that adds or removes,
+so an allocator given to lf_create_queue_with_allocator must be safe to
+call from all of them at once. */
+
+#define LF_MAX_THREADS 64
+#define LF_CACHE_LINE 64
+
+typedef struct LFQueueNode{
+    int data;
+    struct LFQueueNode *next;
+}LFQueueNode;
+
+// per thread hazard pointers and nodes waiting to be freed
+typedef struct LFHazardRecord{
+    _Alignas(LF_CACHE_LINE) LFQueueNode *hazard[2];
+    bool active;
+    LFQueueNode **retired;
+    int retired_count;
+}LFHazardRecord;
+
+typedef struct LFQueue{
+    _Alignas(LF_CACHE_LINE) LFQueueNode *head; // always points at a dummy node
+    _Alignas(LF_CACHE_LINE) LFQueueNode *tail;
+    LFHazardRecord records[LF_MAX_THREADS];
+    Allocator *allocator;
+    void *storage; // the allocation the queue was aligned inside
+}LFQueue;
+
+//Prototypes
+LFQueue* lf_create_queue();
+LFQueue* lf_create_queue_with_allocator(Allocator *allocator);
+void lf_destroy_queue(LFQueue *queue);
+int lf_register_thread(LFQueue *queue);
+void lf_unregister_thread(LFQueue *queue, int thread_id);
+bool lf_add(LFQueue *queue, int thread_id, int item);
+bool lf_remove_item(LFQueue *queue, int thread_id, int *item);
+bool lf_is_empty(LFQueue *queue, int thread_id);
+
+
+
+#endif
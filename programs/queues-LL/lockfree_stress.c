@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include "lockfree_queues.h"
+
+/* Stress test for the lock-free queue. Producers add (producer, sequence)
+pairs, consumers check that items from each producer come out in order and
+that every item comes out exactly once.
+
+    gcc -O2 -pthread lockfree_queues.c lockfree_stress.c -o stress */
+
+#define PRODUCERS 4
+#define CONSUMERS 4
+#define ITEMS_PER_PRODUCER 200000
+
+typedef struct StressArgs{
+    LFQueue *queue;
+    int id;
+    long long sum;
+    int count;
+    int errors;
+}StressArgs;
+
+static int consumed = 0;
+
+static void* producer(void *arg){
+    StressArgs *args = arg;
+    int thread_id = lf_register_thread(args->queue);
+    assert(thread_id >= 0);
+    for(int i = 0; i < ITEMS_PER_PRODUCER; i++){
+        lf_add(args->queue, thread_id, args->id * ITEMS_PER_PRODUCER + i);
+    }
+    lf_unregister_thread(args->queue, thread_id);
+    return NULL;
+}
+
+static void* consumer(void *arg){
+    StressArgs *args = arg;
+    int thread_id = lf_register_thread(args->queue);
+    assert(thread_id >= 0);
+
+    int last_seen[PRODUCERS];
+    for(int i = 0; i < PRODUCERS; i++){
+        last_seen[i] = -1;
+    }
+
+    while(__atomic_load_n(&consumed, __ATOMIC_RELAXED) < PRODUCERS * ITEMS_PER_PRODUCER){
+        int item;
+        if(!lf_remove_item(args->queue, thread_id, &item)){
+            continue;
+        }
+        __atomic_fetch_add(&consumed, 1, __ATOMIC_RELAXED);
+        int from = item / ITEMS_PER_PRODUCER;
+        int sequence = item % ITEMS_PER_PRODUCER;
+        if(from < 0 || from >= PRODUCERS || sequence <= last_seen[from]){
+            args->errors++;
+        }else{
+            last_seen[from] = sequence;
+        }
+        args->sum += item;
+        args->count++;
+    }
+    lf_unregister_thread(args->queue, thread_id);
+    return NULL;
+}
+
+int main(){
+    LFQueue *queue = lf_create_queue();
+    pthread_t threads[PRODUCERS + CONSUMERS];
+    StressArgs args[PRODUCERS + CONSUMERS];
+
+    for(int i = 0; i < PRODUCERS + CONSUMERS; i++){
+        args[i] = (StressArgs){queue, i, 0, 0, 0};
+        pthread_create(&threads[i], NULL, i < PRODUCERS ? producer : consumer, &args[i]);
+    }
+
+    long long sum = 0;
+    int count = 0;
+    int errors = 0;
+    for(int i = 0; i < PRODUCERS + CONSUMERS; i++){
+        pthread_join(threads[i], NULL);
+        sum += args[i].sum;
+        count += args[i].count;
+        errors += args[i].errors;
+    }
+
+    long long total = (long long)PRODUCERS * ITEMS_PER_PRODUCER;
+    printf("Items consumed: %d\n", count); // Expecting 800000
+    printf("Ordering errors: %d\n", errors); // Expecting 0
+    assert(count == total);
+    assert(sum == total * (total - 1) / 2);
+    assert(errors == 0);
+
+    int thread_id = lf_register_thread(queue);
+    assert(lf_is_empty(queue, thread_id));
+    lf_unregister_thread(queue, thread_id);
+    lf_destroy_queue(queue);
+
+    printf("All tests completed.\n");
+    return 0;
+}
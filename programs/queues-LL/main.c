@@ -24,7 +24,7 @@ int main(){
         printf("Item removed: %d\n", remove_item(newQueue));
     }
 
-    free(newQueue);
+    destroy_queue(newQueue);
 
     return 0;
 }
\ No newline at end of file
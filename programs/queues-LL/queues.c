@@ -4,17 +4,34 @@
 #include <stdlib.h>
 
 Queue* create_queue(){
-    Queue *queue = malloc(sizeof(Queue));
+    return create_queue_with_allocator(default_allocator());
+}
+
+Queue* create_queue_with_allocator(Allocator *allocator){
+    Queue *queue = allocator_allocate(allocator, sizeof(Queue));
+    if (queue == NULL){
+        return NULL;
+    }
     queue->head= NULL;
     queue->tail=NULL;
+    queue->allocator = allocator;
     return queue;
 }
 
-void add(Queue *queue, int item){
-    QueueNode *new_item = malloc(sizeof(QueueNode));
-    check_address(new_item);
+void destroy_queue(Queue *queue){
+    while (!is_empty(queue)){
+        remove_item(queue);
+    }
+    allocator_release(queue->allocator, queue, sizeof(Queue));
+}
+
+ContainerStatus add(Queue *queue, int item){
+    QueueNode *new_item = allocator_allocate(queue->allocator, sizeof(QueueNode));
+    if (new_item == NULL){
+        return CONTAINER_NO_MEMORY;
+    }
     new_item->data = item;
-    new_item->next = queue->head;
+    new_item->next = NULL;
     if (queue->tail != NULL){
         queue->tail->next = new_item;
     }
@@ -22,6 +39,7 @@ void add(Queue *queue, int item){
     if (queue->head == NULL){
         queue->head = new_item;
     }
+    return CONTAINER_OK;
 }
 
 int remove_item(Queue *queue){
@@ -33,7 +51,7 @@ int remove_item(Queue *queue){
     if (queue->head == NULL){
         queue->tail = NULL;
     }
-    free(old_node);
+    allocator_release(queue->allocator, old_node, sizeof(QueueNode));
     return data;
 }
 
@@ -53,11 +71,3 @@ void check_null(void *ptr){
         exit(EXIT_FAILURE);
     }
 }
-
-void check_address(void *ptr){
-    if (ptr == NULL){
-        fprintf(stderr, "Unable to allocate memory\n");
-        exit(EXIT_FAILURE);
-    }
-
-}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define QUEUES_H
 
 #include <stdbool.h>
+#include "../allocator/allocator.h"
 
 typedef struct QueueNode{
     int data;
@@ -11,12 +12,16 @@ typedef struct QueueNode{
 typedef struct Queue{
     QueueNode *head;
     QueueNode *tail;
+    Allocator *allocator;
 }Queue;
 
 //Prototypes
 Queue* create_queue();
-void check_address(void *ptr);
-void add(Queue *queue, int item);
+// NULL if out of memory
+Queue* create_queue_with_allocator(Allocator *allocator);
+void destroy_queue(Queue *queue);
+// CONTAINER_NO_MEMORY leaves the queue unchanged
+ContainerStatus add(Queue *queue, int item);
 int remove_item(Queue *queue);
 void check_null(void *ptr);
 int peek(Queue *queue);
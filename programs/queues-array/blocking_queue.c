@@ -0,0 +1,218 @@
+#define _GNU_SOURCE
+#define QUEUE_BENCH
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include "../allocator/allocator.h"
+#include "parking.h"
+#include "main.c"
+
+/* Blocking mode for the circular Queue in main.c, so consumers no longer
+spin on is_empty() or exit when the queue is empty (and producers don't
+drop items when it is full). BlockingQueue wraps a Queue: the ring is
+the Queue's own enqueue/dequeue under a mutex, and this file only adds
+the waiting.
+
+bq_dequeue_wait/bq_enqueue_wait wait as described in parking.h: a short
+adaptive spin, then a futex park that the other side only pays a
+syscall for when someone is parked (the mutex guarding the ring is a
+futex too and only enters the kernel under contention).
+
+For event loops, bq_enable_notify returns an eventfd that becomes readable
+whenever the queue goes from empty to non-empty.
+
+The linked Queue in queues-LL gets the same waiting from
+../queues-LL/blocking_queues.c, tested and timed the same way by
+../queues-LL/blocking_queues_main.c.
+
+    gcc -O2 -pthread blocking_queue.c -o blocking
+    ./blocking */
+
+typedef struct BlockingQueue{
+    Queue *queue;
+    pthread_mutex_t lock; // guards queue
+
+    Parking not_empty;  // consumers waiting for an item
+    Parking not_full;   // producers waiting for space
+    int spin_limit;
+    int notify_fd;      // -1 unless bq_enable_notify was called
+}BlockingQueue;
+
+
+BlockingQueue* bq_create(int capacity);
+BlockingQueue* bq_create_with_allocator(int capacity, Allocator *allocator);
+void bq_destroy(BlockingQueue *queue);
+bool bq_try_enqueue(BlockingQueue *queue, int item);
+bool bq_try_dequeue(BlockingQueue *queue, int *item);
+bool bq_enqueue_wait(BlockingQueue *queue, int item, int timeout_ms);
+bool bq_dequeue_wait(BlockingQueue *queue, int *item, int timeout_ms);
+int bq_enable_notify(BlockingQueue *queue);
+
+
+
+BlockingQueue* bq_create(int capacity){
+    return bq_create_with_allocator(capacity, default_allocator());
+}
+
+// returns NULL if out of memory
+BlockingQueue* bq_create_with_allocator(int capacity, Allocator *allocator){
+    BlockingQueue *queue = allocator_allocate(allocator, sizeof(BlockingQueue));
+    if (queue == NULL){
+        return NULL;
+    }
+    queue->queue = create_queue_with_allocator(capacity, allocator);
+    if (queue->queue == NULL){
+        allocator_release(allocator, queue, sizeof(BlockingQueue));
+        return NULL;
+    }
+    pthread_mutex_init(&queue->lock, NULL);
+    parking_init(&queue->not_empty);
+    parking_init(&queue->not_full);
+    queue->spin_limit = PARK_MIN_SPIN;
+    queue->notify_fd = -1;
+    return queue;
+}
+
+void bq_destroy(BlockingQueue *queue){
+    if (queue->notify_fd >= 0){
+        close(queue->notify_fd);
+    }
+    pthread_mutex_destroy(&queue->lock);
+    Allocator *allocator = queue->queue->allocator;
+    destroy_queue(queue->queue);
+    allocator_release(allocator, queue, sizeof(BlockingQueue));
+}
+
+int bq_enable_notify(BlockingQueue *queue){
+    if (queue->notify_fd < 0){
+        queue->notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+    return queue->notify_fd;
+}
+
+bool bq_try_enqueue(BlockingQueue *queue, int item){
+    pthread_mutex_lock(&queue->lock);
+    if (is_full(queue->queue)){
+        pthread_mutex_unlock(&queue->lock);
+        return false;
+    }
+    bool was_empty = is_empty(queue->queue);
+    enqueue(queue->queue, item);
+    pthread_mutex_unlock(&queue->lock);
+
+    parking_wake_one(&queue->not_empty);
+    if (was_empty && queue->notify_fd >= 0){
+        uint64_t one = 1;
+        (void)!write(queue->notify_fd, &one, sizeof(one));
+    }
+    return true;
+}
+
+bool bq_try_dequeue(BlockingQueue *queue, int *item){
+    pthread_mutex_lock(&queue->lock);
+    if (is_empty(queue->queue)){
+        pthread_mutex_unlock(&queue->lock);
+        return false;
+    }
+    *item = dequeue(queue->queue);
+    pthread_mutex_unlock(&queue->lock);
+
+    parking_wake_one(&queue->not_full);
+    return true;
+}
+
+static bool try_enqueue_op(void *queue, int *item){
+    return bq_try_enqueue(queue, *item);
+}
+
+static bool try_dequeue_op(void *queue, int *item){
+    return bq_try_dequeue(queue, item);
+}
+
+// Dequeues into *item, waiting up to timeout_ms for an item to arrive
+// (timeout_ms < 0 waits forever, 0 only tries once). Returns false on
+// timeout.
+bool bq_dequeue_wait(BlockingQueue *queue, int *item, int timeout_ms){
+    return parking_wait_for(queue, try_dequeue_op, item, &queue->not_empty, &queue->spin_limit, timeout_ms);
+}
+
+// Enqueues item, waiting up to timeout_ms for space. Returns false on timeout.
+bool bq_enqueue_wait(BlockingQueue *queue, int item, int timeout_ms){
+    return parking_wait_for(queue, try_enqueue_op, &item, &queue->not_full, &queue->spin_limit, timeout_ms);
+}
+
+
+
+//=========== tests and latency measurement ===================================
+
+#include <assert.h>
+#include <poll.h>
+#include "wakeup_bench.h"
+
+static int64_t now_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void send_wait(void *queue, int item){
+    bq_enqueue_wait(queue, item, -1);
+}
+
+static void receive_wait(void *queue, int *item){
+    bq_dequeue_wait(queue, item, -1);
+}
+
+static void test_timeouts(){
+    BlockingQueue *queue = bq_create(2);
+    int item;
+
+    int64_t start = now_ns();
+    assert(!bq_dequeue_wait(queue, &item, 20));
+    assert(now_ns() - start >= 20000000);
+
+    assert(bq_enqueue_wait(queue, 1, 0));
+    assert(bq_enqueue_wait(queue, 2, 0));
+    assert(!bq_enqueue_wait(queue, 3, 10)); // full
+
+    assert(bq_dequeue_wait(queue, &item, 0) && item == 1);
+    assert(bq_dequeue_wait(queue, &item, -1) && item == 2);
+    bq_destroy(queue);
+}
+
+static void test_notify(){
+    BlockingQueue *queue = bq_create(4);
+    int fd = bq_enable_notify(queue);
+    struct pollfd pfd = {fd, POLLIN, 0};
+
+    assert(poll(&pfd, 1, 0) == 0);
+    bq_try_enqueue(queue, 7);
+    assert(poll(&pfd, 1, 0) == 1);
+
+    uint64_t count;
+    assert(read(fd, &count, sizeof(count)) == sizeof(count));
+    int item;
+    assert(bq_try_dequeue(queue, &item) && item == 7);
+    bq_destroy(queue);
+}
+
+int main(){
+    test_timeouts();
+    test_notify();
+    printf("Timeout and notify tests passed.\n\n");
+
+    print_wakeup_header();
+    int gaps[] = {0, 10, 100};
+    for (int i = 0; i < 3; i++){
+        BlockingQueue *queue = bq_create(64);
+        measure_wakeup((WakeupQueue){"array", queue, send_wait, receive_wait}, gaps[i]);
+        bq_destroy(queue);
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "../allocator/allocator.h"
+
+/* Growable version of the circular Queue in main.c. Instead of rejecting
+items when full it doubles its buffer in place, and items can be pushed
+and popped at both ends in amortized O(1) with no per item allocation
+(unlike queues-LL, which mallocs a node per item).
+
+Capacity is always a power of two so wrapping is a mask. */
+
+#define DEQUE_MIN_CAPACITY 16
+
+typedef struct Deque{
+    int *data;
+    int size;
+    int capacity;
+    int first;
+    Allocator *allocator;
+}Deque;
+
+
+Deque* deque_create(int capacity);
+Deque* deque_create_with_allocator(int capacity, Allocator *allocator);
+void deque_destroy(Deque *deque);
+int deque_size(Deque *deque);
+bool deque_is_empty(Deque *deque);
+ContainerStatus deque_push_back(Deque *deque, int item);
+ContainerStatus deque_push_front(Deque *deque, int item);
+int deque_pop_front(Deque *deque);
+int deque_pop_back(Deque *deque);
+int deque_front(Deque *deque);
+int deque_back(Deque *deque);
+int deque_at(Deque *deque, int index);
+static ContainerStatus deque_grow(Deque *deque);
+static void deque_check_not_empty(Deque *deque);
+
+
+
+Deque* deque_create(int capacity){
+    return deque_create_with_allocator(capacity, default_allocator());
+}
+
+// returns NULL if out of memory
+Deque* deque_create_with_allocator(int capacity, Allocator *allocator){
+    int true_capacity = DEQUE_MIN_CAPACITY;
+    while (true_capacity < capacity){
+        true_capacity *= 2;
+    }
+
+    Deque *deque = allocator_allocate(allocator, sizeof(Deque));
+    if (deque == NULL){
+        return NULL;
+    }
+    deque->data = allocator_allocate(allocator, sizeof(int) * true_capacity);
+    if (deque->data == NULL){
+        allocator_release(allocator, deque, sizeof(Deque));
+        return NULL;
+    }
+    deque->allocator = allocator;
+    deque->size = 0;
+    deque->capacity = true_capacity;
+    deque->first = 0;
+    return deque;
+}
+
+void deque_destroy(Deque *deque){
+    allocator_release(deque->allocator, deque->data, sizeof(int) * deque->capacity);
+    allocator_release(deque->allocator, deque, sizeof(Deque));
+}
+
+int deque_size(Deque *deque){
+    return deque->size;
+}
+
+bool deque_is_empty(Deque *deque){
+    return deque->size == 0;
+}
+
+// Doubles the buffer. realloc keeps [0, capacity) in place, so only the
+// part that had wrapped around to the start has to move: it is copied to
+// just past the old end, which makes the items contiguous again.
+static ContainerStatus deque_grow(Deque *deque){
+    int old_capacity = deque->capacity;
+    int *new_data = allocator_reallocate(deque->allocator, deque->data, sizeof(int) * old_capacity,
+                                         sizeof(int) * old_capacity * 2);
+    if (new_data == NULL){
+        return CONTAINER_NO_MEMORY;
+    }
+    deque->data = new_data;
+    deque->capacity = old_capacity * 2;
+
+    int wrapped = deque->first + deque->size - old_capacity;
+    if (wrapped > 0){
+        memcpy(deque->data + old_capacity, deque->data, sizeof(int) * wrapped);
+    }
+    return CONTAINER_OK;
+}
+
+ContainerStatus deque_push_back(Deque *deque, int item){
+    if (deque->size == deque->capacity && deque_grow(deque) != CONTAINER_OK){
+        return CONTAINER_NO_MEMORY;
+    }
+    deque->data[(deque->first + deque->size) & (deque->capacity - 1)] = item;
+    deque->size++;
+    return CONTAINER_OK;
+}
+
+ContainerStatus deque_push_front(Deque *deque, int item){
+    if (deque->size == deque->capacity && deque_grow(deque) != CONTAINER_OK){
+        return CONTAINER_NO_MEMORY;
+    }
+    deque->first = (deque->first - 1) & (deque->capacity - 1);
+    deque->data[deque->first] = item;
+    deque->size++;
+    return CONTAINER_OK;
+}
+
+int deque_pop_front(Deque *deque){
+    deque_check_not_empty(deque);
+    int item = deque->data[deque->first];
+    deque->first = (deque->first + 1) & (deque->capacity - 1);
+    deque->size--;
+    return item;
+}
+
+int deque_pop_back(Deque *deque){
+    deque_check_not_empty(deque);
+    deque->size--;
+    return deque->data[(deque->first + deque->size) & (deque->capacity - 1)];
+}
+
+int deque_front(Deque *deque){
+    deque_check_not_empty(deque);
+    return deque->data[deque->first];
+}
+
+int deque_back(Deque *deque){
+    deque_check_not_empty(deque);
+    return deque->data[(deque->first + deque->size - 1) & (deque->capacity - 1)];
+}
+
+int deque_at(Deque *deque, int index){
+    if (index < 0 || index >= deque->size){
+        fprintf(stderr, "Index out of bounds.\n");
+        exit(EXIT_FAILURE);
+    }
+    return deque->data[(deque->first + index) & (deque->capacity - 1)];
+}
+
+static void deque_check_not_empty(Deque *deque){
+    if (deque_is_empty(deque)){
+        fprintf(stderr, "Deque is empty. Cannot remove item.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+#ifndef QUEUE_BENCH
+int main() {
+    Deque *deque = deque_create(4);
+
+    // push past the initial capacity from both ends so the buffer wraps
+    // and then grows
+    for (int i = 0; i < 20; i++) {
+        deque_push_back(deque, i);
+        deque_push_front(deque, -i - 1);
+    }
+    printf("Size: %d\n", deque_size(deque)); // Expecting 40
+    printf("Front: %d\n", deque_front(deque)); // Expecting -20
+    printf("Back: %d\n", deque_back(deque)); // Expecting 19
+    printf("At 20: %d\n", deque_at(deque, 20)); // Expecting 0
+
+    printf("Pop front: %d\n", deque_pop_front(deque)); // Expecting -20
+    printf("Pop back: %d\n", deque_pop_back(deque)); // Expecting 19
+
+    int expected = -19;
+    bool in_order = true;
+    while (!deque_is_empty(deque)) {
+        in_order &= deque_pop_front(deque) == expected++;
+    }
+    printf("Drained in order: %s\n", in_order ? "true" : "false"); // Expecting true
+
+    deque_destroy(deque);
+    return 0;
+}
+#endif
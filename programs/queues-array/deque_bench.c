@@ -0,0 +1,109 @@
+#define QUEUE_BENCH
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#include "deque.c"
+#include "../queues-LL/queues.c"
+
+/* FIFO throughput of the growable Deque against the linked Queue from
+queues-LL, which mallocs and frees a node per item.
+
+- steady: the queue holds a fixed backlog while items are added at the
+  back and removed from the front
+- burst:  fill the queue with every item, then drain it
+
+    gcc -O2 deque_bench.c -o bench
+    ./bench */
+
+static double now_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile long long sink;
+
+static double steady_deque(int backlog, int items){
+    Deque *deque = deque_create(DEQUE_MIN_CAPACITY);
+    for (int i = 0; i < backlog; i++){
+        deque_push_back(deque, i);
+    }
+    long long checksum = 0;
+    double start = now_ns();
+    for (int i = 0; i < items; i++){
+        deque_push_back(deque, i);
+        checksum += deque_pop_front(deque);
+    }
+    double elapsed = now_ns() - start;
+    sink = checksum;
+    deque_destroy(deque);
+    return items / elapsed * 1e3;
+}
+
+static double steady_linked(int backlog, int items){
+    Queue *queue = create_queue();
+    for (int i = 0; i < backlog; i++){
+        add(queue, i);
+    }
+    long long checksum = 0;
+    double start = now_ns();
+    for (int i = 0; i < items; i++){
+        add(queue, i);
+        checksum += remove_item(queue);
+    }
+    double elapsed = now_ns() - start;
+    sink = checksum;
+    while (!is_empty(queue)){
+        remove_item(queue);
+    }
+    destroy_queue(queue);
+    return items / elapsed * 1e3;
+}
+
+static double burst_deque(int items){
+    Deque *deque = deque_create(DEQUE_MIN_CAPACITY);
+    long long checksum = 0;
+    double start = now_ns();
+    for (int i = 0; i < items; i++){
+        deque_push_back(deque, i);
+    }
+    while (!deque_is_empty(deque)){
+        checksum += deque_pop_front(deque);
+    }
+    double elapsed = now_ns() - start;
+    sink = checksum;
+    deque_destroy(deque);
+    return items / elapsed * 1e3;
+}
+
+static double burst_linked(int items){
+    Queue *queue = create_queue();
+    long long checksum = 0;
+    double start = now_ns();
+    for (int i = 0; i < items; i++){
+        add(queue, i);
+    }
+    while (!is_empty(queue)){
+        checksum += remove_item(queue);
+    }
+    double elapsed = now_ns() - start;
+    sink = checksum;
+    destroy_queue(queue);
+    return items / elapsed * 1e3;
+}
+
+int main(){
+    printf("%-24s %18s %20s\n", "workload", "deque M items/s", "queues-LL M items/s");
+    int backlogs[] = {0, 1000, 1000000};
+    for (int i = 0; i < 3; i++){
+        char name[32];
+        snprintf(name, sizeof(name), "steady, backlog %d", backlogs[i]);
+        printf("%-24s %18.1f %20.1f\n", name, steady_deque(backlogs[i], 20000000), steady_linked(backlogs[i], 20000000));
+    }
+    int bursts[] = {1000, 1000000, 10000000};
+    for (int i = 0; i < 3; i++){
+        char name[32];
+        snprintf(name, sizeof(name), "burst of %d", bursts[i]);
+        printf("%-24s %18.1f %20.1f\n", name, burst_deque(bursts[i]), burst_linked(bursts[i]));
+    }
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include "../allocator/allocator.h"
 
 typedef struct Queue{
     int *data;
@@ -8,31 +10,50 @@ typedef struct Queue{
     int capacity;
     int first;
     int last;
-
+    Allocator *allocator;
 }Queue;
 
 
 Queue* create_queue(int capacity);
+Queue* create_queue_with_allocator(int capacity, Allocator *allocator);
+void destroy_queue(Queue *queue);
 void enqueue(Queue *queue, int item);
 int dequeue(Queue *queue);
-void check_address(void *ptr);
+int enqueue_many(Queue *queue, const int *items, int n);
+int dequeue_many(Queue *queue, int *out, int n);
 bool is_empty(Queue *queue);
 bool is_full(Queue *queue);
 
 
 
 Queue* create_queue(int capacity){
-    Queue *queue = malloc(sizeof(Queue));
-    check_address(queue);
+    return create_queue_with_allocator(capacity, default_allocator());
+}
+
+// returns NULL if out of memory
+Queue* create_queue_with_allocator(int capacity, Allocator *allocator){
+    Queue *queue = allocator_allocate(allocator, sizeof(Queue));
+    if (queue == NULL){
+        return NULL;
+    }
     queue->size = 0;
     queue->capacity=capacity;
-    queue->data = malloc(sizeof(int) * queue->capacity);
-    check_address(queue->data);
+    queue->allocator = allocator;
+    queue->data = allocator_allocate(allocator, sizeof(int) * queue->capacity);
+    if (queue->data == NULL){
+        allocator_release(allocator, queue, sizeof(Queue));
+        return NULL;
+    }
     queue->first = 0;
     queue->last = -1;
     return queue;
 }
 
+void destroy_queue(Queue *queue){
+    allocator_release(queue->allocator, queue->data, sizeof(int) * queue->capacity);
+    allocator_release(queue->allocator, queue, sizeof(Queue));
+}
+
 void enqueue(Queue *queue, int item){
     if (is_full(queue)){
         fprintf(stderr, "Queue is full. Cannot enque new items.\n");
@@ -54,15 +75,48 @@ int dequeue(Queue *queue) {
     return item;
 }
 
+// Copies up to n items in with at most two memcpys (before and after the
+// wrap point). Returns how many fit.
+int enqueue_many(Queue *queue, const int *items, int n){
+    int free_slots = queue->capacity - queue->size;
+    int count = n < free_slots ? n : free_slots;
+    if (count <= 0){
+        return 0;
+    }
 
+    int start = (queue->last + 1) % queue->capacity;
+    int first_run = queue->capacity - start;
+    if (first_run > count){
+        first_run = count;
+    }
+    memcpy(queue->data + start, items, sizeof(int) * first_run);
+    memcpy(queue->data, items + first_run, sizeof(int) * (count - first_run));
 
-void check_address(void *ptr){
-    if (ptr == NULL){
-        fprintf(stderr, "Failed to allocate memory.\n");
-        exit(EXIT_FAILURE);
+    queue->last = (start + count - 1) % queue->capacity;
+    queue->size += count;
+    return count;
+}
+
+// Copies up to n items out into out. Returns how many were dequeued.
+int dequeue_many(Queue *queue, int *out, int n){
+    int count = n < queue->size ? n : queue->size;
+    if (count <= 0){
+        return 0;
+    }
+
+    int first_run = queue->capacity - queue->first;
+    if (first_run > count){
+        first_run = count;
     }
+    memcpy(out, queue->data + queue->first, sizeof(int) * first_run);
+    memcpy(out + first_run, queue->data, sizeof(int) * (count - first_run));
+
+    queue->first = (queue->first + count) % queue->capacity;
+    queue->size -= count;
+    return count;
 }
 
+
 bool is_empty(Queue *queue){
     return (queue->size == 0);
 }
@@ -71,7 +125,7 @@ bool is_full(Queue *queue){
     return (queue->size == queue->capacity);
 }
 
-
+#ifndef QUEUE_BENCH
 int main() {
     Queue *queue = create_queue(5);
 
@@ -91,8 +145,17 @@ int main() {
         printf("Dequeued: %d\n", dequeue(queue));
     }
 
-    free(queue->data);
-    free(queue);
+    int batch[] = {1, 2, 3, 4, 5, 6};
+    enqueue(queue, 0);
+    printf("Enqueued many: %d\n", enqueue_many(queue, batch, 6)); // Expecting 4, wraps around
+    int out[5];
+    int count = dequeue_many(queue, out, 5);
+    for (int i = 0; i < count; i++) {
+        printf("Dequeued: %d\n", out[i]); // Expecting 0 1 2 3 4
+    }
+
+    destroy_queue(queue);
 
     return 0;
-}
\ No newline at end of file
+}
+#endif
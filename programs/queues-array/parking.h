@@ -0,0 +1,128 @@
+#ifndef PARKING_H
+#define PARKING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+/* Waiting shared by the blocking queues (BlockingQueue in
+blocking_queue.c, and the one over the linked Queue in
+../queues-LL/blocking_queues.c). A waiter retries for a short, adaptive
+number of spins, then parks on a futex word. The waking side only bumps
+the word and calls FUTEX_WAKE when someone is actually parked, so an
+uncontended operation never makes a syscall.
+
+Include after defining _GNU_SOURCE (for syscall). */
+
+#define PARK_MIN_SPIN 16
+#define PARK_MAX_SPIN 4096
+
+#if defined(__x86_64__) || defined(__i386__)
+#define cpu_relax() __builtin_ia32_pause()
+#else
+#define cpu_relax() __asm__ __volatile__("" ::: "memory")
+#endif
+
+typedef struct Parking{
+    uint32_t word; // futex word, bumped when waking parked threads
+    int waiters;   // threads parked (or about to park) on word
+}Parking;
+
+// one attempt at the operation being waited for
+typedef bool (*ParkTry)(void *target, int *item);
+
+static inline void parking_init(Parking *parking){
+    parking->word = 0;
+    parking->waiters = 0;
+}
+
+// bumps the futex word and wakes one parked thread, but only if one is parked
+static inline void parking_wake_one(Parking *parking){
+    if (__atomic_load_n(&parking->waiters, __ATOMIC_SEQ_CST) > 0){
+        __atomic_fetch_add(&parking->word, 1, __ATOMIC_SEQ_CST);
+        syscall(SYS_futex, &parking->word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+}
+
+// parks while *word == seen; returns early on a wake, a signal or timeout
+static inline void parking_futex_wait(uint32_t *word, uint32_t seen, const struct timespec *timeout){
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, seen, timeout, NULL, 0);
+}
+
+static inline void parking_deadline_after(struct timespec *deadline, int timeout_ms){
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+    if (deadline->tv_nsec >= 1000000000){
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+}
+
+// time left until deadline, false once it has passed
+static inline bool parking_time_left(const struct timespec *deadline, struct timespec *left){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    left->tv_sec = deadline->tv_sec - now.tv_sec;
+    left->tv_nsec = deadline->tv_nsec - now.tv_nsec;
+    if (left->tv_nsec < 0){
+        left->tv_sec--;
+        left->tv_nsec += 1000000000;
+    }
+    return left->tv_sec >= 0;
+}
+
+// Spin, then park on parking until try succeeds or timeout_ms passes
+// (timeout_ms < 0 waits forever, 0 only tries once). spin_limit grows
+// when spinning pays off and shrinks when it doesn't.
+static inline bool parking_wait_for(void *target, ParkTry try, int *item, Parking *parking,
+                                    int *spin_limit, int timeout_ms){
+    if (try(target, item)){
+        return true;
+    }
+    if (timeout_ms == 0){
+        return false;
+    }
+
+    int limit = __atomic_load_n(spin_limit, __ATOMIC_RELAXED);
+    for (int i = 0; i < limit; i++){
+        cpu_relax();
+        if (try(target, item)){
+            if (limit < PARK_MAX_SPIN){
+                __atomic_store_n(spin_limit, limit * 2, __ATOMIC_RELAXED);
+            }
+            return true;
+        }
+    }
+    if (limit > PARK_MIN_SPIN){
+        __atomic_store_n(spin_limit, limit / 2, __ATOMIC_RELAXED);
+    }
+
+    struct timespec deadline, left;
+    if (timeout_ms > 0){
+        parking_deadline_after(&deadline, timeout_ms);
+    }
+
+    bool done = false;
+    __atomic_fetch_add(&parking->waiters, 1, __ATOMIC_SEQ_CST);
+    for (;;){
+        // read the word before the last try, so a wake that lands between
+        // the try and the futex call makes the wait return immediately
+        uint32_t seen = __atomic_load_n(&parking->word, __ATOMIC_SEQ_CST);
+        if (try(target, item)){
+            done = true;
+            break;
+        }
+        if (timeout_ms > 0 && !parking_time_left(&deadline, &left)){
+            break;
+        }
+        parking_futex_wait(&parking->word, seen, timeout_ms > 0 ? &left : NULL);
+    }
+    __atomic_fetch_sub(&parking->waiters, 1, __ATOMIC_SEQ_CST);
+    return done;
+}
+
+#endif
@@ -0,0 +1,76 @@
+#define QUEUE_BENCH
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#include "main.c"
+
+/* Moves the same number of items through the circular Queue in main.c one
+at a time with enqueue/dequeue and in batches with enqueue_many/
+dequeue_many, for batch sizes from 1 to 1024.
+
+    gcc -O2 queue_bench.c -o bench
+    ./bench */
+
+#define TOTAL_ITEMS 100000000
+#define QUEUE_CAPACITY 3000 // not a multiple of the batch size, so batches wrap
+
+static double now_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile long long sink;
+
+static double bench_single(int batch){
+    Queue *queue = create_queue(QUEUE_CAPACITY);
+    long long checksum = 0;
+
+    double start = now_ns();
+    for (int done = 0; done < TOTAL_ITEMS; done += batch){
+        for (int i = 0; i < batch; i++){
+            enqueue(queue, done + i);
+        }
+        for (int i = 0; i < batch; i++){
+            checksum += dequeue(queue);
+        }
+    }
+    double elapsed = now_ns() - start;
+
+    sink = checksum;
+    destroy_queue(queue);
+    return TOTAL_ITEMS / elapsed * 1e3;
+}
+
+static double bench_batch(int batch){
+    Queue *queue = create_queue(QUEUE_CAPACITY);
+    int *items = malloc(sizeof(int) * batch);
+    int *out = malloc(sizeof(int) * batch);
+    long long checksum = 0;
+
+    double start = now_ns();
+    for (int done = 0; done < TOTAL_ITEMS; done += batch){
+        for (int i = 0; i < batch; i++){
+            items[i] = done + i;
+        }
+        enqueue_many(queue, items, batch);
+        dequeue_many(queue, out, batch);
+        checksum += out[batch - 1];
+    }
+    double elapsed = now_ns() - start;
+
+    sink = checksum;
+    free(items);
+    free(out);
+    destroy_queue(queue);
+    return TOTAL_ITEMS / elapsed * 1e3;
+}
+
+int main(){
+    printf("%6s %18s %18s %8s\n", "batch", "single M items/s", "batch M items/s", "speedup");
+    for (int batch = 1; batch <= 1024; batch *= 2){
+        double single = bench_single(batch);
+        double batched = bench_batch(batch);
+        printf("%6d %18.1f %18.1f %7.1fx\n", batch, single, batched, batched / single);
+    }
+    return 0;
+}
@@ -0,0 +1,223 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "../allocator/allocator.h"
+
+/* Single-producer/single-consumer version of the circular Queue in
+main.c. Exactly one thread enqueues and exactly one thread dequeues.
+
+- capacity is rounded up to a power of two, so wrapping is a mask
+  instead of % capacity
+- head and tail only ever increase; there is no shared size counter, the
+  fill level is tail - head
+- the producer's fields and the consumer's fields live on separate cache
+  lines, and each side keeps a cached copy of the other side's index so it
+  only reads the other core's line when the cached value says full/empty
+
+    gcc -O2 -pthread spsc_queue.c -o spsc
+    ./spsc */
+
+#define CACHE_LINE 64
+
+typedef struct SPSCQueue{
+    // written by the producer
+    _Alignas(CACHE_LINE) size_t tail;
+    size_t cached_head;
+    // written by the consumer
+    _Alignas(CACHE_LINE) size_t head;
+    size_t cached_tail;
+    // read only after creation
+    _Alignas(CACHE_LINE) int *data;
+    size_t mask;
+    Allocator *allocator;
+    void *storage; // the allocation the queue was aligned inside
+}SPSCQueue;
+
+
+SPSCQueue* spsc_create_queue(size_t capacity);
+SPSCQueue* spsc_create_queue_with_allocator(size_t capacity, Allocator *allocator);
+void spsc_destroy_queue(SPSCQueue *queue);
+bool spsc_enqueue(SPSCQueue *queue, int item);
+bool spsc_dequeue(SPSCQueue *queue, int *item);
+size_t spsc_capacity(SPSCQueue *queue);
+
+
+
+SPSCQueue* spsc_create_queue(size_t capacity){
+    return spsc_create_queue_with_allocator(capacity, default_allocator());
+}
+
+// returns NULL if out of memory
+SPSCQueue* spsc_create_queue_with_allocator(size_t capacity, Allocator *allocator){
+    size_t true_capacity = 2;
+    while(true_capacity < capacity){
+        true_capacity *= 2;
+    }
+
+    // Allocator does not promise cache line alignment, so take a line
+    // extra and align inside it
+    void *storage = allocator_allocate(allocator, sizeof(SPSCQueue) + CACHE_LINE - 1);
+    if (storage == NULL){
+        return NULL;
+    }
+    SPSCQueue *queue = (SPSCQueue *)(((uintptr_t)storage + CACHE_LINE - 1) & ~(uintptr_t)(CACHE_LINE - 1));
+    queue->allocator = allocator;
+    queue->storage = storage;
+    queue->data = allocator_allocate(allocator, sizeof(int) * true_capacity);
+    if (queue->data == NULL){
+        allocator_release(allocator, storage, sizeof(SPSCQueue) + CACHE_LINE - 1);
+        return NULL;
+    }
+    queue->mask = true_capacity - 1;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->cached_head = 0;
+    queue->cached_tail = 0;
+    return queue;
+}
+
+void spsc_destroy_queue(SPSCQueue *queue){
+    allocator_release(queue->allocator, queue->data, sizeof(int) * (queue->mask + 1));
+    allocator_release(queue->allocator, queue->storage, sizeof(SPSCQueue) + CACHE_LINE - 1);
+}
+
+size_t spsc_capacity(SPSCQueue *queue){
+    return queue->mask + 1;
+}
+
+// producer only, returns false if the queue is full
+bool spsc_enqueue(SPSCQueue *queue, int item){
+    size_t tail = queue->tail;
+    if (tail - queue->cached_head > queue->mask){
+        queue->cached_head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+        if (tail - queue->cached_head > queue->mask){
+            return false;
+        }
+    }
+    queue->data[tail & queue->mask] = item;
+    __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// consumer only, returns false if the queue is empty
+bool spsc_dequeue(SPSCQueue *queue, int *item){
+    size_t head = queue->head;
+    if (head == queue->cached_tail){
+        queue->cached_tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+        if (head == queue->cached_tail){
+            return false;
+        }
+    }
+    *item = queue->data[head & queue->mask];
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+
+
+//=========== tests and benchmark ===================================
+
+#define BENCH_ITEMS 200000000
+
+typedef struct Worker{
+    SPSCQueue *queue;
+    int cpu;
+    long long checksum;
+    bool in_order;
+}Worker;
+
+static bool pin_to_cpu(int cpu){
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+static void* producer(void *arg){
+    Worker *worker = arg;
+    pin_to_cpu(worker->cpu);
+    for (int i = 0; i < BENCH_ITEMS; i++){
+        while (!spsc_enqueue(worker->queue, i)){
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* consumer(void *arg){
+    Worker *worker = arg;
+    pin_to_cpu(worker->cpu);
+    worker->in_order = true;
+    worker->checksum = 0;
+    for (int i = 0; i < BENCH_ITEMS; i++){
+        int item;
+        while (!spsc_dequeue(worker->queue, &item)){
+            sched_yield();
+        }
+        worker->in_order &= item == i;
+        worker->checksum += item;
+    }
+    return NULL;
+}
+
+static void test_single_thread(){
+    SPSCQueue *queue = spsc_create_queue(5);
+    assert(spsc_capacity(queue) == 8);
+
+    int item;
+    assert(!spsc_dequeue(queue, &item));
+    for (int i = 0; i < 8; i++){
+        assert(spsc_enqueue(queue, i * 10));
+    }
+    assert(!spsc_enqueue(queue, 80)); // full
+
+    // wrap around a few times
+    for (int round = 0; round < 3; round++){
+        for (int i = 0; i < 8; i++){
+            assert(spsc_dequeue(queue, &item));
+            assert(spsc_enqueue(queue, item));
+        }
+    }
+    for (int i = 0; i < 8; i++){
+        assert(spsc_dequeue(queue, &item));
+        assert(item == i * 10);
+    }
+    assert(!spsc_dequeue(queue, &item));
+    spsc_destroy_queue(queue);
+}
+
+int main(){
+    test_single_thread();
+    printf("Single thread tests passed.\n");
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    SPSCQueue *queue = spsc_create_queue(1 << 16);
+    Worker producer_worker = {queue, 0, 0, true};
+    Worker consumer_worker = {queue, cpus > 1 ? 1 : 0, 0, true};
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_t producer_thread, consumer_thread;
+    pthread_create(&producer_thread, NULL, producer, &producer_worker);
+    pthread_create(&consumer_thread, NULL, consumer, &consumer_worker);
+    pthread_join(producer_thread, NULL);
+    pthread_join(consumer_thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    long long expected = (long long)BENCH_ITEMS * (BENCH_ITEMS - 1) / 2;
+    printf("Items in order: %s\n", consumer_worker.in_order && consumer_worker.checksum == expected ? "true" : "false");
+    printf("Producer cpu %d, consumer cpu %d\n", producer_worker.cpu, consumer_worker.cpu);
+    printf("Throughput: %.1f M items/s\n", BENCH_ITEMS / seconds / 1e6);
+
+    spsc_destroy_queue(queue);
+    return 0;
+}
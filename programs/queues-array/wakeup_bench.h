@@ -0,0 +1,88 @@
+#ifndef WAKEUP_BENCH_H
+#define WAKEUP_BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+/* Producer to consumer wake-up latency for the blocking queues: the
+producer sends one item every gap_us while the consumer waits for it, so
+each item measures one wake-up (a spin hit at small gaps, a futex park at
+large ones). The queue is passed as a send and a blocking receive, so
+blocking_queue.c and ../queues-LL/blocking_queues_main.c print the same
+table. */
+
+#define WAKEUP_HANDOFFS 20000
+
+typedef struct WakeupQueue{
+    const char *name;
+    void *queue;
+    void (*send)(void *queue, int item);
+    void (*receive)(void *queue, int *item); // waits until an item arrives
+}WakeupQueue;
+
+typedef struct WakeupHandoff{
+    WakeupQueue queue;
+    int64_t sent_ns[WAKEUP_HANDOFFS];
+    int64_t latency_ns[WAKEUP_HANDOFFS];
+}WakeupHandoff;
+
+static int64_t wakeup_now_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void* wakeup_consumer(void *arg){
+    WakeupHandoff *handoff = arg;
+    for (int i = 0; i < WAKEUP_HANDOFFS; i++){
+        int item;
+        handoff->queue.receive(handoff->queue.queue, &item);
+        handoff->latency_ns[item] = wakeup_now_ns() - __atomic_load_n(&handoff->sent_ns[item], __ATOMIC_ACQUIRE);
+    }
+    return NULL;
+}
+
+static int wakeup_compare(const void *a, const void *b){
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void print_wakeup_header(){
+    printf("Producer to consumer wake-up latency (us)\n");
+    printf("%-8s %8s %12s %12s %12s\n", "queue", "gap us", "p50", "p99", "max");
+}
+
+static void measure_wakeup(WakeupQueue queue, int gap_us){
+    static WakeupHandoff handoff;
+    handoff.queue = queue;
+
+    pthread_t consumer;
+    if (pthread_create(&consumer, NULL, wakeup_consumer, &handoff) != 0){
+        printf("%-8s %8d  unable to start the consumer\n", queue.name, gap_us);
+        return;
+    }
+    for (int i = 0; i < WAKEUP_HANDOFFS; i++){
+        if (gap_us > 0){
+            struct timespec gap = {0, gap_us * 1000L};
+            nanosleep(&gap, NULL);
+        }
+        __atomic_store_n(&handoff.sent_ns[i], wakeup_now_ns(), __ATOMIC_RELEASE);
+        queue.send(queue.queue, i);
+    }
+    pthread_join(consumer, NULL);
+
+    qsort(handoff.latency_ns, WAKEUP_HANDOFFS, sizeof(int64_t), wakeup_compare);
+    printf("%-8s %8d %12.1f %12.1f %12.1f\n", queue.name, gap_us,
+           handoff.latency_ns[WAKEUP_HANDOFFS / 2] / 1000.0,
+           handoff.latency_ns[WAKEUP_HANDOFFS * 99 / 100] / 1000.0,
+           handoff.latency_ns[WAKEUP_HANDOFFS - 1] / 1000.0);
+}
+
+
+
+#endif
@@ -0,0 +1,173 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <pthread.h>
+#include "scheduler.h"
+
+/* Tests for the work-stealing deque and the scheduler.
+
+    gcc -O2 -pthread main.c scheduler.c ws_deque.c -o scheduler
+    ./scheduler */
+
+#define STEAL_ITEMS 200000
+#define THIEVES 3
+
+static void test_deque_order(){
+    WSDeque deque;
+    assert(ws_deque_init(&deque, 4));
+    static int values[100];
+
+    // push past the initial capacity so the buffer grows
+    for (int i = 0; i < 100; i++){
+        values[i] = i;
+        assert(ws_push(&deque, &values[i]));
+    }
+    assert(*(int *)ws_steal(&deque) == 0);  // thieves take the oldest
+    assert(*(int *)ws_take(&deque) == 99);  // the owner takes the newest
+    assert(*(int *)ws_steal(&deque) == 1);
+    for (int i = 98; i >= 2; i--){
+        assert(*(int *)ws_take(&deque) == i);
+    }
+    assert(ws_take(&deque) == NULL);
+    assert(ws_steal(&deque) == NULL);
+    ws_deque_destroy(&deque);
+}
+
+typedef struct StealTest{
+    WSDeque deque;
+    int items[STEAL_ITEMS];
+    int taken[STEAL_ITEMS]; // times each item was handed out
+    bool done;
+}StealTest;
+
+static void record(StealTest *test, void *item){
+    int index = (int *)item - test->items;
+    __atomic_fetch_add(&test->taken[index], 1, __ATOMIC_RELAXED);
+}
+
+static void* thief(void *arg){
+    StealTest *test = arg;
+    for (;;){
+        bool done = __atomic_load_n(&test->done, __ATOMIC_ACQUIRE);
+        void *item = ws_steal(&test->deque);
+        if (item != NULL){
+            record(test, item);
+        }else if (done){
+            return NULL;
+        }
+    }
+}
+
+// the owner pushes and takes while thieves steal; every item must come out
+// exactly once
+static void test_concurrent_steal(){
+    StealTest *test = calloc(1, sizeof(StealTest));
+    assert(test != NULL);
+    assert(ws_deque_init(&test->deque, 16));
+
+    pthread_t thieves[THIEVES];
+    for (int i = 0; i < THIEVES; i++){
+        pthread_create(&thieves[i], NULL, thief, test);
+    }
+
+    for (int i = 0; i < STEAL_ITEMS; i++){
+        ws_push(&test->deque, &test->items[i]);
+        if (i % 3 == 0){
+            void *item = ws_take(&test->deque);
+            if (item != NULL){
+                record(test, item);
+            }
+        }
+    }
+    void *item;
+    while ((item = ws_take(&test->deque)) != NULL){
+        record(test, item);
+    }
+    __atomic_store_n(&test->done, true, __ATOMIC_RELEASE);
+    for (int i = 0; i < THIEVES; i++){
+        pthread_join(thieves[i], NULL);
+    }
+
+    for (int i = 0; i < STEAL_ITEMS; i++){
+        assert(test->taken[i] == 1);
+    }
+    ws_deque_destroy(&test->deque);
+    free(test);
+}
+
+typedef struct FibArgs{
+    int n;
+    long result;
+}FibArgs;
+
+static void fib_task(void *arg){
+    FibArgs *args = arg;
+    if (args->n < 2){
+        args->result = args->n;
+        return;
+    }
+    FibArgs left = {args->n - 1, 0};
+    FibArgs right = {args->n - 2, 0};
+    TaskGroup group;
+    Task task;
+    task_group_init(&group);
+    task_spawn(&group, &task, fib_task, &left);
+    fib_task(&right);
+    task_sync(&group);
+    args->result = left.result + right.result;
+}
+
+static void test_fib(){
+    Scheduler *scheduler = scheduler_create(4);
+    assert(scheduler != NULL);
+    FibArgs args = {25, 0};
+    fib_task(&args);
+    assert(args.result == 75025);
+    scheduler_destroy(scheduler);
+}
+
+static void mark_range(int begin, int end, void *arg){
+    int *hits = arg;
+    for (int i = begin; i < end; i++){
+        __atomic_fetch_add(&hits[i], 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void test_parallel_for(){
+    Scheduler *scheduler = scheduler_create(0);
+    assert(scheduler != NULL);
+    int count = 100003;
+    int *hits = calloc(count, sizeof(int));
+    assert(hits != NULL);
+
+    parallel_for(0, count, 1000, mark_range, hits);
+    for (int i = 0; i < count; i++){
+        assert(hits[i] == 1);
+    }
+    parallel_for(5, 5, 1000, mark_range, hits); // empty range is a no-op
+    assert(hits[5] == 1);
+
+    free(hits);
+    scheduler_destroy(scheduler);
+}
+
+static void test_outside_pool(){
+    // with no scheduler, spawned tasks run inline
+    FibArgs args = {15, 0};
+    fib_task(&args);
+    assert(args.result == 610);
+}
+
+int main(){
+    test_deque_order();
+    printf("Deque order tests passed.\n");
+    test_concurrent_steal();
+    printf("Concurrent steal test passed.\n");
+    test_outside_pool();
+    test_fib();
+    test_parallel_for();
+    printf("Scheduler tests passed.\n");
+    return 0;
+}
@@ -0,0 +1,225 @@
+#define _GNU_SOURCE
+#include "scheduler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define cpu_relax() __builtin_ia32_pause()
+#else
+#define cpu_relax() __asm__ __volatile__("" ::: "memory")
+#endif
+
+// the worker running on this thread, NULL for threads outside the pool
+static _Thread_local Worker *current_worker = NULL;
+
+static void run_task(Task *task){
+    TaskGroup *group = task->group; // task may be gone once pending drops
+    task->function(task->arg);
+    __atomic_fetch_sub(&group->pending, 1, __ATOMIC_RELEASE);
+}
+
+static Task* steal_task(Worker *self){
+    int count = self->scheduler->worker_count;
+    if (count < 2){
+        return NULL;
+    }
+
+    uint64_t x = self->random_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    self->random_state = x;
+
+    // start at a random victim and try each other worker once
+    int start = x % count;
+    for (int i = 0; i < count; i++){
+        int victim = (start + i) % count;
+        if (victim == self->index){
+            continue;
+        }
+        Task *task = ws_steal(&self->scheduler->workers[victim].deque);
+        if (task != NULL){
+            return task;
+        }
+    }
+    return NULL;
+}
+
+static Task* find_task(Worker *self){
+    Task *task = ws_take(&self->deque);
+    return task != NULL ? task : steal_task(self);
+}
+
+// spins, then yields, then sleeps for longer and longer while idle
+static void idle_backoff(int idle_rounds){
+    if (idle_rounds < 64){
+        cpu_relax();
+    }else if (idle_rounds < 128){
+        sched_yield();
+    }else{
+        int shift = idle_rounds - 128 < 10 ? idle_rounds - 128 : 10;
+        struct timespec pause = {0, 1000L << shift}; // 1 us up to ~1 ms
+        nanosleep(&pause, NULL);
+    }
+}
+
+static void pin_to_cpu(int cpu){
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+static void* worker_main(void *arg){
+    Worker *self = arg;
+    current_worker = self;
+    pin_to_cpu(self->index % sysconf(_SC_NPROCESSORS_ONLN));
+
+    int idle_rounds = 0;
+    while (!__atomic_load_n(&self->scheduler->stopping, __ATOMIC_ACQUIRE)){
+        Task *task = find_task(self);
+        if (task != NULL){
+            run_task(task);
+            idle_rounds = 0;
+        }else{
+            idle_backoff(idle_rounds++);
+        }
+    }
+    current_worker = NULL;
+    return NULL;
+}
+
+// Stops the workers and frees everything. Only the first deque_count
+// deques were set up and only workers 1 .. thread_count - 1 were
+// started, so a half-built scheduler can be undone too.
+static void scheduler_release(Scheduler *scheduler, int deque_count, int thread_count){
+    __atomic_store_n(&scheduler->stopping, true, __ATOMIC_RELEASE);
+    for (int i = 1; i < thread_count; i++){
+        pthread_join(scheduler->workers[i].thread, NULL);
+    }
+    for (int i = 0; i < deque_count; i++){
+        ws_deque_destroy(&scheduler->workers[i].deque);
+    }
+    current_worker = NULL;
+    free(scheduler->workers);
+    free(scheduler);
+}
+
+// returns NULL if out of memory or a worker thread can't be started
+Scheduler* scheduler_create(int worker_count){
+    if (worker_count <= 0){
+        worker_count = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+
+    Scheduler *scheduler = malloc(sizeof(Scheduler));
+    if (scheduler == NULL){
+        return NULL;
+    }
+    scheduler->workers = aligned_alloc(WS_CACHE_LINE, sizeof(Worker) * worker_count);
+    if (scheduler->workers == NULL){
+        free(scheduler);
+        return NULL;
+    }
+    scheduler->worker_count = worker_count;
+    scheduler->stopping = false;
+
+    for (int i = 0; i < worker_count; i++){
+        Worker *worker = &scheduler->workers[i];
+        if (!ws_deque_init(&worker->deque, 256)){
+            scheduler_release(scheduler, i, 0);
+            return NULL;
+        }
+        worker->scheduler = scheduler;
+        worker->index = i;
+        worker->random_state = 0x9E3779B97F4A7C15ULL * (i + 1);
+    }
+
+    current_worker = &scheduler->workers[0];
+    for (int i = 1; i < worker_count; i++){
+        if (pthread_create(&scheduler->workers[i].thread, NULL, worker_main, &scheduler->workers[i]) != 0){
+            scheduler_release(scheduler, worker_count, i);
+            return NULL;
+        }
+    }
+    return scheduler;
+}
+
+// call from the creating thread once all its task groups are synced
+void scheduler_destroy(Scheduler *scheduler){
+    scheduler_release(scheduler, scheduler->worker_count, scheduler->worker_count);
+}
+
+int scheduler_worker_count(Scheduler *scheduler){
+    return scheduler->worker_count;
+}
+
+void task_group_init(TaskGroup *group){
+    group->pending = 0;
+}
+
+void task_spawn(TaskGroup *group, Task *task, TaskFunction function, void *arg){
+    task->function = function;
+    task->arg = arg;
+    task->group = group;
+    __atomic_fetch_add(&group->pending, 1, __ATOMIC_RELAXED);
+
+    if (current_worker == NULL || !ws_push(&current_worker->deque, task)){
+        run_task(task);
+    }
+}
+
+void task_sync(TaskGroup *group){
+    Worker *self = current_worker;
+    int idle_rounds = 0;
+    while (__atomic_load_n(&group->pending, __ATOMIC_ACQUIRE) > 0){
+        Task *task = self != NULL ? find_task(self) : NULL;
+        if (task != NULL){
+            run_task(task);
+            idle_rounds = 0;
+        }else{
+            // a thief is running our task; keep the wait short
+            idle_backoff(idle_rounds < 127 ? idle_rounds++ : 127);
+        }
+    }
+}
+
+typedef struct ForRange{
+    int begin;
+    int end;
+    int grain;
+    RangeFunction body;
+    void *arg;
+}ForRange;
+
+// splits in half, leaving the right half for thieves, until a chunk is
+// no larger than grain
+static void for_range_task(void *arg){
+    ForRange *range = arg;
+    if (range->end - range->begin <= range->grain){
+        range->body(range->begin, range->end, range->arg);
+        return;
+    }
+
+    int middle = range->begin + (range->end - range->begin) / 2;
+    ForRange right = {middle, range->end, range->grain, range->body, range->arg};
+    ForRange left = {range->begin, middle, range->grain, range->body, range->arg};
+
+    TaskGroup group;
+    Task task;
+    task_group_init(&group);
+    task_spawn(&group, &task, for_range_task, &right);
+    for_range_task(&left);
+    task_sync(&group);
+}
+
+void parallel_for(int begin, int end, int grain, RangeFunction body, void *arg){
+    if (begin >= end){
+        return;
+    }
+    ForRange range = {begin, end, grain > 0 ? grain : 1, body, arg};
+    for_range_task(&range);
+}
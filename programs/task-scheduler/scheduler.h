@@ -0,0 +1,63 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "ws_deque.h"
+
+/* Fork-join task scheduler on top of the work-stealing deque. Each worker
+thread owns a WSDeque and is pinned to a core; idle workers steal from a
+random victim. The thread that calls scheduler_create becomes worker 0 and
+does its share of the work whenever it waits in task_sync.
+
+Tasks live in memory owned by the spawner (usually its stack), so
+spawning allocates nothing. The spawner must task_sync the group before
+that memory goes away. */
+
+typedef void (*TaskFunction)(void *arg);
+typedef void (*RangeFunction)(int begin, int end, void *arg);
+
+typedef struct TaskGroup{
+    int pending; // spawned tasks that have not finished yet
+}TaskGroup;
+
+typedef struct Task{
+    TaskFunction function;
+    void *arg;
+    TaskGroup *group;
+}Task;
+
+typedef struct Worker{
+    WSDeque deque;
+    struct Scheduler *scheduler;
+    int index;
+    uint64_t random_state;
+    pthread_t thread;
+}Worker;
+
+typedef struct Scheduler{
+    Worker *workers;
+    int worker_count;
+    bool stopping;
+}Scheduler;
+
+//Prototypes
+// worker_count <= 0 uses one worker per online CPU. Returns NULL if out of
+// memory or a worker thread can't be started.
+Scheduler* scheduler_create(int worker_count);
+void scheduler_destroy(Scheduler *scheduler);
+int scheduler_worker_count(Scheduler *scheduler);
+
+void task_group_init(TaskGroup *group);
+// Queues function(arg) on the calling worker. Called from a thread that is
+// not a worker, it just runs the task.
+void task_spawn(TaskGroup *group, Task *task, TaskFunction function, void *arg);
+// Runs and steals tasks until every task spawned into group has finished.
+void task_sync(TaskGroup *group);
+// Calls body on chunks of [begin, end) no larger than grain, in parallel.
+void parallel_for(int begin, int end, int grain, RangeFunction body, void *arg);
+
+
+
+#endif
@@ -0,0 +1,149 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "scheduler.h"
+#include "../arrays/array.h"
+#include "../arrays/array.c"
+
+/* Scheduler benchmarks: a fine-grained fib task tree (scheduling overhead
+per task) and a coarse parallel_for sum over a JArray (scaling). Each is
+run with 1, 2, 4, ... workers up to the number of online CPUs.
+
+    gcc -O2 -pthread scheduler_bench.c scheduler.c ws_deque.c -o scheduler_bench
+    ./scheduler_bench */
+
+#define FIB_N 32
+#define FIB_CUTOFF 12 // below this the task tree switches to serial fib
+#define SUM_ITEMS 50000000
+#define SUM_GRAIN 65536
+#define SUM_REPEATS 5
+
+static double elapsed(struct timespec start, struct timespec end){
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// noinline so the compiler cannot fold the serial baseline
+__attribute__((noinline)) static long fib_serial(int n){
+    return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+typedef struct FibArgs{
+    int n;
+    long result;
+}FibArgs;
+
+static void fib_task(void *arg){
+    FibArgs *args = arg;
+    if (args->n < FIB_CUTOFF){
+        args->result = fib_serial(args->n);
+        return;
+    }
+    FibArgs left = {args->n - 1, 0};
+    FibArgs right = {args->n - 2, 0};
+    TaskGroup group;
+    Task task;
+    task_group_init(&group);
+    task_spawn(&group, &task, fib_task, &left);
+    fib_task(&right);
+    task_sync(&group);
+    args->result = left.result + right.result;
+}
+
+typedef struct SumArgs{
+    JArray *array;
+    long long *partials; // one slot per chunk, no shared counter
+}SumArgs;
+
+// the loop runs over chunk numbers so each chunk owns one partial
+static void sum_chunks(int first_chunk, int end_chunk, void *arg){
+    SumArgs *args = arg;
+    for (int chunk = first_chunk; chunk < end_chunk; chunk++){
+        int begin = chunk * SUM_GRAIN;
+        int end = begin + SUM_GRAIN < args->array->size ? begin + SUM_GRAIN : args->array->size;
+        long long sum = 0;
+        for (int i = begin; i < end; i++){
+            sum += args->array->data[i];
+        }
+        args->partials[chunk] = sum;
+    }
+}
+
+int main(){
+    int cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    long expected_fib = fib_serial(FIB_N);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double serial_fib = elapsed(start, end);
+
+    JArray *array = jarray_new(SUM_ITEMS);
+    for (int i = 0; i < SUM_ITEMS; i++){
+        jarray_push(array, i % 1000);
+    }
+    int chunks = (SUM_ITEMS + SUM_GRAIN - 1) / SUM_GRAIN;
+    long long *partials = malloc(sizeof(long long) * chunks);
+    check_address(partials);
+    SumArgs sum_args = {array, partials};
+
+    long long expected_sum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int repeat = 0; repeat < SUM_REPEATS; repeat++){
+        expected_sum = 0;
+        for (int i = 0; i < SUM_ITEMS; i++){
+            expected_sum += array->data[i];
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double serial_sum = elapsed(start, end) / SUM_REPEATS;
+
+    printf("%d online CPUs\n", cpus);
+    printf("%-8s %14s %10s %14s %10s\n", "workers", "fib(32) ms", "speedup", "sum 50M ms", "speedup");
+    printf("%-8s %14.1f %10s %14.2f %10s\n", "serial", serial_fib * 1e3, "1.00", serial_sum * 1e3, "1.00");
+
+    for (int workers = 1; ; workers *= 2){
+        if (workers > cpus){
+            workers = cpus;
+        }
+        Scheduler *scheduler = scheduler_create(workers);
+        if (scheduler == NULL){
+            fprintf(stderr, "Unable to start %d workers\n", workers);
+            return EXIT_FAILURE;
+        }
+
+        FibArgs fib_args = {FIB_N, 0};
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        fib_task(&fib_args);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double fib_time = elapsed(start, end);
+
+        long long sum = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int repeat = 0; repeat < SUM_REPEATS; repeat++){
+            parallel_for(0, chunks, 1, sum_chunks, &sum_args);
+            sum = 0;
+            for (int i = 0; i < chunks; i++){
+                sum += partials[i];
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double sum_time = elapsed(start, end) / SUM_REPEATS;
+
+        scheduler_destroy(scheduler);
+        if (fib_args.result != expected_fib || sum != expected_sum){
+            fprintf(stderr, "Wrong result with %d workers\n", workers);
+            return EXIT_FAILURE;
+        }
+        printf("%-8d %14.1f %10.2f %14.2f %10.2f\n", workers, fib_time * 1e3, serial_fib / fib_time,
+               sum_time * 1e3, serial_sum / sum_time);
+        if (workers == cpus){
+            break;
+        }
+    }
+
+    free(partials);
+    jarray_destroy(array);
+    return 0;
+}
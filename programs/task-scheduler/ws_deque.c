@@ -0,0 +1,112 @@
+#include "ws_deque.h"
+#include <stdlib.h>
+#include <stdbool.h>
+
+static WSBuffer* ws_buffer_new(long capacity){
+    WSBuffer *buffer = malloc(sizeof(WSBuffer) + sizeof(void *) * capacity);
+    if (buffer == NULL){
+        return NULL;
+    }
+    buffer->capacity = capacity;
+    buffer->previous = NULL;
+    return buffer;
+}
+
+static void* ws_buffer_get(WSBuffer *buffer, long index){
+    return __atomic_load_n(&buffer->items[index & (buffer->capacity - 1)], __ATOMIC_RELAXED);
+}
+
+static void ws_buffer_put(WSBuffer *buffer, long index, void *item){
+    __atomic_store_n(&buffer->items[index & (buffer->capacity - 1)], item, __ATOMIC_RELAXED);
+}
+
+// capacity is rounded up to a power of two
+bool ws_deque_init(WSDeque *deque, long capacity){
+    long true_capacity = 16;
+    while (true_capacity < capacity){
+        true_capacity *= 2;
+    }
+    deque->buffer = ws_buffer_new(true_capacity);
+    deque->top = 0;
+    deque->bottom = 0;
+    return deque->buffer != NULL;
+}
+
+void ws_deque_destroy(WSDeque *deque){
+    WSBuffer *buffer = deque->buffer;
+    while (buffer != NULL){
+        WSBuffer *previous = buffer->previous;
+        free(buffer);
+        buffer = previous;
+    }
+}
+
+// doubles the buffer, copying the live range [top, bottom)
+static WSBuffer* ws_grow(WSDeque *deque, WSBuffer *old, long top, long bottom){
+    WSBuffer *buffer = ws_buffer_new(old->capacity * 2);
+    if (buffer == NULL){
+        return NULL;
+    }
+    for (long i = top; i < bottom; i++){
+        ws_buffer_put(buffer, i, ws_buffer_get(old, i));
+    }
+    buffer->previous = old;
+    __atomic_store_n(&deque->buffer, buffer, __ATOMIC_RELEASE);
+    return buffer;
+}
+
+bool ws_push(WSDeque *deque, void *item){
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    WSBuffer *buffer = __atomic_load_n(&deque->buffer, __ATOMIC_RELAXED);
+    if (bottom - top > buffer->capacity - 1){
+        buffer = ws_grow(deque, buffer, top, bottom);
+        if (buffer == NULL){
+            return false;
+        }
+    }
+    ws_buffer_put(buffer, bottom, item);
+    // a release store rather than the paper's release fence: same effect
+    // here, and visible to ThreadSanitizer
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+void* ws_take(WSDeque *deque){
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    WSBuffer *buffer = __atomic_load_n(&deque->buffer, __ATOMIC_RELAXED);
+    __atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+    void *item = NULL;
+    if (top <= bottom){
+        item = ws_buffer_get(buffer, bottom);
+        if (top == bottom){
+            // last item, race the thieves for it
+            if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)){
+                item = NULL;
+            }
+            __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        }
+    }else{
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+    }
+    return item;
+}
+
+void* ws_steal(WSDeque *deque){
+    long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+    if (top >= bottom){
+        return NULL;
+    }
+
+    WSBuffer *buffer = __atomic_load_n(&deque->buffer, __ATOMIC_ACQUIRE);
+    void *item = ws_buffer_get(buffer, top);
+    if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)){
+        return NULL;
+    }
+    return item;
+}
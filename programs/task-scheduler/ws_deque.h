@@ -0,0 +1,38 @@
+#ifndef WS_DEQUE_H
+#define WS_DEQUE_H
+
+#include <stdbool.h>
+
+/* Chase-Lev work-stealing deque of pointers. The owning worker pushes and
+takes at the bottom (LIFO, no CAS except on the last item), other workers
+steal from the top (FIFO, one CAS). The buffer grows when full; old
+buffers are kept until the deque is destroyed because a thief may still
+be reading from them. Memory orderings follow Le, Pop, Cohen and Zappa
+Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models". */
+
+#define WS_CACHE_LINE 64
+
+typedef struct WSBuffer{
+    long capacity;
+    struct WSBuffer *previous; // older, smaller buffer kept for late thieves
+    void *items[];
+}WSBuffer;
+
+typedef struct WSDeque{
+    _Alignas(WS_CACHE_LINE) long top;    // thieves
+    _Alignas(WS_CACHE_LINE) long bottom; // owner
+    WSBuffer *buffer;
+}WSDeque;
+
+//Prototypes
+bool ws_deque_init(WSDeque *deque, long capacity);
+void ws_deque_destroy(WSDeque *deque);
+// owner only
+bool ws_push(WSDeque *deque, void *item);
+void* ws_take(WSDeque *deque);
+// any thread; returns NULL if empty or if it lost a race (try another victim)
+void* ws_steal(WSDeque *deque);
+
+
+
+#endif